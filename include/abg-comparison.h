@@ -783,6 +783,15 @@ class diff_context
 				const type_or_decl_base_sptr second,
 				const diff_sptr canonical_diff);
 
+  friend void*
+  allocate_diff_node_memory(const diff_context_sptr& ctxt, size_t size);
+
+  friend void
+  deallocate_diff_node_memory(const diff_context_sptr& ctxt,
+			      void* p, size_t size);
+
+  friend class diff;
+
 public:
   diff_context();
 
@@ -2338,6 +2347,30 @@ compute_diff(const corpus_sptr,
 	     const corpus_sptr,
 	     diff_context_sptr);
 
+/// The kinds of ABI changes that can exist between two corpora.
+///
+/// This is what compute_corpus_change_kind() returns.
+enum corpus_change_kind
+{
+  /// The two corpora carry no ABI change that is to be reported.
+  NO_CORPUS_CHANGE_KIND = 0,
+
+  /// The two corpora carry ABI changes that are to be reported, but
+  /// none of them is known to be incompatible.  Those are changes to
+  /// functions or variables.
+  COMPATIBLE_CORPUS_CHANGE_KIND,
+
+  /// The two corpora carry at least one incompatible ABI change.
+  /// That is, the SONAME changed, or functions, variables or ELF
+  /// symbols got removed.
+  INCOMPATIBLE_CORPUS_CHANGE_KIND
+};
+
+corpus_change_kind
+compute_corpus_change_kind(const corpus_sptr f,
+			   const corpus_sptr s,
+			   diff_context_sptr ctxt = diff_context_sptr());
+
 /// This is a document class that aims to capture statistics about the
 /// changes carried by a @ref corpus_diff type.
 ///
@@ -2542,6 +2575,12 @@ void
 print_diff_tree(corpus_diff_sptr diff_tree,
 		std::ostream&);
 
+void
+report_as_json(const diff_sptr& diff_tree, std::ostream& out);
+
+void
+report_as_json(const corpus_diff_sptr& diff_tree, std::ostream& out);
+
 void
 categorize_redundancy(diff* diff_tree);
 
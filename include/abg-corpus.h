@@ -83,6 +83,9 @@ public:
   void
   add(const translation_unit_sptr);
 
+  const location_path_table_sptr&
+  get_location_path_table() const;
+
   const translation_units&
   get_translation_units() const;
 
@@ -108,13 +111,13 @@ public:
   set_needed(const vector<string>&);
 
   const string&
-  get_soname();
+  get_soname() const;
 
   void
   set_soname(const string&);
 
   const string&
-  get_architecture_name();
+  get_architecture_name() const;
 
   void
   set_architecture_name(const string&);
@@ -244,6 +247,9 @@ public:
   void
   maybe_drop_some_exported_decls();
 
+  size_t
+  prune_unreachable_types();
+
   exported_decls_builder_sptr
   get_exported_decls_builder() const;
 };// end class corpus.
@@ -31,12 +31,14 @@
 /// The implementations goes as far as calculating the shortest edit
 /// script (the set of insertions and deletions) for transforming a
 /// sequence into another.  The main entry point for that is the
-/// compute_diff() function.
+/// compute_diff() function.  Its compute_trimmed_diff() variant is
+/// faster on long sequences that are mostly equal.
 
 #ifndef __ABG_DIFF_UTILS_H__
 #define __ABG_DIFF_UTILS_H__
 
 #include <stdexcept>
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <ostream>
@@ -563,6 +565,148 @@ public:
   {return max_d() + abs((long long) a_size() - (long long) b_size());}
 }; // end class d_path_vec
 
+/// A vector of furthest D-path end-points which memory is owned by a
+/// @ref d_paths_workspace, rather than by the vector itself.
+///
+/// It is addressed like a @ref d_path_vec, but creating it doesn't
+/// allocate any memory.  The bounds of the indexes used to address it
+/// are only checked by assertions.
+class d_path_vec_view
+{
+  int*		base_;
+  unsigned	a_size_;
+  unsigned	b_size_;
+
+  /// Forbid default constructor.
+  d_path_vec_view();
+
+public:
+
+  /// Constructor of the d_path_vec_view.
+  ///
+  /// @param base the memory of the vector.  It must contain at least
+  /// buffer_size(size1, size2) zero-initialized elements.
+  ///
+  /// @param size1 the size of the first sequence we are interested
+  /// in.
+  ///
+  /// @param size2 the size of the second sequence we are interested
+  /// in.
+  d_path_vec_view(int* base, unsigned size1, unsigned size2)
+    : base_(base), a_size_(size1), b_size_(size2)
+  {}
+
+  /// The number of elements that the memory of a d_path_vec_view
+  /// must contain.  This is the same as the size of a @ref
+  /// d_path_vec for the same sequences.
+  ///
+  /// @param size1 the size of the first sequence we are interested
+  /// in.
+  ///
+  /// @param size2 the size of the second sequence we are interested
+  /// in.
+  static size_t
+  buffer_size(unsigned size1, unsigned size2)
+  {return 2 * (size1 + size2 + 1 + (size1 + size2)) + 1;}
+
+  int
+  operator[](int index) const
+  {
+    assert(index + (long long) offset() >= 0
+	   && index + offset() < buffer_size(a_size_, b_size_));
+    return base_[index + offset()];
+  }
+
+  int&
+  operator[](int index)
+  {
+    assert(index + (long long) offset() >= 0
+	   && index + offset() < buffer_size(a_size_, b_size_));
+    return base_[index + offset()];
+  }
+
+  unsigned
+  a_size() const
+  {return a_size_;}
+
+  unsigned
+  b_size() const
+  {return b_size_;}
+
+  unsigned
+  max_d() const
+  {return a_size_ + b_size_;}
+
+  unsigned
+  offset() const
+  {return max_d() + abs((long long) a_size() - (long long) b_size());}
+}; // end class d_path_vec_view
+
+/// The working memory of the computation of the shortest edit script
+/// of two sequences.
+///
+/// The computation of the middle snake of two sequences needs two
+/// vectors of furthest D-path end-points, and it is performed again
+/// on sub-sequences at each step of the recursion of compute_diff().
+/// A workspace lets all those steps use the same memory, which is
+/// allocated once, for the biggest pair of sequences considered.
+class d_paths_workspace
+{
+  vector<int> forward_d_paths_;
+  vector<int> reverse_d_paths_;
+
+  /// Get a zero-initialized view on a given buffer of the workspace.
+  ///
+  /// @param buf the buffer to consider.  It's enlarged if need be.
+  ///
+  /// @param size1 the size of the first sequence we are interested
+  /// in.
+  ///
+  /// @param size2 the size of the second sequence we are interested
+  /// in.
+  ///
+  /// @return the view on @p buf.
+  static d_path_vec_view
+  get_view(vector<int>& buf, unsigned size1, unsigned size2)
+  {
+    size_t size = d_path_vec_view::buffer_size(size1, size2);
+    if (buf.size() < size)
+      buf.resize(size);
+    std::fill(buf.begin(), buf.begin() + size, 0);
+    return d_path_vec_view(&buf[0], size1, size2);
+  }
+
+public:
+
+  /// Get the vector of the end-points of the furthest forward
+  /// D-paths, for a given pair of sequences.
+  ///
+  /// The vector is valid until the next invocation of this function.
+  ///
+  /// @param size1 the size of the first sequence we are interested
+  /// in.
+  ///
+  /// @param size2 the size of the second sequence we are interested
+  /// in.
+  d_path_vec_view
+  forward_d_paths(unsigned size1, unsigned size2)
+  {return get_view(forward_d_paths_, size1, size2);}
+
+  /// Get the vector of the end-points of the furthest reverse
+  /// D-paths, for a given pair of sequences.
+  ///
+  /// The vector is valid until the next invocation of this function.
+  ///
+  /// @param size1 the size of the first sequence we are interested
+  /// in.
+  ///
+  /// @param size2 the size of the second sequence we are interested
+  /// in.
+  d_path_vec_view
+  reverse_d_paths(unsigned size1, unsigned size2)
+  {return get_view(reverse_d_paths_, size1, size2);}
+}; // end class d_paths_workspace
+
 /// The abstration of an insertion of elements of a sequence B into a
 /// sequence A.  This is used to represent the edit script for
 /// transforming a sequence A into a sequence B.
@@ -796,6 +940,10 @@ struct deep_ptr_eq_functor
 /// used to compare the elements referred to by the iterators pased in
 /// argument to this function.
 ///
+/// @tparm DPathVector the type of the vector of furthest end points
+/// of d-paths.  That is either @ref d_path_vec or @ref
+/// d_path_vec_view.
+///
 /// @param k the number of the diagonal on which we want to find the
 /// end of the furthest reaching D-path.
 ///
@@ -826,14 +974,15 @@ struct deep_ptr_eq_functor
 /// found was inside the boundaries of the edit graph, false
 /// otherwise.
 template<typename RandomAccessOutputIterator,
-	 typename EqualityFunctor>
+	 typename EqualityFunctor,
+	 typename DPathVector>
 bool
 end_of_fr_d_path_in_k(int k, int d,
 		      RandomAccessOutputIterator a_begin,
 		      RandomAccessOutputIterator a_end,
 		      RandomAccessOutputIterator b_start,
 		      RandomAccessOutputIterator b_end,
-		      d_path_vec& v, snake& snak)
+		      DPathVector& v, snake& snak)
 {
   int x = -1, y = -1;
   point begin, intermediate, diag_start, end;
@@ -935,6 +1084,10 @@ end_of_fr_d_path_in_k(int k, int d,
 /// used to compare the elements referred to by the iterators pased in
 /// argument to this function.
 ///
+/// @tparm DPathVector the type of the vector of furthest end points
+/// of d-paths.  That is either @ref d_path_vec or @ref
+/// d_path_vec_view.
+///
 /// @param k the number of the diagonal on which we want to find the
 /// end of the furthest reaching reverse D-path.  Actually, we want to
 /// find the end of the furthest reaching reverse D-path on diagonal (k
@@ -967,14 +1120,15 @@ end_of_fr_d_path_in_k(int k, int d,
 /// found was inside the boundaries of the edit graph, false
 /// otherwise.
 template<typename RandomAccessOutputIterator,
-	 typename EqualityFunctor>
+	 typename EqualityFunctor,
+	 typename DPathVector>
 bool
 end_of_frr_d_path_in_k_plus_delta (int k, int d,
 				   RandomAccessOutputIterator a_begin,
 				   RandomAccessOutputIterator a_end,
 				   RandomAccessOutputIterator b_begin,
 				   RandomAccessOutputIterator b_end,
-				   d_path_vec& v, snake& snak)
+				   DPathVector& v, snake& snak)
 {
   int a_size = a_end - a_begin;
   int b_size = b_end - b_begin;
@@ -1109,6 +1263,10 @@ is_match_point(RandomAccessOutputIterator a_begin,
 /// used to compare the elements referred to by the iterators pased in
 /// argument to this function.
 ///
+/// @tparm DPathVector the type of the vectors of furthest end points
+/// of d-paths.  That is either @ref d_path_vec or @ref
+/// d_path_vec_view.
+///
 /// @param a_begin an iterator pointing to the begining of sequence A.
 ///
 /// @param a_end an iterator pointing to the end of sequence A.  Note
@@ -1119,18 +1277,27 @@ is_match_point(RandomAccessOutputIterator a_begin,
 /// @param b_end an iterator pointing to the end of sequence B.  Note
 /// that this points right /after/ the end of vector B
 ///
+/// @param forward_d_paths the vector of the end points of the furthest
+/// forward d-paths.  It must be zero-initialized.
+///
+/// @param reverse_d_paths the vector of the end points of the furthest
+/// reverse d-paths.  It must be zero-initialized.
+///
 /// @param snak out parameter.  This is the snake current when the two
 /// paths overlapped.  This is set iff the function returns true;
 /// otherwise, this is not touched.
 ///
 /// @return true is the snake was found, false otherwise.
 template<typename RandomAccessOutputIterator,
-	 typename EqualityFunctor>
+	 typename EqualityFunctor,
+	 typename DPathVector>
 bool
 compute_middle_snake(RandomAccessOutputIterator a_begin,
 		     RandomAccessOutputIterator a_end,
 		     RandomAccessOutputIterator b_begin,
 		     RandomAccessOutputIterator b_end,
+		     DPathVector& forward_d_paths,
+		     DPathVector& reverse_d_paths,
 		     snake& snak, int& ses_len)
 {
   int a_size = a_end - a_begin;
@@ -1138,8 +1305,6 @@ compute_middle_snake(RandomAccessOutputIterator a_begin,
   int b_size = b_end - b_begin;
   int M = b_size;
   int delta = N - M;
-  d_path_vec forward_d_paths(a_size, b_size);
-  d_path_vec reverse_d_paths(a_size, b_size);
   // These points below are the top leftmost point and bottom
   // right-most points of the edit graph.
   point first_point(-1, -1), last_point(a_size -1, b_size -1), point_zero(0, 0);
@@ -1238,6 +1403,106 @@ compute_middle_snake(RandomAccessOutputIterator a_begin,
   return false;
 }
 
+/// Returns the middle snake of two sequences A and B, as well as the
+/// length of their shortest editing script.
+///
+/// The vectors of the end points of the furthest d-paths used by the
+/// algorithm are allocated by this function.
+///
+/// @tparm RandomAccessOutputIterator the type of iterators passed to
+/// this function.  It must be a random access output iterator kind.
+///
+/// @tparm EqualityFunctor the functor used to compare the elements
+/// of the two sequences.
+///
+/// @param a_begin an iterator pointing to the begining of sequence A.
+///
+/// @param a_end an iterator pointing to the end of sequence A.
+///
+/// @param b_begin an iterator pointing to the begining of sequence B.
+///
+/// @param b_end an iterator pointing to the end of sequence B.
+///
+/// @param snak out parameter.  This is the snake current when the two
+/// paths overlapped.  This is set iff the function returns true.
+///
+/// @param ses_len out parameter.  The length of the shortest edit
+/// script.  This is set iff the function returns true.
+///
+/// @return true is the snake was found, false otherwise.
+template<typename RandomAccessOutputIterator,
+	 typename EqualityFunctor>
+bool
+compute_middle_snake(RandomAccessOutputIterator a_begin,
+		     RandomAccessOutputIterator a_end,
+		     RandomAccessOutputIterator b_begin,
+		     RandomAccessOutputIterator b_end,
+		     snake& snak, int& ses_len)
+{
+  int a_size = a_end - a_begin, b_size = b_end - b_begin;
+  d_path_vec forward_d_paths(a_size, b_size);
+  d_path_vec reverse_d_paths(a_size, b_size);
+  return compute_middle_snake<RandomAccessOutputIterator,
+			      EqualityFunctor>(a_begin, a_end,
+					       b_begin, b_end,
+					       forward_d_paths,
+					       reverse_d_paths,
+					       snak, ses_len);
+}
+
+/// Returns the middle snake of two sequences A and B, as well as the
+/// length of their shortest editing script.
+///
+/// The vectors of the end points of the furthest d-paths used by the
+/// algorithm are taken from a workspace, so this function doesn't
+/// allocate memory unless the workspace needs to grow.
+///
+/// @tparm RandomAccessOutputIterator the type of iterators passed to
+/// this function.  It must be a random access output iterator kind.
+///
+/// @tparm EqualityFunctor the functor used to compare the elements
+/// of the two sequences.
+///
+/// @param a_begin an iterator pointing to the begining of sequence A.
+///
+/// @param a_end an iterator pointing to the end of sequence A.
+///
+/// @param b_begin an iterator pointing to the begining of sequence B.
+///
+/// @param b_end an iterator pointing to the end of sequence B.
+///
+/// @param workspace the workspace to take the working memory from.
+///
+/// @param snak out parameter.  This is the snake current when the two
+/// paths overlapped.  This is set iff the function returns true.
+///
+/// @param ses_len out parameter.  The length of the shortest edit
+/// script.  This is set iff the function returns true.
+///
+/// @return true is the snake was found, false otherwise.
+template<typename RandomAccessOutputIterator,
+	 typename EqualityFunctor>
+bool
+compute_middle_snake(RandomAccessOutputIterator a_begin,
+		     RandomAccessOutputIterator a_end,
+		     RandomAccessOutputIterator b_begin,
+		     RandomAccessOutputIterator b_end,
+		     d_paths_workspace& workspace,
+		     snake& snak, int& ses_len)
+{
+  int a_size = a_end - a_begin, b_size = b_end - b_begin;
+  d_path_vec_view forward_d_paths =
+    workspace.forward_d_paths(a_size, b_size);
+  d_path_vec_view reverse_d_paths =
+    workspace.reverse_d_paths(a_size, b_size);
+  return compute_middle_snake<RandomAccessOutputIterator,
+			      EqualityFunctor>(a_begin, a_end,
+					       b_begin, b_end,
+					       forward_d_paths,
+					       reverse_d_paths,
+					       snak, ses_len);
+}
+
 bool
 compute_middle_snake(const char* str1, const char* str2,
 		     snake& s, int& ses_len);
@@ -1465,6 +1730,9 @@ snake_end_points(const snake& s, point&, point&);
 /// two redundant ways and ensures that both methods lead to the same
 /// result.
 ///
+/// @param workspace the workspace the working memory of the
+/// algorithm is taken from.
+///
 /// @return true upon successful completion, false otherwise.
 template<typename RandomAccessOutputIterator,
 	 typename EqualityFunctor>
@@ -1477,7 +1745,8 @@ compute_diff(RandomAccessOutputIterator a_base,
 	     RandomAccessOutputIterator b_end,
 	     vector<point>& lcs,
 	     edit_script& ses,
-	     int& ses_len)
+	     int& ses_len,
+	     d_paths_workspace& workspace)
 {
   int a_size = a_end - a_begin;
   int b_size = b_end - b_begin;
@@ -1517,7 +1786,7 @@ compute_diff(RandomAccessOutputIterator a_base,
     compute_middle_snake<RandomAccessOutputIterator,
 			 EqualityFunctor>(a_begin, a_end,
 					  b_begin, b_end,
-					  snak, d);
+					  workspace, snak, d);
   if (has_snake)
     {
       // So middle_{begin,end} are expressed wrt a_begin and b_begin.
@@ -1528,14 +1797,31 @@ compute_diff(RandomAccessOutputIterator a_base,
 
   if (has_snake)
     {
-      if ( snak.has_diagonal_edge())
-	for (int x = snak.diagonal_start().x(), y = snak.diagonal_start().y();
-	     x <= snak.end().x() && y <= snak.end().y();
-	     ++x, ++y)
-	  {
-	    point p(x, y);
-	    trace.push_back(p);
-	  }
+      if (snak.has_diagonal_edge())
+	{
+	  // A forward snake walks its diagonal from its diagonal
+	  // start to its end.  A reverse snake walks it backward,
+	  // from its diagonal start down to the point right after its
+	  // end.
+	  point diag_first, diag_last;
+	  if (snak.is_forward())
+	    {
+	      diag_first = snak.diagonal_start();
+	      diag_last = snak.end();
+	    }
+	  else
+	    {
+	      diag_first = snak.end() + 1;
+	      diag_last = snak.diagonal_start();
+	    }
+	  for (int x = diag_first.x(), y = diag_first.y();
+	       x <= diag_last.x() && y <= diag_last.y();
+	       ++x, ++y)
+	    {
+	      point p(x, y);
+	      trace.push_back(p);
+	    }
+	}
     }
   else
     {
@@ -1568,7 +1854,8 @@ compute_diff(RandomAccessOutputIterator a_base,
       compute_diff<RandomAccessOutputIterator,
 		   EqualityFunctor>(a_base, a_begin, a_base + px.x() + 1,
 				    b_base, b_begin, b_base + px.y() + 1,
-				    lcs, tmp_ses0, tmp_ses_len0);
+				    lcs, tmp_ses0, tmp_ses_len0,
+				    workspace);
 
       lcs.insert(lcs.end(), trace.begin(), trace.end());
 
@@ -1577,7 +1864,8 @@ compute_diff(RandomAccessOutputIterator a_base,
       compute_diff<RandomAccessOutputIterator,
 		   EqualityFunctor>(a_base, a_base + pu.x() + 1, a_end,
 				    b_base, b_base + pu.y() + 1, b_end,
-				    lcs, tmp_ses1, tmp_ses_len1);
+				    lcs, tmp_ses1, tmp_ses_len1,
+				    workspace);
       assert(tmp_ses0.length() + tmp_ses1.length() == d);
       assert(tmp_ses_len0 + tmp_ses_len1 == d);
       ses.append(tmp_ses0);
@@ -1585,15 +1873,27 @@ compute_diff(RandomAccessOutputIterator a_base,
     }
   else if (d == 1)
     {
-      if (snak.has_diagonal_edge())
+      // The two sequences differ by one insertion or one deletion, so
+      // all the elements of the shorter one are part of the lcs.
+      // Pair them with the elements of the longer one, skipping the
+      // element of the latter that is not in the former.
+      EqualityFunctor eq;
+      bool skipped = false;
+      for (RandomAccessOutputIterator i = a_begin, j = b_begin;
+	   i < a_end && j < b_end;
+	   ++i, ++j)
 	{
-	  for (int x = snak.diagonal_start().x(), y = snak.diagonal_start().y();
-	       x <= snak.end().x() && y <= snak.end().y();
-	       ++x, ++y)
+	  if (!skipped && !eq(*i, *j))
 	    {
-	      point p(x, y);
-	      trace.push_back(p);
+	      skipped = true;
+	      if (a_size > b_size)
+		++i;
+	      else
+		++j;
+	      if (i == a_end || j == b_end)
+		break;
 	    }
+	  lcs.push_back(point(i - a_base, j - b_base));
 	}
 
       if (snak.has_vertical_edge())
@@ -1619,16 +1919,90 @@ compute_diff(RandomAccessOutputIterator a_base,
     }
   else if (d == 0)
     {
-      // Obviously on the middle snake is part of the solution, as
-      // there is no edit script; iow, the two sequences are
-      // identical.
-      lcs.insert(lcs.end(), trace.begin(), trace.end());
+      // There is no edit script; iow, the two sequences are
+      // identical and all their elements are part of the lcs.
+      for (RandomAccessOutputIterator i = a_begin, j = b_begin;
+	   i < a_end;
+	   ++i, ++j)
+	lcs.push_back(point(i - a_base, j - b_base));
       ses_len = 0;
     }
 
   assert(ses_len == ses.length());
 }
 
+/// Compute the longest common subsequence of two (sub-regions of)
+/// sequences as well as the shortest edit script from transforming
+/// the first (sub-region of) sequence into the second (sub-region of)
+/// sequence.
+///
+/// A sequence is determined by a base, a beginning offset and an end
+/// offset.  The base always points to the container that contains the
+/// sequence to consider.  The beginning offset is an iterator that
+/// points the beginning of the sub-region of the sequence that we
+/// actually want to consider.  The end offset is an iterator that
+/// points to the end of the sub-region of the sequence that we
+/// actually want to consider.
+///
+/// This uses the LCS algorithm of the paper at section 4b.  The
+/// working memory of the algorithm is allocated once for the whole
+/// computation.
+///
+/// @tparm RandomAccessOutputIterator the type of iterators passed to
+/// this function.  It must be a random access output iterator kind.
+///
+/// @tparm EqualityFunctor this must be a class that declares a public
+/// call operator member returning a boolean and taking two arguments
+/// that must be of the same type as the one pointed to by the @ref
+/// RandomAccessOutputIterator template parameter. This functor is
+/// used to compare the elements referred to by the iterators pased in
+/// argument to this function.
+///
+/// @param a_base the iterator to the base of the first sequence.
+///
+/// @param a_start an iterator to the beginning of the sub-region
+/// of the first sequence to actually consider.
+///
+/// @param a_end an iterator to the end of the sub-region of the first
+/// sequence to consider.
+///
+///@param b_base an iterator to the base of the second sequence to
+///consider.
+///
+/// @param b_start an iterator to the beginning of the sub-region
+/// of the second sequence to actually consider.
+///
+/// @param b_end an iterator to the end of the sub-region of the
+/// second sequence to actually consider.
+///
+/// @param lcs the resulting lcs.  This is set iff the function
+/// returns true.
+///
+/// @param ses the resulting shortest editing script.
+///
+/// @param ses_len the length of the ses above.
+///
+/// @return true upon successful completion, false otherwise.
+template<typename RandomAccessOutputIterator,
+	 typename EqualityFunctor>
+void
+compute_diff(RandomAccessOutputIterator a_base,
+	     RandomAccessOutputIterator a_begin,
+	     RandomAccessOutputIterator a_end,
+	     RandomAccessOutputIterator b_base,
+	     RandomAccessOutputIterator b_begin,
+	     RandomAccessOutputIterator b_end,
+	     vector<point>& lcs,
+	     edit_script& ses,
+	     int& ses_len)
+{
+  d_paths_workspace workspace;
+  compute_diff<RandomAccessOutputIterator,
+	       EqualityFunctor>(a_base, a_begin, a_end,
+				b_base, b_begin, b_end,
+				lcs, ses, ses_len, workspace);
+}
+
 /// Compute the longest common subsequence of two (sub-regions of)
 /// sequences as well as the shortest edit script from transforming
 /// the first (sub-region of) sequence into the second (sub-region of)
@@ -1996,6 +2370,154 @@ compute_diff(RandomAccessOutputIterator a_begin,
 							       ses);
 }
 
+/// Compute the longest common subsequence of two sequences as well
+/// as the shortest edit script from transforming the first sequence
+/// into the second, after trimming their common prefix and suffix.
+///
+/// The elements of the common prefix and suffix of the two sequences
+/// are part of the longest common subsequence, so the algorithm of
+/// compute_diff() is only run on what lies between them.  When the
+/// sequences are long and mostly equal, this is much faster.
+///
+/// The resulting edit script is a shortest edit script, but when
+/// several of them exist -- e.g, when elements are repeated in the
+/// sequences -- it might not be the one compute_diff() would have
+/// chosen.  Also, consecutive insertions at the same point of the
+/// first sequence are grouped into one @ref insertion.
+///
+/// @tparm RandomAccessOutputIterator the type of iterators passed to
+/// this function.  It must be a random access output iterator kind.
+///
+/// @tparm EqualityFunctor this must be a class that declares a public
+/// call operator member returning a boolean and taking two arguments
+/// that must be of the same type as the one pointed to by the @ref
+/// RandomAccessOutputIterator template parameter. This functor is
+/// used to compare the elements referred to by the iterators pased in
+/// argument to this function.
+///
+/// @param a_begin an iterator to the beginning of the first sequence
+/// to consider.
+///
+/// @param a_end an iterator to the end of the first sequence to
+/// consider.
+///
+/// @param b_begin an iterator to the beginning of the second sequence
+/// to consider.
+///
+/// @param b_end an iterator to the end of the second sequence to
+/// consider.
+///
+/// @param lcs the resulting lcs.
+///
+/// @param ses the resulting shortest editing script.
+template<typename RandomAccessOutputIterator,
+	 typename EqualityFunctor>
+void
+compute_trimmed_diff(RandomAccessOutputIterator a_begin,
+		     RandomAccessOutputIterator a_end,
+		     RandomAccessOutputIterator b_begin,
+		     RandomAccessOutputIterator b_end,
+		     vector<point>& lcs,
+		     edit_script& ses)
+{
+  RandomAccessOutputIterator a_base = a_begin, b_base = b_begin;
+  EqualityFunctor eq;
+
+  for (; a_begin < a_end && b_begin < b_end && eq(*a_begin, *b_begin);
+       ++a_begin, ++b_begin)
+    lcs.push_back(point(a_begin - a_base, b_begin - b_base));
+
+  int suffix_len = 0;
+  for (; a_begin < a_end && b_begin < b_end && eq(a_end[-1], b_end[-1]);
+       --a_end, --b_end)
+    ++suffix_len;
+
+  int ses_len = 0;
+  d_paths_workspace workspace;
+  compute_diff<RandomAccessOutputIterator,
+	       EqualityFunctor>(a_base, a_begin, a_end,
+				b_base, b_begin, b_end,
+				lcs, ses, ses_len, workspace);
+
+  for (int i = 0; i < suffix_len; ++i)
+    lcs.push_back(point(a_end - a_base + i, b_end - b_base + i));
+}
+
+/// Compute the shortest edit script from transforming a sequence
+/// into another, after trimming their common prefix and suffix.
+///
+/// See the overload of this function that also computes the longest
+/// common subsequence of the two sequences.
+///
+/// @tparm RandomAccessOutputIterator the type of iterators passed to
+/// this function.  It must be a random access output iterator kind.
+///
+/// @tparm EqualityFunctor the functor used to compare the elements
+/// of the two sequences.
+///
+/// @param a_begin an iterator to the beginning of the first sequence
+/// to consider.
+///
+/// @param a_end an iterator to the end of the first sequence to
+/// consider.
+///
+/// @param b_begin an iterator to the beginning of the second sequence
+/// to consider.
+///
+/// @param b_end an iterator to the end of the second sequence to
+/// consider.
+///
+/// @param ses the resulting shortest editing script.
+template<typename RandomAccessOutputIterator,
+	 typename EqualityFunctor>
+void
+compute_trimmed_diff(RandomAccessOutputIterator a_begin,
+		     RandomAccessOutputIterator a_end,
+		     RandomAccessOutputIterator b_begin,
+		     RandomAccessOutputIterator b_end,
+		     edit_script& ses)
+{
+  vector<point> lcs;
+  compute_trimmed_diff<RandomAccessOutputIterator,
+		       EqualityFunctor>(a_begin, a_end, b_begin, b_end,
+					lcs, ses);
+}
+
+/// Compute the shortest edit script from transforming a sequence
+/// into another, after trimming their common prefix and suffix.
+///
+/// The elements of the sequences are compared using their "=="
+/// operator.
+///
+/// @tparm RandomAccessOutputIterator the type of iterators passed to
+/// this function.  It must be a random access output iterator kind.
+///
+/// @param a_begin an iterator to the beginning of the first sequence
+/// to consider.
+///
+/// @param a_end an iterator to the end of the first sequence to
+/// consider.
+///
+/// @param b_begin an iterator to the beginning of the second sequence
+/// to consider.
+///
+/// @param b_end an iterator to the end of the second sequence to
+/// consider.
+///
+/// @param ses the resulting shortest editing script.
+template<typename RandomAccessOutputIterator>
+void
+compute_trimmed_diff(RandomAccessOutputIterator a_begin,
+		     RandomAccessOutputIterator a_end,
+		     RandomAccessOutputIterator b_begin,
+		     RandomAccessOutputIterator b_end,
+		     edit_script& ses)
+{
+  compute_trimmed_diff<RandomAccessOutputIterator,
+		       default_eq_functor>(a_begin, a_end, b_begin, b_end,
+					   ses);
+}
+
 void
 compute_lcs(const char* str1, const char* str2, int &ses_len, string& lcs);
 
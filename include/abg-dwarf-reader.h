@@ -80,6 +80,19 @@ create_read_context(const std::string&	elf_path,
 		    char**		debug_info_root_path,
 		    bool		read_all_types = false);
 
+void
+set_bounded_memory(read_context& ctxt, bool f);
+
+void
+set_deduplicate_types(read_context& ctxt, bool f);
+
+bool
+build_debug_info_index(const string&	debug_info_root_path,
+		       size_t&		num_files);
+
+status
+load_elf_symbols(read_context& ctxt);
+
 status
 read_corpus_from_elf(read_context&	ctxt,
 		     corpus_sptr&	resulting_corp);
@@ -89,6 +102,13 @@ read_corpus_from_elf(const std::string& elf_path,
 		     bool		load_all_types,
 		     corpus_sptr&	resulting_corp);
 
+status
+read_corpus_from_static_archive(const std::string&	archive_path,
+				char**			debug_info_root_path,
+				bool			load_all_types,
+				unsigned		num_threads,
+				corpus_sptr&		resulting_corp);
+
 bool
 lookup_symbol_from_elf(const string&		elf_path,
 		       const string&		symbol_name,
@@ -131,10 +131,45 @@ public:
   friend class location_manager;
 }; // end class location
 
+class location_path_table;
+
+/// Convenience typedef for a shared pointer to @ref
+/// location_path_table.
+typedef shared_ptr<location_path_table> location_path_table_sptr;
+
+/// @brief A table of interned file paths.
+///
+/// Each distinct file path is stored once in the table and is
+/// designated by a small integer.  A table can be shared by the
+/// location managers of all the translation units of a corpus, so
+/// that a path is stored once per corpus rather than once per
+/// location.
+class location_path_table
+{
+  struct priv;
+
+  /// Pimpl.
+  shared_ptr<priv> priv_;
+
+public:
+
+  location_path_table();
+
+  unsigned
+  intern_path(const std::string& path);
+
+  const std::string&
+  get_path(unsigned id) const;
+
+  size_t
+  get_number_of_paths() const;
+};
+
 /// @brief The entry point to manage locations.
 ///
 /// This type keeps a table of all the locations for tokens of a
-/// given translation unit.
+/// given translation unit.  The file paths of the locations are
+/// interned in a @ref location_path_table.
 class location_manager
 {
   struct priv;
@@ -152,6 +187,15 @@ public:
   void
   expand_location(const location location, std::string& path,
 		  unsigned& line, unsigned& column) const;
+
+  size_t
+  get_number_of_locations() const;
+
+  const location_path_table_sptr&
+  get_path_table() const;
+
+  void
+  set_path_table(const location_path_table_sptr& t);
 };
 
 struct ir_node_visitor;
@@ -475,6 +519,9 @@ class elf_symbol::version
   struct priv;
   shared_ptr<priv> priv_;
 
+  void
+  make_private_data_unique();
+
 public:
   version();
 
@@ -67,9 +67,17 @@ read_translation_unit_from_istream(std::istream* in);
 abigail::corpus_sptr
 read_corpus_from_file(const string& path);
 
+abigail::corpus_sptr
+read_corpus_from_file(const string& path, unsigned num_threads);
+
 int
 read_corpus_from_file(corpus_sptr& corp, const string& path);
 
+int
+read_corpus_from_file(corpus_sptr& corp,
+		      const string& path,
+		      unsigned num_threads);
+
 int
 read_corpus_from_file(corpus_sptr& corp);
 
@@ -79,6 +87,10 @@ read_corpus_from_native_xml(std::istream* in);
 corpus_sptr
 read_corpus_from_native_xml_file(const string& path);
 
+corpus_sptr
+read_corpus_from_native_xml_file(const string&			path,
+				 vector<type_base_sptr>&	types_to_canonicalize);
+
 }//end xml_reader
 }//end namespace abigail
 
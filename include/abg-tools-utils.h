@@ -24,6 +24,7 @@
 #include <string>
 #include <ostream>
 #include <istream>
+#include <streambuf>
 
 namespace abigail
 {
@@ -122,5 +123,65 @@ file_type guess_file_type(const string& file_path);
 std::tr1::shared_ptr<char>
 make_path_absolute(const char*p);
 
+void
+emit_json_string(const string& s, ostream& out);
+
+size_t
+get_peak_resident_set_size();
+
+string
+get_temporary_directory();
+
+/// An output stream buffer that compares the characters written to
+/// it against the content of a file, rather than storing them.
+///
+/// This makes it possible to check that serializing an ABI artifact
+/// yields the content of a given file, without storing the result of
+/// the serialization anywhere.  If the file is compressed with gzip,
+/// its decompressed content is considered.
+///
+/// Once everything is written, file_comparing_streambuf::finish()
+/// tells if the written characters and the content of the file are
+/// the same.  If they are not, the first line that differs can be
+/// retrieved.
+class file_comparing_streambuf : public std::streambuf
+{
+  struct priv;
+  typedef std::tr1::shared_ptr<priv> priv_sptr;
+
+  priv_sptr priv_;
+
+  // Forbid copy.
+  file_comparing_streambuf(const file_comparing_streambuf&);
+  file_comparing_streambuf& operator=(const file_comparing_streambuf&);
+
+protected:
+  virtual int_type
+  overflow(int_type c);
+
+  virtual std::streamsize
+  xsputn(const char* s, std::streamsize n);
+
+public:
+  file_comparing_streambuf(const string& path);
+
+  bool
+  is_open() const;
+
+  bool
+  finish();
+
+  size_t
+  get_line_of_first_difference() const;
+
+  const string&
+  get_expected_line() const;
+
+  const string&
+  get_actual_line() const;
+
+  ~file_comparing_streambuf();
+};// end class file_comparing_streambuf
+
 }// end namespace tools_utils
 }//end namespace abigail
@@ -0,0 +1,107 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (C) 2013-2015 Red Hat, Inc.
+//
+// This file is part of the GNU Application Binary Interface Generic
+// Analysis and Instrumentation Library (libabigail).  This library is
+// free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option) any
+// later version.
+
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this program; see the file COPYING-LGPLV3.  If
+// not, see <http://www.gnu.org/licenses/>.
+
+/// @file
+///
+/// This file declares an interface for a queue of tasks that are
+/// performed concurrently by a pool of worker threads.
+///
+/// Client code derives from @ref workers::task, schedules instances
+/// of the resulting type on a @ref workers::queue and then waits for
+/// the workers to complete them.  Note that the IR is not thread
+/// safe: concurrent tasks must not modify (or lazily compute data
+/// on) the same IR nodes.
+
+#ifndef __ABG_WORKERS_H__
+#define __ABG_WORKERS_H__
+
+#include <tr1/memory>
+#include <vector>
+
+namespace abigail
+{
+
+/// The namespace of the pool of worker threads.
+namespace workers
+{
+
+using std::tr1::shared_ptr;
+using std::vector;
+
+size_t
+get_number_of_threads();
+
+/// The abstraction of a unit of work performed by a worker thread.
+///
+/// Sub-types are expected to override the task::perform() virtual
+/// member function.
+class task
+{
+public:
+  /// Perform the work of the task.  This is invoked by a worker
+  /// thread.
+  virtual void
+  perform() = 0;
+
+  virtual ~task();
+};// end class task
+
+/// A convenience typedef for a shared pointer to @ref task.
+typedef shared_ptr<task> task_sptr;
+
+/// A queue of tasks performed by a pool of worker threads.
+///
+/// The worker threads are created by the constructor of the queue and
+/// are brought down by its destructor.  In between, tasks can be
+/// scheduled on the queue at will.
+class queue
+{
+  struct priv;
+  typedef shared_ptr<priv> priv_sptr;
+
+  priv_sptr priv_;
+
+  // Forbid copy.
+  queue(const queue&);
+  queue& operator=(const queue&);
+
+public:
+  queue();
+
+  queue(unsigned number_of_workers);
+
+  size_t
+  get_size() const;
+
+  bool
+  schedule_task(const task_sptr& t);
+
+  bool
+  schedule_tasks(const vector<task_sptr>& tasks);
+
+  void
+  wait_for_workers_to_complete();
+
+  ~queue();
+};// end class queue
+
+}// end namespace workers
+}// end namespace abigail
+#endif // __ABG_WORKERS_H__
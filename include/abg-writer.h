@@ -50,6 +50,11 @@ bool
 write_corpus_to_archive(const corpus& corp,
 			const string& path);
 
+bool
+write_corpus_to_archive(const corpus& corp,
+			const string& path,
+			unsigned num_threads);
+
 bool
 write_corpus_to_archive(const corpus& corp);
 
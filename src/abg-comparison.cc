@@ -27,12 +27,15 @@
 
 #include <ctype.h>
 #include <algorithm>
+#include <map>
+#include <new>
 #include <sstream>
 #include "abg-hash.h"
 #include "abg-comparison.h"
 #include "abg-comp-filter.h"
 #include "abg-sptr-utils.h"
 #include "abg-ini.h"
+#include "abg-tools-utils.h"
 
 namespace abigail
 {
@@ -111,6 +114,11 @@ namespace comparison
 /// canonical diff objects is the same as the life time of the @ref
 /// diff_context they relate to.
 ///
+/// Note also that the diff nodes, as well as their private data, are
+/// allocated from a memory pool owned by the @ref diff_context they
+/// relate to.  That memory is given back to the system when the
+/// context is destroyed.
+///
 /// @}
 ///
 
@@ -119,6 +127,7 @@ using std::vector;
 using std::tr1::dynamic_pointer_cast;
 using std::tr1::static_pointer_cast;
 using abigail::sptr_utils::noop_deleter;
+using abigail::tools_utils::emit_json_string;
 
 /// Convenience typedef for a pair of decls or types.
 typedef std::pair<const type_or_decl_base_sptr,
@@ -2306,14 +2315,392 @@ read_variable_suppression(const ini::config::section& section)
 
 // </variable_suppression stuff>
 
+/// A pool of memory out of which the diff nodes of a given @ref
+/// diff_context, as well as their private data, are allocated.
+///
+/// The memory is carved out of big chunks, so that building a diff
+/// tree doesn't cost a call to the system allocator per object.  The
+/// memory of an object that is destroyed is put on a free list, to be
+/// re-used by the next object of the same size.  The chunks are given
+/// back to the system in bulk, when the pool is destroyed.
+class diff_node_pool
+{
+  enum
+  {
+    ALIGNMENT = 2 * sizeof(void*),
+    CHUNK_SIZE = 128 * 1024,
+    // Objects that are bigger than this are allocated with operator
+    // new.
+    MAX_POOLED_SIZE = CHUNK_SIZE / 16
+  };
+
+  vector<char*>	chunks_;
+  char*		cur_;
+  size_t	available_;
+  // The free lists, indexed by the size of their objects divided by
+  // ALIGNMENT.  The first word of a free object points to the next
+  // object of the list.
+  vector<void*>	free_lists_;
+
+  // Forbid copy.
+  diff_node_pool(const diff_node_pool&);
+  diff_node_pool& operator=(const diff_node_pool&);
+
+  /// @return the size of the memory actually used for an object of a
+  /// given size.
+  static size_t
+  rounded_size(size_t size)
+  {return (size + ALIGNMENT - 1) & ~static_cast<size_t>(ALIGNMENT - 1);}
+
+public:
+
+  diff_node_pool()
+    : cur_(),
+      available_(),
+      free_lists_(MAX_POOLED_SIZE / ALIGNMENT + 1)
+  {}
+
+  /// Allocate memory for an object.
+  ///
+  /// @param size the size of the object.
+  ///
+  /// @return the memory allocated.
+  void*
+  allocate(size_t size)
+  {
+    size = rounded_size(size);
+    if (size > MAX_POOLED_SIZE)
+      return ::operator new(size);
+
+    void*& free_list = free_lists_[size / ALIGNMENT];
+    if (free_list)
+      {
+	void* result = free_list;
+	free_list = *static_cast<void**>(result);
+	return result;
+      }
+
+    if (available_ < size)
+      {
+	cur_ = static_cast<char*>(::operator new(CHUNK_SIZE));
+	chunks_.push_back(cur_);
+	available_ = CHUNK_SIZE;
+      }
+    void* result = cur_;
+    cur_ += size;
+    available_ -= size;
+    return result;
+  }
+
+  /// Give back the memory of an object allocated by
+  /// diff_node_pool::allocate().
+  ///
+  /// @param p the memory of the object.
+  ///
+  /// @param size the size of the object.
+  void
+  deallocate(void* p, size_t size)
+  {
+    size = rounded_size(size);
+    if (size > MAX_POOLED_SIZE)
+      {
+	::operator delete(p);
+	return;
+      }
+
+    void*& free_list = free_lists_[size / ALIGNMENT];
+    *static_cast<void**>(p) = free_list;
+    free_list = p;
+  }
+
+  ~diff_node_pool()
+  {
+    for (vector<char*>::iterator i = chunks_.begin(); i != chunks_.end(); ++i)
+      ::operator delete(*i);
+  }
+};// end class diff_node_pool
+
+void*
+allocate_diff_node_memory(const diff_context_sptr& ctxt, size_t size);
+
+void
+deallocate_diff_node_memory(const diff_context_sptr& ctxt,
+			    void* p, size_t size);
+
+/// Allocate memory for an object of a given type from the memory pool
+/// of a given @ref diff_context.
+///
+/// @tparam T the type of the object.
+///
+/// @param ctxt the context to allocate the memory from.
+///
+/// @return the memory allocated.
+template<typename T>
+void*
+diff_node_memory(const diff_context_sptr& ctxt)
+{return allocate_diff_node_memory(ctxt, sizeof(T));}
+
+/// A deleter for the shared pointers to the objects allocated by
+/// allocate_diff_node_memory().
+///
+/// It holds a reference to the context the object was allocated from,
+/// so that the memory pool of the context outlives the object.
+struct diff_node_deleter
+{
+  diff_context_sptr ctxt_;
+
+  diff_node_deleter(const diff_context_sptr& ctxt)
+    : ctxt_(ctxt)
+  {}
+
+  template<typename T>
+  void
+  operator()(T* p)
+  {
+    p->~T();
+    deallocate_diff_node_memory(ctxt_, p, sizeof(T));
+  }
+};// end struct diff_node_deleter
+
+/// Evaluate a set of suppression specifications on a diff node.
+///
+/// @param supprs the suppression specifications to evaluate.
+///
+/// @param d the diff node to evaluate the suppressions against.
+///
+/// @return true iff one of @p supprs suppresses @p d.
+static bool
+suppressions_suppress_diff(const suppressions_type& supprs, const diff* d)
+{
+  for (suppressions_type::const_iterator i = supprs.begin();
+       i != supprs.end();
+       ++i)
+    if ((*i)->suppresses_diff(d))
+      return true;
+  return false;
+}
+
+/// An index of the suppression specifications of a @ref
+/// diff_context.
+///
+/// The suppression specifications are sorted by the kind of diff node
+/// they apply to and, when they designate their subject by an exact
+/// name, by that name.  That way, evaluating the suppressions on a
+/// given diff node only involves the suppression specifications that
+/// can possibly apply to it; in particular, the regular expressions
+/// of the others are never run.
+///
+/// The verdict of the suppressions on a given diff node is cached,
+/// keyed by the canonical diff node of the node.  Diff nodes sharing
+/// the same canonical diff node have the same subjects, so the
+/// suppressions have the same verdict on them.
+class suppressions_index
+{
+  typedef unordered_map<string, suppressions_type> string_suppressions_map;
+
+  // The number of suppression specifications of the context that
+  // were indexed.  Suppressions can only be added to a context, so
+  // when this differs from the number of suppressions of the context,
+  // the index is stale.
+  size_t			num_indexed_;
+  string_suppressions_map	type_supprs_by_name_;
+  suppressions_type		other_type_supprs_;
+  string_suppressions_map	fn_supprs_by_name_;
+  suppressions_type		other_fn_supprs_;
+  string_suppressions_map	var_supprs_by_name_;
+  suppressions_type		other_var_supprs_;
+  // Suppression specifications which kind is unknown to the index.
+  // They are evaluated on all diff nodes.
+  suppressions_type		generic_supprs_;
+  pointer_map			verdicts_;
+
+  /// Evaluate the suppressions that designate their subjects by
+  /// exact name, on a diff node.
+  ///
+  /// @param m the map of the suppressions to consider, keyed by the
+  /// name of their subject.
+  ///
+  /// @param first_name the name of the first subject of @p d.
+  ///
+  /// @param second_name the name of the second subject of @p d.
+  ///
+  /// @param d the diff node to consider.
+  ///
+  /// @return true iff one of the suppressions named either @p
+  /// first_name or @p second_name suppresses @p d.
+  static bool
+  named_suppressions_suppress_diff(const string_suppressions_map& m,
+				   const string& first_name,
+				   const string& second_name,
+				   const diff* d)
+  {
+    string_suppressions_map::const_iterator i = m.find(first_name);
+    if (i != m.end() && suppressions_suppress_diff(i->second, d))
+      return true;
+    if (second_name != first_name)
+      {
+	i = m.find(second_name);
+	if (i != m.end() && suppressions_suppress_diff(i->second, d))
+	  return true;
+      }
+    return false;
+  }
+
+  /// Evaluate the indexed suppressions on a diff node, without
+  /// looking at the cache of verdicts.
+  ///
+  /// @param d the diff node to consider.
+  ///
+  /// @return true iff @p d is suppressed.
+  bool
+  evaluate(const diff* d) const
+  {
+    if (const type_diff_base* t = is_type_diff(d))
+      {
+	if (!type_supprs_by_name_.empty())
+	  {
+	    type_base_sptr ft = is_type(t->first_subject()),
+	      st = is_type(t->second_subject());
+	    if (named_suppressions_suppress_diff(type_supprs_by_name_,
+						 get_name(ft), get_name(st),
+						 d))
+	      return true;
+	  }
+	if (suppressions_suppress_diff(other_type_supprs_, d))
+	  return true;
+      }
+    else if (const function_decl_diff* f = is_function_decl_diff(d))
+      {
+	if (!fn_supprs_by_name_.empty()
+	    && named_suppressions_suppress_diff
+	    (fn_supprs_by_name_,
+	     f->first_function_decl()->get_qualified_name(),
+	     f->second_function_decl()->get_qualified_name(),
+	     d))
+	  return true;
+	if (suppressions_suppress_diff(other_fn_supprs_, d))
+	  return true;
+      }
+    else if (const var_diff* v = is_var_diff(d))
+      {
+	if (!var_supprs_by_name_.empty()
+	    && named_suppressions_suppress_diff
+	    (var_supprs_by_name_,
+	     v->first_var()->get_name(),
+	     v->second_var()->get_name(),
+	     d))
+	  return true;
+	if (suppressions_suppress_diff(other_var_supprs_, d))
+	  return true;
+      }
+    return suppressions_suppress_diff(generic_supprs_, d);
+  }
+
+public:
+  suppressions_index()
+    : num_indexed_()
+  {}
+
+  /// Test if the index is up to date with respect to a set of
+  /// suppression specifications.
+  ///
+  /// @param supprs the suppressions of the context of the index.
+  ///
+  /// @return true iff the index needs to be re-built.
+  bool
+  is_stale(const suppressions_type& supprs) const
+  {return num_indexed_ != supprs.size();}
+
+  /// (Re-)build the index from a set of suppression specifications.
+  ///
+  /// This drops the verdicts computed so far.
+  ///
+  /// @param supprs the suppression specifications to index.
+  void
+  build(const suppressions_type& supprs)
+  {
+    type_supprs_by_name_.clear();
+    other_type_supprs_.clear();
+    fn_supprs_by_name_.clear();
+    other_fn_supprs_.clear();
+    var_supprs_by_name_.clear();
+    other_var_supprs_.clear();
+    generic_supprs_.clear();
+    verdicts_.clear();
+
+    for (suppressions_type::const_iterator i = supprs.begin();
+	 i != supprs.end();
+	 ++i)
+      {
+	if (type_suppression_sptr s =
+	    dynamic_pointer_cast<type_suppression>(*i))
+	  {
+	    if (s->get_type_name().empty())
+	      other_type_supprs_.push_back(s);
+	    else
+	      type_supprs_by_name_[s->get_type_name()].push_back(s);
+	  }
+	else if (function_suppression_sptr s =
+		 dynamic_pointer_cast<function_suppression>(*i))
+	  {
+	    if (s->get_function_name().empty())
+	      other_fn_supprs_.push_back(s);
+	    else
+	      fn_supprs_by_name_[s->get_function_name()].push_back(s);
+	  }
+	else if (variable_suppression_sptr s =
+		 dynamic_pointer_cast<variable_suppression>(*i))
+	  {
+	    if (s->get_name().empty())
+	      other_var_supprs_.push_back(s);
+	    else
+	      var_supprs_by_name_[s->get_name()].push_back(s);
+	  }
+	else
+	  generic_supprs_.push_back(*i);
+      }
+    num_indexed_ = supprs.size();
+  }
+
+  /// Test if a diff node is suppressed by the indexed suppression
+  /// specifications.
+  ///
+  /// @param d the diff node to consider.
+  ///
+  /// @return true iff @p d is suppressed.
+  bool
+  suppresses_diff(const diff* d)
+  {
+    if (num_indexed_ == 0)
+      return false;
+
+    const diff* canonical = d->get_canonical_diff();
+    if (!canonical)
+      return evaluate(d);
+
+    size_t key = reinterpret_cast<size_t>(canonical);
+    pointer_map::const_iterator i = verdicts_.find(key);
+    if (i != verdicts_.end())
+      return i->second;
+
+    bool verdict = evaluate(d);
+    verdicts_[key] = verdict;
+    return verdict;
+  }
+};// end class suppressions_index
+
 /// The private member (pimpl) for @ref diff_context.
 struct diff_context::priv
 {
+  // This must be destroyed after the diff nodes held by the other
+  // data members, so it comes first.
+  diff_node_pool			node_pool_;
   diff_category			allowed_category_;
   types_or_decls_diff_map_type		types_or_decls_diff_map;
   vector<diff_sptr>			canonical_diffs;
   vector<filtering::filter_base_sptr>	filters_;
   suppressions_type			suppressions_;
+  suppressions_index			suppressions_index_;
   pointer_map				visited_diff_nodes_;
   corpus_sptr				first_corpus_;
   corpus_sptr				second_corpus_;
@@ -2370,6 +2757,44 @@ diff_context::diff_context()
   add_diff_filter(f);
 }
 
+/// Allocate memory for a diff node, or for its private data, from the
+/// memory pool of a given @ref diff_context.
+///
+/// The object built in that memory is to be managed by a shared
+/// pointer which deleter is an instance of @ref diff_node_deleter.
+///
+/// @param ctxt the context to allocate the memory from.  If it's
+/// nil, the memory is allocated with operator new.
+///
+/// @param size the size of the memory to allocate.
+///
+/// @return the memory allocated.
+void*
+allocate_diff_node_memory(const diff_context_sptr& ctxt, size_t size)
+{
+  if (!ctxt)
+    return ::operator new(size);
+  return ctxt->priv_->node_pool_.allocate(size);
+}
+
+/// Give back memory allocated by allocate_diff_node_memory().
+///
+/// @param ctxt the context the memory was allocated from.
+///
+/// @param p the memory to give back.
+///
+/// @param size the size of the memory, as passed to
+/// allocate_diff_node_memory().
+void
+deallocate_diff_node_memory(const diff_context_sptr& ctxt,
+			    void* p, size_t size)
+{
+  if (!ctxt)
+    ::operator delete(p);
+  else
+    ctxt->priv_->node_pool_.deallocate(p, size);
+}
+
 /// Set the corpora that are being compared into the context, so that
 /// some lower-level routines can have a chance to have access to
 /// them.
@@ -3136,7 +3561,7 @@ struct diff_less_than_functor
   ///
   /// @return true if @p l compares less than @p r.
   bool
-  operator()(const diff_sptr l, const diff_sptr r) const
+  operator()(const diff_sptr& l, const diff_sptr& r) const
   {
     if (!l || !r || !l->first_subject() || !r->first_subject())
       return false;
@@ -3178,10 +3603,12 @@ diff::diff(type_or_decl_base_sptr first_subject,
 diff::diff(type_or_decl_base_sptr	first_subject,
 	   type_or_decl_base_sptr	second_subject,
 	   diff_context_sptr	ctxt)
-  : priv_(new priv(first_subject, second_subject,
-		   ctxt, NO_CHANGE_CATEGORY,
-		   /*reported_once=*/false,
-		   /*currently_reporting=*/false))
+  : priv_(new (diff_node_memory<priv>(ctxt))
+	  priv(first_subject, second_subject,
+	       ctxt, NO_CHANGE_CATEGORY,
+	       /*reported_once=*/false,
+	       /*currently_reporting=*/false),
+	  diff_node_deleter(ctxt))
 {}
 
 /// Flag a given diff node as being traversed.
@@ -3271,10 +3698,19 @@ diff::second_subject() const
 
 /// Getter for the children nodes of the current @ref diff node.
 ///
+/// The children nodes are gathered by diff::finish_diff_type() the
+/// first time they are needed.  Some kinds of diff node (like @ref
+/// var_diff or @ref function_decl_diff) also compute the diffs that
+/// make up their children nodes at that point, so that a diff node
+/// whose children are never looked at doesn't pay for them.
+///
 /// @return a vector of the children nodes.
 const vector<diff_sptr>&
 diff::children_nodes() const
-{return priv_->children_;}
+{
+  const_cast<diff*>(this)->finish_diff_type();
+  return priv_->children_;
+}
 
 /// Getter for the parent node of the current @ref diff node.
 ///
@@ -3312,12 +3748,16 @@ void
 diff::append_child_node(diff_sptr d)
 {
   assert(d);
-  priv_->children_.push_back(d);
 
+  // The children nodes are kept sorted.  Rather than re-sorting them
+  // all each time a new one is added, insert the new one at its
+  // place, after the ones that compare equal to it.
   diff_less_than_functor comp;
-  std::sort(priv_->children_.begin(),
-	    priv_->children_.end(),
-	    comp);
+  vector<diff_sptr>::iterator i =
+    std::upper_bound(priv_->children_.begin(),
+		     priv_->children_.end(),
+		     d, comp);
+  priv_->children_.insert(i, d);
 
   d->priv_->parent_ = this;
 }
@@ -3418,8 +3858,8 @@ diff::reported_once() const
 bool
 diff::traverse(diff_node_visitor& v)
 {
-  finish_diff_type();
-
+  // Note that the children nodes are gathered by
+  // diff::children_nodes() only if the visitor wants to visit them.
   v.visit_begin(this);
 
   bool already_visited = false;
@@ -3632,13 +4072,10 @@ diff::is_filtered_out_wrt_non_inherited_categories() const
 bool
 diff::is_suppressed() const
 {
-  const suppressions_type& suppressions = context()->suppressions();
-    for (suppressions_type::const_iterator i = suppressions.begin();
-       i != suppressions.end();
-       ++i)
-    if ((*i)->suppresses_diff(this))
-      return true;
-  return false;
+  diff_context::priv& ctxt = *context()->priv_;
+  if (ctxt.suppressions_index_.is_stale(ctxt.suppressions_))
+    ctxt.suppressions_index_.build(ctxt.suppressions_);
+  return ctxt.suppressions_index_.suppresses_diff(this);
 }
 
 /// Test if this diff tree node should be reported.
@@ -3720,7 +4157,8 @@ type_diff_base::type_diff_base(type_base_sptr	first_subject,
 			       type_base_sptr	second_subject,
 			       diff_context_sptr	ctxt)
   : diff(first_subject, second_subject, ctxt),
-    priv_(new priv)
+    priv_(new (diff_node_memory<priv>(ctxt)) priv,
+	  diff_node_deleter(ctxt))
 {}
 
 type_diff_base::~type_diff_base()
@@ -3738,7 +4176,8 @@ decl_diff_base::decl_diff_base(decl_base_sptr	first_subject,
 			       decl_base_sptr	second_subject,
 			       diff_context_sptr	ctxt)
   : diff(first_subject, second_subject, ctxt),
-    priv_(new priv)
+    priv_(new (diff_node_memory<priv>(ctxt)) priv,
+	  diff_node_deleter(ctxt))
 {}
 
 decl_diff_base::~decl_diff_base()
@@ -3804,7 +4243,8 @@ distinct_diff::distinct_diff(type_or_decl_base_sptr first,
 			     type_or_decl_base_sptr second,
 			     diff_context_sptr ctxt)
   : diff(first, second, ctxt),
-    priv_(new priv)
+    priv_(new (diff_node_memory<priv>(ctxt)) priv,
+	  diff_node_deleter(ctxt))
 {assert(entities_are_of_distinct_kinds(first, second));}
 
 /// Finish building the current instance of @ref distinct_diff.
@@ -3963,7 +4403,9 @@ compute_diff_for_distinct_kinds(const decl_base_sptr first,
   if (!distinct_diff::entities_are_of_distinct_kinds(first, second))
     return distinct_diff_sptr();
 
-  distinct_diff_sptr result(new distinct_diff(first, second, ctxt));
+  distinct_diff_sptr result(new (diff_node_memory<distinct_diff>(ctxt))
+			    distinct_diff(first, second, ctxt),
+			    diff_node_deleter(ctxt));
 
   ctxt->initialize_canonical_diff(result);
 
@@ -4899,7 +5341,8 @@ var_diff::var_diff(var_decl_sptr	first,
 		   diff_sptr		type_diff,
 		   diff_context_sptr	ctxt)
   : decl_diff_base(first, second, ctxt),
-    priv_(new priv)
+    priv_(new (diff_node_memory<priv>(ctxt)) priv,
+	  diff_node_deleter(ctxt))
 {priv_->type_diff_ = type_diff;}
 
 /// Finish building the current instance of @ref var_diff.
@@ -5017,7 +5460,9 @@ compute_diff(const var_decl_sptr	first,
 	     const var_decl_sptr	second,
 	     diff_context_sptr		ctxt)
 {
-  var_diff_sptr d(new var_diff(first, second, diff_sptr(), ctxt));
+  var_diff_sptr d(new (diff_node_memory<var_diff>(ctxt))
+		  var_diff(first, second, diff_sptr(), ctxt),
+		  diff_node_deleter(ctxt));
   ctxt->initialize_canonical_diff(d);
   return d;
 }
@@ -5108,7 +5553,8 @@ pointer_diff::pointer_diff(pointer_type_def_sptr	first,
 			   diff_sptr			underlying,
 			   diff_context_sptr		ctxt)
   : type_diff_base(first, second, ctxt),
-    priv_(new priv(underlying))
+    priv_(new (diff_node_memory<priv>(ctxt)) priv(underlying),
+	  diff_node_deleter(ctxt))
 {}
 
 /// Finish building the current instance of @ref pointer_diff.
@@ -5233,7 +5679,9 @@ compute_diff(pointer_type_def_sptr	first,
   diff_sptr d = compute_diff_for_types(first->get_pointed_to_type(),
 				       second->get_pointed_to_type(),
 				       ctxt);
-  pointer_diff_sptr result(new pointer_diff(first, second, d, ctxt));
+  pointer_diff_sptr result(new (diff_node_memory<pointer_diff>(ctxt))
+			   pointer_diff(first, second, d, ctxt),
+			   diff_node_deleter(ctxt));
   ctxt->initialize_canonical_diff(result);
 
   return result;
@@ -5276,7 +5724,8 @@ array_diff::array_diff(const array_type_def_sptr	first,
 		       diff_sptr			element_type_diff,
 		       diff_context_sptr		ctxt)
   : type_diff_base(first, second, ctxt),
-    priv_(new priv(element_type_diff))
+    priv_(new (diff_node_memory<priv>(ctxt)) priv(element_type_diff),
+	  diff_node_deleter(ctxt))
 {}
 
 /// Finish building the current instance of @ref array_diff.
@@ -5421,7 +5870,9 @@ compute_diff(array_type_def_sptr	first,
   diff_sptr d = compute_diff_for_types(first->get_element_type(),
 				       second->get_element_type(),
 				       ctxt);
-  array_diff_sptr result(new array_diff(first, second, d, ctxt));
+  array_diff_sptr result(new (diff_node_memory<array_diff>(ctxt))
+			 array_diff(first, second, d, ctxt),
+			 diff_node_deleter(ctxt));
   ctxt->initialize_canonical_diff(result);
   return result;
 }
@@ -5457,7 +5908,8 @@ reference_diff::reference_diff(const reference_type_def_sptr	first,
 			       diff_sptr			underlying,
 			       diff_context_sptr		ctxt)
   : type_diff_base(first, second, ctxt),
-	priv_(new priv(underlying))
+	priv_(new (diff_node_memory<priv>(ctxt)) priv(underlying),
+	      diff_node_deleter(ctxt))
 {}
 
 /// Finish building the current instance of @ref reference_diff.
@@ -5578,7 +6030,9 @@ compute_diff(reference_type_def_sptr	first,
   diff_sptr d = compute_diff_for_types(first->get_pointed_to_type(),
 				       second->get_pointed_to_type(),
 				       ctxt);
-  reference_diff_sptr result(new reference_diff(first, second, d, ctxt));
+  reference_diff_sptr result(new (diff_node_memory<reference_diff>(ctxt))
+			     reference_diff(first, second, d, ctxt),
+			     diff_node_deleter(ctxt));
   ctxt->initialize_canonical_diff(result);
   return result;
 }
@@ -5617,7 +6071,8 @@ qualified_type_diff::qualified_type_diff(qualified_type_def_sptr	first,
 					 diff_sptr			under,
 					 diff_context_sptr		ctxt)
   : type_diff_base(first, second, ctxt),
-    priv_(new priv(under))
+    priv_(new (diff_node_memory<priv>(ctxt)) priv(under),
+	  diff_node_deleter(ctxt))
 {}
 
 /// Finish building the current instance of @ref qualified_type_diff.
@@ -5804,8 +6259,10 @@ compute_diff(const qualified_type_def_sptr	first,
   diff_sptr d = compute_diff_for_types(first->get_underlying_type(),
 				       second->get_underlying_type(),
 				       ctxt);
-  qualified_type_diff_sptr result(new qualified_type_diff(first, second,
-							  d, ctxt));
+  qualified_type_diff_sptr result
+    (new (diff_node_memory<qualified_type_diff>(ctxt))
+     qualified_type_diff(first, second, d, ctxt),
+     diff_node_deleter(ctxt));
   ctxt->initialize_canonical_diff(result);
   return result;
 }
@@ -5928,7 +6385,8 @@ enum_diff::enum_diff(const enum_type_decl_sptr	first,
 		     const diff_sptr		underlying_type_diff,
 		     const diff_context_sptr	ctxt)
   : type_diff_base(first, second,ctxt),
-    priv_(new priv(underlying_type_diff))
+    priv_(new (diff_node_memory<priv>(ctxt)) priv(underlying_type_diff),
+	  diff_node_deleter(ctxt))
 {}
 
 /// Finish building the current instance of @ref enum_diff.
@@ -6176,13 +6634,15 @@ compute_diff(const enum_type_decl_sptr first,
   diff_sptr ud = compute_diff_for_types(first->get_underlying_type(),
 					second->get_underlying_type(),
 					ctxt);
-  enum_diff_sptr d(new enum_diff(first, second, ud, ctxt));
+  enum_diff_sptr d(new (diff_node_memory<enum_diff>(ctxt))
+		   enum_diff(first, second, ud, ctxt),
+		   diff_node_deleter(ctxt));
 
-  compute_diff(first->get_enumerators().begin(),
-	       first->get_enumerators().end(),
-	       second->get_enumerators().begin(),
-	       second->get_enumerators().end(),
-	       d->priv_->enumerators_changes_);
+  compute_trimmed_diff(first->get_enumerators().begin(),
+		       first->get_enumerators().end(),
+		       second->get_enumerators().begin(),
+		       second->get_enumerators().end(),
+		       d->priv_->enumerators_changes_);
 
   d->ensure_lookup_tables_populated();
 
@@ -6233,6 +6693,10 @@ struct class_diff::priv
   string_decl_base_sptr_map inserted_member_class_tmpls_;
   string_diff_sptr_map changed_member_class_tmpls_;
   diff_sptrs_type sorted_changed_member_class_tmpls_;
+  // Whether the lookup tables above have been populated from the
+  // edit scripts.  They are populated the first time they are
+  // needed, by class_diff::ensure_lookup_tables_populated.
+  bool lookup_tables_populated_;
 
   class_decl::base_spec_sptr
   base_has_changed(class_decl::base_spec_sptr) const;
@@ -6271,6 +6735,7 @@ struct class_diff::priv
   count_filtered_deleted_mem_fns(const diff_context_sptr&);
 
   priv()
+    : lookup_tables_populated_(false)
   {}
 };//end struct class_diff::priv
 
@@ -6296,6 +6761,7 @@ class_diff::clear_lookup_tables(void)
   priv_->deleted_member_class_tmpls_.clear();
   priv_->inserted_member_class_tmpls_.clear();
   priv_->changed_member_class_tmpls_.clear();
+  priv_->lookup_tables_populated_ = false;
 }
 
 /// Tests if the lookup tables are empty.
@@ -6323,12 +6789,32 @@ class_diff::lookup_tables_empty(void) const
 
 /// If the lookup tables are not yet built, walk the differences and
 /// fill the lookup tables.
+///
+/// This is where the diffs of the bases, data members and member
+/// functions of the classes are computed.  It's called by the
+/// accessors of these diffs and by class_diff::report, so the diff
+/// sub-trees of a class_diff that is never looked at are not built.
 void
 class_diff::ensure_lookup_tables_populated(void) const
 {
-  if (!lookup_tables_empty())
+  if (priv_->lookup_tables_populated_)
     return;
 
+  // The private data is shared with the canonical diff node, whose
+  // subjects the edit scripts were computed from.  So let it
+  // populate the lookup tables.
+  const class_diff* canonical =
+    dynamic_cast<const class_diff*>(get_canonical_diff());
+  if (canonical && canonical != this)
+    {
+      canonical->ensure_lookup_tables_populated();
+      return;
+    }
+
+  // Set this upfront, as some of the accessors used below call this
+  // function too.
+  priv_->lookup_tables_populated_ = true;
+
   {
     edit_script& e = priv_->base_changes_;
 
@@ -7014,6 +7500,8 @@ class_diff::priv::count_filtered_deleted_mem_fns(const diff_context_sptr& ctxt)
 void
 class_diff::chain_into_hierarchy()
 {
+  ensure_lookup_tables_populated();
+
   // base class changes.
   for (base_diff_sptrs_type::const_iterator i =
 	 priv_->sorted_changed_bases_.begin();
@@ -7143,7 +7631,10 @@ class_diff::base_changes() const
 /// their pretty representation.
 const string_base_sptr_map&
 class_diff::deleted_bases() const
-{return priv_->deleted_bases_;}
+{
+  ensure_lookup_tables_populated();
+  return priv_->deleted_bases_;
+}
 
 /// Getter for the inserted base classes of the diff.
 ///
@@ -7151,14 +7642,20 @@ class_diff::deleted_bases() const
 /// their pretty representation.
 const string_base_sptr_map&
 class_diff::inserted_bases() const
-{return priv_->inserted_bases_;}
+{
+  ensure_lookup_tables_populated();
+  return priv_->inserted_bases_;
+}
 
 /// Getter for the changed base classes of the diff.
 ///
 /// @return a sorted vector containing the changed base classes
 const base_diff_sptrs_type&
 class_diff::changed_bases()
-{return priv_->sorted_changed_bases_;}
+{
+  ensure_lookup_tables_populated();
+  return priv_->sorted_changed_bases_;
+}
 
 /// @return the edit script of the bases of the two classes.
 edit_script&
@@ -7190,14 +7687,20 @@ class_diff::data_members_changes()
 /// @return a map of data members that got inserted.
 const string_decl_base_sptr_map&
 class_diff::inserted_data_members() const
-{return priv_->inserted_data_members_;}
+{
+  ensure_lookup_tables_populated();
+  return priv_->inserted_data_members_;
+}
 
 /// Getter for the data members that got deleted.
 ///
 /// @return a map of data members that got deleted.
 const string_decl_base_sptr_map&
 class_diff::deleted_data_members() const
-{return priv_->deleted_data_members_;}
+{
+  ensure_lookup_tables_populated();
+  return priv_->deleted_data_members_;
+}
 
 /// @return the edit script of the member functions of the two
 /// classes.
@@ -7212,7 +7715,10 @@ class_diff::member_fns_changes() const
 /// sub-type change.
 const function_decl_diff_sptrs_type&
 class_diff::changed_member_fns() const
-{return priv_->sorted_changed_member_functions_;}
+{
+  ensure_lookup_tables_populated();
+  return priv_->sorted_changed_member_functions_;
+}
 
 /// @return the edit script of the member functions of the two
 /// classes.
@@ -7223,12 +7729,18 @@ class_diff::member_fns_changes()
 /// @return a map of member functions that got deleted.
 const string_member_function_sptr_map&
 class_diff::deleted_member_fns() const
-{return priv_->deleted_member_functions_;}
+{
+  ensure_lookup_tables_populated();
+  return priv_->deleted_member_functions_;
+}
 
 /// @return a map of member functions that got inserted.
 const string_member_function_sptr_map&
 class_diff::inserted_member_fns() const
-{return priv_->inserted_member_functions_;}
+{
+  ensure_lookup_tables_populated();
+  return priv_->inserted_member_functions_;
+}
 
 ///@return the edit script of the member function templates of the two
 ///classes.
@@ -7462,6 +7974,8 @@ class_diff::report(ostream& out, const string& indent) const
   if (!to_be_reported())
     return;
 
+  ensure_lookup_tables_populated();
+
   string name = first_subject()->get_pretty_representation();
 
   RETURN_IF_BEING_REPORTED_OR_WAS_REPORTED_EARLIER(first_subject(),
@@ -7469,6 +7983,10 @@ class_diff::report(ostream& out, const string& indent) const
 
   currently_reporting(true);
 
+  // The indentation of the reports of the sub-nodes, computed once
+  // rather than for each of them.
+  const string sub_indent = indent + "    ";
+
   // Now report the changes about the differents parts of the type.
   class_decl_sptr first = first_class_decl(),
     second = second_class_decl();
@@ -7530,7 +8048,7 @@ class_diff::report(ostream& out, const string& indent) const
 	      out << indent << "  '"
 		  << o->get_base_class()->get_pretty_representation()
 		  << "' changed:\n";
-	      diff->report(out, indent + "    ");
+	      diff->report(out, sub_indent);
 	      emitted = true;
 	    }
 	  if (emitted)
@@ -7649,7 +8167,7 @@ class_diff::report(ostream& out, const string& indent) const
 	      && i != priv_->sorted_changed_member_functions_.begin())
 	    out << "\n";
 	  out << indent << "  '" << repr << "' has some sub-type changes:\n";
-	  diff->report(out, indent + "    ");
+	  diff->report(out, sub_indent);
 	  emitted = true;
 	}
       if (numchanges)
@@ -7782,7 +8300,7 @@ class_diff::report(ostream& out, const string& indent) const
 	      out << indent << "  '"
 		  << o->get_pretty_representation()
 		  << "' changed:\n";
-	      (*it)->report(out, indent + "    ");
+	      (*it)->report(out, sub_indent);
 	    }
 	  out << "\n";
 	}
@@ -7953,7 +8471,9 @@ compute_diff(const class_decl_sptr	first,
   class_decl_sptr f = look_through_decl_only_class(first),
     s = look_through_decl_only_class(second);
 
-  class_diff_sptr changes(new class_diff(f, s, ctxt));
+  class_diff_sptr changes(new (diff_node_memory<class_diff>(ctxt))
+			  class_diff(f, s, ctxt),
+			  diff_node_deleter(ctxt));
 
   ctxt->initialize_canonical_diff(changes);
   assert(changes->get_canonical_diff());
@@ -7981,7 +8501,9 @@ compute_diff(const class_decl_sptr	first,
   if (dynamic_cast<class_diff*>(changes->get_canonical_diff()) == changes.get())
     // changes is its own canonical instance, so it gets a brand new
     // private data.
-    changes->priv_.reset(new class_diff::priv);
+    changes->priv_.reset(new (diff_node_memory<class_diff::priv>(ctxt))
+			 class_diff::priv,
+			 diff_node_deleter(ctxt));
   else
     {
       // changes has a non-empty equivalence class so it's going to
@@ -7993,11 +8515,11 @@ compute_diff(const class_decl_sptr	first,
     }
 
   // Compare base specs
-  compute_diff(f->get_base_specifiers().begin(),
-	       f->get_base_specifiers().end(),
-	       s->get_base_specifiers().begin(),
-	       s->get_base_specifiers().end(),
-	       changes->base_changes());
+  compute_trimmed_diff(f->get_base_specifiers().begin(),
+		       f->get_base_specifiers().end(),
+		       s->get_base_specifiers().begin(),
+		       s->get_base_specifiers().end(),
+		       changes->base_changes());
 
   // Do *not* compare member types because it generates lots of noise
   // and I doubt it's really useful.
@@ -8010,25 +8532,25 @@ compute_diff(const class_decl_sptr	first,
 #endif
 
   // Compare data member
-  compute_diff(f->get_data_members().begin(),
-	       f->get_data_members().end(),
-	       s->get_data_members().begin(),
-	       s->get_data_members().end(),
-	       changes->data_members_changes());
+  compute_trimmed_diff(f->get_data_members().begin(),
+		       f->get_data_members().end(),
+		       s->get_data_members().begin(),
+		       s->get_data_members().end(),
+		       changes->data_members_changes());
 
   // Compare virtual member functions
-  compute_diff(f->get_virtual_mem_fns().begin(),
-	       f->get_virtual_mem_fns().end(),
-	       s->get_virtual_mem_fns().begin(),
-	       s->get_virtual_mem_fns().end(),
-	       changes->member_fns_changes());
+  compute_trimmed_diff(f->get_virtual_mem_fns().begin(),
+		       f->get_virtual_mem_fns().end(),
+		       s->get_virtual_mem_fns().begin(),
+		       s->get_virtual_mem_fns().end(),
+		       changes->member_fns_changes());
 
   // Compare member function templates
-  compute_diff(f->get_member_function_templates().begin(),
-	       f->get_member_function_templates().end(),
-	       s->get_member_function_templates().begin(),
-	       s->get_member_function_templates().end(),
-	       changes->member_fn_tmpls_changes());
+  compute_trimmed_diff(f->get_member_function_templates().begin(),
+		       f->get_member_function_templates().end(),
+		       s->get_member_function_templates().begin(),
+		       s->get_member_function_templates().end(),
+		       changes->member_fn_tmpls_changes());
 
   // Likewise, do not compare member class templates
 #if 0
@@ -8039,7 +8561,8 @@ compute_diff(const class_decl_sptr	first,
 	       changes->member_class_tmpls_changes());
 #endif
 
-  changes->ensure_lookup_tables_populated();
+  // Note that the diffs of the members are computed lazily, by
+  // class_diff::ensure_lookup_tables_populated().
 
   return changes;
 }
@@ -8075,7 +8598,8 @@ base_diff::base_diff(class_decl::base_spec_sptr first,
 		     class_diff_sptr		underlying,
 		     diff_context_sptr		ctxt)
   : diff(first, second, ctxt),
-    priv_(new priv(underlying))
+    priv_(new (diff_node_memory<priv>(ctxt)) priv(underlying),
+	  diff_node_deleter(ctxt))
 {}
 
 /// Finish building the current instance of @ref base_diff.
@@ -8224,7 +8748,9 @@ compute_diff(const class_decl::base_spec_sptr	first,
   class_diff_sptr cl = compute_diff(first->get_base_class(),
 				    second->get_base_class(),
 				    ctxt);
-  base_diff_sptr changes(new base_diff(first, second, cl, ctxt));
+  base_diff_sptr changes(new (diff_node_memory<base_diff>(ctxt))
+			 base_diff(first, second, cl, ctxt),
+			 diff_node_deleter(ctxt));
 
   ctxt->initialize_canonical_diff(changes);
 
@@ -8282,6 +8808,15 @@ struct scope_diff::priv
   // scope but that has not been deleted from it.
   string_decl_base_sptr_map added_types_;
   string_decl_base_sptr_map added_decls_;
+
+  // Whether the lookup tables above have been populated from
+  // member_changes_.  They are populated the first time they are
+  // needed, by scope_diff::ensure_lookup_tables_populated.
+  bool lookup_tables_populated_;
+
+  priv()
+    : lookup_tables_populated_(false)
+  {}
 };//end struct scope_diff::priv
 
 /// Clear the lookup tables that are useful for reporting.
@@ -8301,6 +8836,7 @@ scope_diff::clear_lookup_tables()
   priv_->removed_decls_.clear();
   priv_->added_types_.clear();
   priv_->added_decls_.clear();
+  priv_->lookup_tables_populated_ = false;
 }
 
 /// Tests if the lookup tables are empty.
@@ -8326,11 +8862,17 @@ scope_diff::lookup_tables_empty() const
 
 /// If the lookup tables are not yet built, walk the member_changes_
 /// member and fill the lookup tables.
+///
+/// This is where the diffs of the members of the scopes are
+/// computed.  It's called by the accessors of these diffs, so the
+/// diff sub-trees of a scope_diff that is never looked at are not
+/// built.
 void
 scope_diff::ensure_lookup_tables_populated()
 {
-  if (!lookup_tables_empty())
+  if (priv_->lookup_tables_populated_)
     return;
+  priv_->lookup_tables_populated_ = true;
 
   edit_script& e = priv_->member_changes_;
 
@@ -8493,7 +9035,8 @@ scope_diff::scope_diff(scope_decl_sptr first_scope,
 		       scope_decl_sptr second_scope,
 		       diff_context_sptr ctxt)
   : diff(first_scope, second_scope, ctxt),
-    priv_(new priv)
+    priv_(new (diff_node_memory<priv>(ctxt)) priv,
+	  diff_node_deleter(ctxt))
 {}
 
 /// Finish building the current instance of @ref scope_diff.
@@ -8629,29 +9172,47 @@ scope_diff::inserted_member_at(vector<unsigned>::const_iterator i)
 /// from the first scope to the other.
 const diff_sptrs_type&
 scope_diff::changed_types() const
-{return priv_->sorted_changed_types_;}
+{
+  const_cast<scope_diff*>(this)->ensure_lookup_tables_populated();
+  return priv_->sorted_changed_types_;
+}
 
 /// @return a sorted vector of the decls which content has changed
 /// from the first scope to the other.
 const diff_sptrs_type&
 scope_diff::changed_decls() const
-{return priv_->sorted_changed_decls_;}
+{
+  const_cast<scope_diff*>(this)->ensure_lookup_tables_populated();
+  return priv_->sorted_changed_decls_;
+}
 
 const string_decl_base_sptr_map&
 scope_diff::removed_types() const
-{return priv_->removed_types_;}
+{
+  const_cast<scope_diff*>(this)->ensure_lookup_tables_populated();
+  return priv_->removed_types_;
+}
 
 const string_decl_base_sptr_map&
 scope_diff::removed_decls() const
-{return priv_->removed_decls_;}
+{
+  const_cast<scope_diff*>(this)->ensure_lookup_tables_populated();
+  return priv_->removed_decls_;
+}
 
 const string_decl_base_sptr_map&
 scope_diff::added_types() const
-{return priv_->added_types_;}
+{
+  const_cast<scope_diff*>(this)->ensure_lookup_tables_populated();
+  return priv_->added_types_;
+}
 
 const string_decl_base_sptr_map&
 scope_diff::added_decls() const
-{return priv_->added_decls_;}
+{
+  const_cast<scope_diff*>(this)->ensure_lookup_tables_populated();
+  return priv_->added_decls_;
+}
 
 /// @return the pretty representation for the current instance of @ref
 /// scope_diff.
@@ -8869,13 +9430,14 @@ compute_diff(const scope_decl_sptr	first,
 {
   assert(d->first_scope() == first && d->second_scope() == second);
 
-  compute_diff(first->get_member_decls().begin(),
-	       first->get_member_decls().end(),
-	       second->get_member_decls().begin(),
-	       second->get_member_decls().end(),
-	       d->member_changes());
+  compute_trimmed_diff(first->get_member_decls().begin(),
+		       first->get_member_decls().end(),
+		       second->get_member_decls().begin(),
+		       second->get_member_decls().end(),
+		       d->member_changes());
 
-  d->ensure_lookup_tables_populated();
+  // Note that the diffs of the members are computed lazily, by
+  // scope_diff::ensure_lookup_tables_populated().
   d->context(ctxt);
 
   return d;
@@ -8896,7 +9458,9 @@ compute_diff(const scope_decl_sptr	first_scope,
 	     const scope_decl_sptr	second_scope,
 	     diff_context_sptr		ctxt)
 {
-  scope_diff_sptr d(new scope_diff(first_scope, second_scope, ctxt));
+  scope_diff_sptr d(new (diff_node_memory<scope_diff>(ctxt))
+		    scope_diff(first_scope, second_scope, ctxt),
+		    diff_node_deleter(ctxt));
   d = compute_diff(first_scope, second_scope, d, ctxt);
   ctxt->initialize_canonical_diff(d);
   return d;
@@ -8921,7 +9485,8 @@ fn_parm_diff::fn_parm_diff(const function_decl::parameter_sptr	first,
 			   const function_decl::parameter_sptr	second,
 			   diff_context_sptr			ctxt)
   : decl_diff_base(first, second, ctxt),
-    priv_(new priv)
+    priv_(new (diff_node_memory<priv>(ctxt)) priv,
+	  diff_node_deleter(ctxt))
 {
   assert(first->get_index() == second->get_index());
   priv_->type_diff = compute_diff(first->get_type(),
@@ -9072,7 +9637,9 @@ compute_diff(const function_decl::parameter_sptr	first,
   if (!first || !second)
     return fn_parm_diff_sptr();
 
-  fn_parm_diff_sptr result(new fn_parm_diff(first, second, ctxt));
+  fn_parm_diff_sptr result(new (diff_node_memory<fn_parm_diff>(ctxt))
+			   fn_parm_diff(first, second, ctxt),
+			   diff_node_deleter(ctxt));
   ctxt->initialize_canonical_diff(result);
 
   return result;
@@ -9218,7 +9785,8 @@ function_type_diff::function_type_diff(const function_type_sptr first,
 				       const function_type_sptr second,
 				       diff_context_sptr	ctxt)
   : type_diff_base(first, second, ctxt),
-    priv_(new priv)
+    priv_(new (diff_node_memory<priv>(ctxt)) priv,
+	  diff_node_deleter(ctxt))
 {}
 
 /// Finish building the current instance of @ref function_type_diff
@@ -9485,7 +10053,10 @@ compute_diff(const function_type_sptr	first,
       return function_type_diff_sptr();
     }
 
-  function_type_diff_sptr result(new function_type_diff(first, second, ctxt));
+  function_type_diff_sptr result
+    (new (diff_node_memory<function_type_diff>(ctxt))
+     function_type_diff(first, second, ctxt),
+     diff_node_deleter(ctxt));
 
   diff_utils::compute_diff(first->get_first_non_implicit_parm(),
 			   first->get_parameters().end(),
@@ -9520,7 +10091,8 @@ function_decl_diff::ensure_lookup_tables_populated()
 /// sub-object of this instance of @ref function_decl_diff.
 ///
 /// The children node can then later be retrieved using
-/// diff::children_node().
+/// diff::children_node().  Note that this computes the diff of the
+/// types of the functions, if it's not yet computed.
 void
 function_decl_diff::chain_into_hierarchy()
 {
@@ -9537,7 +10109,8 @@ function_decl_diff::function_decl_diff(const function_decl_sptr first,
 				       const function_decl_sptr second,
 				       diff_context_sptr	ctxt)
   : decl_diff_base(first, second, ctxt),
-    priv_(new priv)
+    priv_(new (diff_node_memory<priv>(ctxt)) priv,
+	  diff_node_deleter(ctxt))
 {
 }
 
@@ -9561,9 +10134,22 @@ const function_decl_sptr
 function_decl_diff::second_function_decl() const
 {return dynamic_pointer_cast<function_decl>(second_subject());}
 
+/// Getter for the diff of the types of the functions.
+///
+/// The diff is computed the first time it is needed.  This avoids
+/// building the diff sub-tree of functions which changes are never
+/// looked at, e.g, because they are suppressed.
+///
+/// @return the diff of the types of the functions.
 const function_type_diff_sptr
 function_decl_diff::type_diff() const
-{return priv_->type_diff_;}
+{
+  if (!priv_->type_diff_)
+    priv_->type_diff_ = compute_diff(first_function_decl()->get_type(),
+				     second_function_decl()->get_type(),
+				     context());
+  return priv_->type_diff_;
+}
 
 /// @return the pretty representation for the current instance of @ref
 /// function_decl_diff.
@@ -9733,30 +10319,32 @@ function_decl_diff::report(ostream& out, const string& indent) const
   function_decl_sptr ff = first_function_decl();
   function_decl_sptr sf = second_function_decl();
 
-  diff_context_sptr ctxt = context();
-  corpus_sptr fc = ctxt->get_first_corpus();
-  corpus_sptr sc = ctxt->get_second_corpus();
-
-  string qn1 = ff->get_qualified_name(), qn2 = sf->get_qualified_name(),
-    linkage_names1, linkage_names2;
-  elf_symbol_sptr s1 = ff->get_symbol(), s2 = sf->get_symbol();
-
-  if (s1)
-    linkage_names1 = s1->get_id_string();
-  if (s2)
-    linkage_names2 = s2->get_id_string();
-
-  // If the symbols for ff and sf have aliases, get all the names of
-  // the aliases;
-  if (fc && s1)
-    linkage_names1 =
-      s1->get_aliases_id_string(fc->get_fun_symbol_map());
-  if (sc && s2)
-    linkage_names2 =
-      s2->get_aliases_id_string(sc->get_fun_symbol_map());
+  string qn1 = ff->get_qualified_name(), qn2 = sf->get_qualified_name();
 
   if (qn1 != qn2)
     {
+      // Looking up the aliases of a symbol can walk the whole symbol
+      // table, so only do it when the linkage names are going to be
+      // emitted.
+      diff_context_sptr ctxt = context();
+      corpus_sptr fc = ctxt->get_first_corpus();
+      corpus_sptr sc = ctxt->get_second_corpus();
+      elf_symbol_sptr s1 = ff->get_symbol(), s2 = sf->get_symbol();
+      string linkage_names1, linkage_names2;
+      if (s1)
+	linkage_names1 = s1->get_id_string();
+      if (s2)
+	linkage_names2 = s2->get_id_string();
+
+      // If the symbols for ff and sf have aliases, get all the names
+      // of the aliases;
+      if (fc && s1)
+	linkage_names1 =
+	  s1->get_aliases_id_string(fc->get_fun_symbol_map());
+      if (sc && s2)
+	linkage_names2 =
+	  s2->get_aliases_id_string(sc->get_fun_symbol_map());
+
       string frep1 = first_function_decl()->get_pretty_representation(),
 	frep2 = second_function_decl()->get_pretty_representation();
       out << indent << "'" << frep1 << " {" << linkage_names1<< "}"
@@ -9802,13 +10390,12 @@ compute_diff(const function_decl_sptr first,
       return function_decl_diff_sptr();
     }
 
-  function_type_diff_sptr type_diff = compute_diff(first->get_type(),
-						   second->get_type(),
-						   ctxt);
-
-  function_decl_diff_sptr result(new function_decl_diff(first, second,
-							ctxt));
-  result->priv_->type_diff_ = type_diff;
+  // Note that the diff of the types of the functions is computed
+  // lazily, by function_decl_diff::type_diff().
+  function_decl_diff_sptr result
+    (new (diff_node_memory<function_decl_diff>(ctxt))
+     function_decl_diff(first, second, ctxt),
+     diff_node_deleter(ctxt));
 
   result->ensure_lookup_tables_populated();
 
@@ -9952,7 +10539,9 @@ compute_diff(const type_decl_sptr	first,
 	     const type_decl_sptr	second,
 	     diff_context_sptr		ctxt)
 {
-  type_decl_diff_sptr result(new type_decl_diff(first, second, ctxt));
+  type_decl_diff_sptr result(new (diff_node_memory<type_decl_diff>(ctxt))
+			     type_decl_diff(first, second, ctxt),
+			     diff_node_deleter(ctxt));
 
   // We don't need to actually compute a diff here as a type_decl
   // doesn't have complicated sub-components.  type_decl_diff::report
@@ -9994,7 +10583,8 @@ typedef_diff::typedef_diff(const typedef_decl_sptr	first,
 			   const diff_sptr		underlying,
 			   diff_context_sptr		ctxt)
   : type_diff_base(first, second, ctxt),
-    priv_(new priv(underlying))
+    priv_(new (diff_node_memory<priv>(ctxt)) priv(underlying),
+	  diff_node_deleter(ctxt))
 {}
 
 /// Finish building the current instance of @ref typedef_diff.
@@ -10140,7 +10730,9 @@ compute_diff(const typedef_decl_sptr	first,
   diff_sptr d = compute_diff_for_types(first->get_underlying_type(),
 				       second->get_underlying_type(),
 				       ctxt);
-  typedef_diff_sptr result(new typedef_diff(first, second, d, ctxt));
+  typedef_diff_sptr result(new (diff_node_memory<typedef_diff>(ctxt))
+			   typedef_diff(first, second, d, ctxt),
+			   diff_node_deleter(ctxt));
 
   ctxt->initialize_canonical_diff(result);
 
@@ -10170,7 +10762,8 @@ translation_unit_diff::translation_unit_diff(translation_unit_sptr first,
 					     translation_unit_sptr second,
 					     diff_context_sptr ctxt)
   : scope_diff(first->get_global_scope(), second->get_global_scope(), ctxt),
-    priv_(new priv(first, second))
+    priv_(new (diff_node_memory<priv>(ctxt)) priv(first, second),
+	  diff_node_deleter(ctxt))
 {
 }
 
@@ -10228,8 +10821,10 @@ compute_diff(const translation_unit_sptr	first,
     ctxt.reset(new diff_context);
 
   // TODO: handle first or second having empty contents.
-  translation_unit_diff_sptr tu_diff(new translation_unit_diff(first, second,
-							       ctxt));
+  translation_unit_diff_sptr tu_diff
+    (new (diff_node_memory<translation_unit_diff>(ctxt))
+     translation_unit_diff(first, second, ctxt),
+     diff_node_deleter(ctxt));
   scope_diff_sptr sc_diff = dynamic_pointer_cast<scope_diff>(tu_diff);
 
   compute_diff(static_pointer_cast<scope_decl>(first->get_global_scope()),
@@ -10893,7 +11488,11 @@ corpus_diff::priv::apply_filters_and_compute_diff_stats(diff_stats& stat)
   stat.num_vars_changed(changed_vars_map_.size());
 
   // Walk the changed function diff nodes to apply the categorization
-  // filters.
+  // filters.  Suppressed nodes are filtered out whatever their other
+  // categories are, so the filters are not applied to them, unless
+  // their categories are going to be dumped.  That way, their diff
+  // sub-tree doesn't need to be built.
+  bool skip_suppressed = !ctxt_->dump_diff_tree();
   diff_sptr diff;
   for (function_decl_diff_sptrs_type::const_iterator i =
 	 changed_fns_.begin();
@@ -10901,6 +11500,8 @@ corpus_diff::priv::apply_filters_and_compute_diff_stats(diff_stats& stat)
        ++i)
     {
       diff_sptr diff = *i;
+      if (skip_suppressed && (diff->get_category() & SUPPRESSED_CATEGORY))
+	continue;
       ctxt_->maybe_apply_filters(diff);
     }
 
@@ -10911,6 +11512,8 @@ corpus_diff::priv::apply_filters_and_compute_diff_stats(diff_stats& stat)
        ++i)
     {
       diff_sptr diff = *i;
+      if (skip_suppressed && (diff->get_category() & SUPPRESSED_CATEGORY))
+	continue;
       ctxt_->maybe_apply_filters(diff);
     }
 
@@ -11194,12 +11797,13 @@ void
 corpus_diff::append_child_node(diff_sptr d)
 {
   assert(d);
-  priv_->children_.push_back(d);
 
   diff_less_than_functor comp;
-  std::sort(priv_->children_.begin(),
-	    priv_->children_.end(),
-	    comp);
+  vector<diff_sptr>::iterator i =
+    std::upper_bound(priv_->children_.begin(),
+		     priv_->children_.end(),
+		     d, comp);
+  priv_->children_.insert(i, d);
 }
 
 /// @return the bare edit script of the functions changed as recorded
@@ -11666,6 +12270,10 @@ corpus_diff::report(ostream& out, const string& indent) const
     return;
   out << "\n";
 
+  // The indentation of the reports of the changed functions and
+  // variables, computed once rather than for each of them.
+  const string sub_indent = indent + "    ";
+
   if (context()->show_soname_change()
       && !priv_->sonames_equal_)
     out << indent << "SONAME changed from '"
@@ -11777,7 +12385,7 @@ corpus_diff::report(ostream& out, const string& indent) const
 	      out << indent << "  [C]'"
 		  << (*i)->first_function_decl()->get_pretty_representation()
 		  << "' has some indirect sub-type changes:\n";
-	      diff->report(out, indent + "    ");
+	      diff->report(out, sub_indent);
 	      out << "\n";
 	      emitted |= true;
 	    }
@@ -11897,7 +12505,7 @@ corpus_diff::report(ostream& out, const string& indent) const
 	  if (n1 != n2)
 	    out << " to '" << n2 << "'";
 	  out << ":\n";
-	  diff->report(out, indent + "    ");
+	  diff->report(out, sub_indent);
 	  out << "\n";
 	}
       if (num_changed)
@@ -12106,25 +12714,24 @@ compute_diff(const corpus_sptr	f,
   r->priv_->architectures_equal_ =
     f->get_architecture_name() == s->get_architecture_name();
 
-  diff_utils::compute_diff<fns_it_type, eq_type>(f->get_functions().begin(),
-						 f->get_functions().end(),
-						 s->get_functions().begin(),
-						 s->get_functions().end(),
-						 r->priv_->fns_edit_script_);
+  diff_utils::compute_trimmed_diff<fns_it_type, eq_type>
+    (f->get_functions().begin(), f->get_functions().end(),
+     s->get_functions().begin(), s->get_functions().end(),
+     r->priv_->fns_edit_script_);
 
-  diff_utils::compute_diff<vars_it_type, eq_type>
+  diff_utils::compute_trimmed_diff<vars_it_type, eq_type>
     (f->get_variables().begin(), f->get_variables().end(),
      s->get_variables().begin(), s->get_variables().end(),
      r->priv_->vars_edit_script_);
 
-  diff_utils::compute_diff<symbols_it_type, eq_type>
+  diff_utils::compute_trimmed_diff<symbols_it_type, eq_type>
     (f->get_unreferenced_function_symbols().begin(),
      f->get_unreferenced_function_symbols().end(),
      s->get_unreferenced_function_symbols().begin(),
      s->get_unreferenced_function_symbols().end(),
      r->priv_->unrefed_fn_syms_edit_script_);
 
-    diff_utils::compute_diff<symbols_it_type, eq_type>
+  diff_utils::compute_trimmed_diff<symbols_it_type, eq_type>
     (f->get_unreferenced_variable_symbols().begin(),
      f->get_unreferenced_variable_symbols().end(),
      s->get_unreferenced_variable_symbols().begin(),
@@ -12136,6 +12743,158 @@ compute_diff(const corpus_sptr	f,
   return r;
 }
 
+/// Test if a diff node carries a change that survives the
+/// suppressions and the filters of its context.
+///
+/// @param d the diff node to consider.
+///
+/// @return true iff @p d carries a change that is to be reported.
+static bool
+change_is_to_be_reported(diff_sptr d)
+{
+  apply_suppressions(d);
+  // A suppressed node stays filtered out whatever the filters say,
+  // so do not build its diff sub-tree to apply them.
+  if ((d->get_category() & SUPPRESSED_CATEGORY) && d->is_filtered_out())
+    return false;
+  d->context()->maybe_apply_filters(d);
+  return d->to_be_reported();
+}
+
+/// Compute the kind of ABI changes that exist between two corpora.
+///
+/// This yields the same conclusion as inspecting the @ref
+/// corpus_diff::diff_stats of the result of compute_diff(), after
+/// corpus_diff::apply_filters_and_suppressions_before_reporting() is
+/// invoked.  But it is cheaper because it stops at the first
+/// incompatible change, does not build the diff nodes of functions
+/// and variables that are merely removed or added, and builds the
+/// diff nodes of changed functions and variables only until one of
+/// them survives the suppressions and filters of the context.
+///
+/// Note that redundant changes are not categorized, as that cannot
+/// make all the changes filtered out: the first occurrence of a
+/// redundant change is not itself redundant.
+///
+/// @param f the first @ref corpus to consider.
+///
+/// @param s the second @ref corpus to consider.
+///
+/// @param ctxt the diff context carrying the suppressions and filters
+/// to use.
+///
+/// @return the kind of ABI changes carried by the two corpora.
+corpus_change_kind
+compute_corpus_change_kind(const corpus_sptr f,
+			   const corpus_sptr s,
+			   diff_context_sptr ctxt)
+{
+  if (!ctxt)
+    ctxt.reset(new diff_context);
+
+  ctxt->set_corpora(f, s);
+
+  if (f->get_soname() != s->get_soname())
+    return INCOMPATIBLE_CORPUS_CHANGE_KIND;
+
+  // A function of the first corpus is removed if no function of the
+  // second corpus has the same ID and if its symbol is not in the
+  // second corpus either.  It is changed if the function of the
+  // second corpus that has its ID is different.
+  vector<pair<function_decl*, function_decl*> > changed_fns;
+  {
+    string_function_ptr_map second_fns;
+    for (corpus::functions::const_iterator i = s->get_functions().begin();
+	 i != s->get_functions().end();
+	 ++i)
+      second_fns.insert(std::make_pair((*i)->get_id(), *i));
+
+    for (corpus::functions::const_iterator i = f->get_functions().begin();
+	 i != f->get_functions().end();
+	 ++i)
+      {
+	string_function_ptr_map::const_iterator j =
+	  second_fns.find((*i)->get_id());
+	if (j == second_fns.end())
+	  {
+	    elf_symbol_sptr sym = (*i)->get_symbol();
+	    if (!s->lookup_function_symbol(sym->get_name(),
+					   sym->get_version().str()))
+	      return INCOMPATIBLE_CORPUS_CHANGE_KIND;
+	  }
+	else if (**i != *j->second)
+	  changed_fns.push_back(std::make_pair(*i, j->second));
+      }
+  }
+
+  // Like corpus_diff::priv::ensure_lookup_tables_populated, consider
+  // that a variable of the first corpus that has no counterpart with
+  // the same ID in the second corpus is removed.
+  vector<pair<var_decl*, var_decl*> > changed_vars;
+  {
+    string_var_ptr_map second_vars;
+    for (corpus::variables::const_iterator i = s->get_variables().begin();
+	 i != s->get_variables().end();
+	 ++i)
+      second_vars.insert(std::make_pair((*i)->get_id(), *i));
+
+    for (corpus::variables::const_iterator i = f->get_variables().begin();
+	 i != f->get_variables().end();
+	 ++i)
+      {
+	string_var_ptr_map::const_iterator j =
+	  second_vars.find((*i)->get_id());
+	if (j == second_vars.end())
+	  return INCOMPATIBLE_CORPUS_CHANGE_KIND;
+	else if (**i != *j->second)
+	  changed_vars.push_back(std::make_pair(*i, j->second));
+      }
+  }
+
+  // A symbol not referenced by debug info is removed if the second
+  // corpus doesn't have it anymore.
+  for (elf_symbols::const_iterator i =
+	 f->get_unreferenced_function_symbols().begin();
+       i != f->get_unreferenced_function_symbols().end();
+       ++i)
+    if (!s->lookup_function_symbol((*i)->get_name(), (*i)->get_version()))
+      return INCOMPATIBLE_CORPUS_CHANGE_KIND;
+
+  for (elf_symbols::const_iterator i =
+	 f->get_unreferenced_variable_symbols().begin();
+       i != f->get_unreferenced_variable_symbols().end();
+       ++i)
+    if (!s->lookup_variable_symbol((*i)->get_name(), (*i)->get_version()))
+      return INCOMPATIBLE_CORPUS_CHANGE_KIND;
+
+  // Now that it's known that there is no incompatible change, look
+  // for the first change to a function or variable that is to be
+  // reported.
+  for (vector<pair<function_decl*, function_decl*> >::const_iterator i =
+	 changed_fns.begin();
+       i != changed_fns.end();
+       ++i)
+    {
+      function_decl_sptr first(i->first, noop_deleter());
+      function_decl_sptr second(i->second, noop_deleter());
+      if (change_is_to_be_reported(compute_diff(first, second, ctxt)))
+	return COMPATIBLE_CORPUS_CHANGE_KIND;
+    }
+
+  for (vector<pair<var_decl*, var_decl*> >::const_iterator i =
+	 changed_vars.begin();
+       i != changed_vars.end();
+       ++i)
+    {
+      var_decl_sptr first(i->first, noop_deleter());
+      var_decl_sptr second(i->second, noop_deleter());
+      if (change_is_to_be_reported(compute_diff(first, second, ctxt)))
+	return COMPATIBLE_CORPUS_CHANGE_KIND;
+    }
+
+  return NO_CORPUS_CHANGE_KIND;
+}
+
 // </corpus stuff>
 
 // <diff_node_visitor stuff>
@@ -12459,17 +13218,31 @@ propagate_categories(corpus_diff_sptr diff_tree)
 /// categorization.
 struct suppression_categorization_visitor : public diff_node_visitor
 {
+  bool skip_children_nodes_;
+
+  suppression_categorization_visitor()
+    : skip_children_nodes_()
+  {}
 
   /// Before visiting the children of the diff node, check if the node
   /// is suppressed by a suppression specification.  If it is, mark
   /// the node as belonging to the SUPPRESSED_CATEGORY category.
   ///
+  /// The children nodes of a suppressed node are not visited: they
+  /// are not going to be reported as part of the suppressed node
+  /// anyway.  That way, the diff sub-tree of a suppressed node can be
+  /// left unbuilt.
+  ///
   /// @param p the diff node to visit.
   virtual void
   visit_begin(diff* d)
   {
     if (d->is_suppressed())
-      d->add_to_local_and_inherited_categories(SUPPRESSED_CATEGORY);
+      {
+	d->add_to_local_and_inherited_categories(SUPPRESSED_CATEGORY);
+	set_visiting_kind(get_visiting_kind() | SKIP_CHILDREN_VISITING_KIND);
+	skip_children_nodes_ = true;
+      }
   }
 
   /// After visiting the children nodes of a given diff node,
@@ -12489,6 +13262,15 @@ struct suppression_categorization_visitor : public diff_node_visitor
   virtual void
   visit_end(diff* d)
   {
+    if (skip_children_nodes_)
+      {
+	// The children nodes of this suppressed node were skipped.
+	// Let's visit the children nodes of the other nodes.
+	set_visiting_kind(get_visiting_kind() & (~SKIP_CHILDREN_VISITING_KIND));
+	skip_children_nodes_ = false;
+	return;
+      }
+
     bool has_non_suppressed_child = false;
     bool has_non_empty_child = false;
     bool has_suppressed_child = false;
@@ -12739,6 +13521,479 @@ print_diff_tree(corpus_diff_sptr diff_tree,
 		std::ostream& o)
 {print_diff_tree(diff_tree.get(), o);}
 
+// <JSON reporting stuff>
+
+/// The names of the categories of changes, as emitted in the JSON
+/// representation of a diff tree.
+static const struct
+{
+  diff_category category;
+  const char* name;
+} json_category_names[] =
+{
+  {ACCESS_CHANGE_CATEGORY, "ACCESS_CHANGE_CATEGORY"},
+  {COMPATIBLE_TYPE_CHANGE_CATEGORY, "COMPATIBLE_TYPE_CHANGE_CATEGORY"},
+  {HARMLESS_DECL_NAME_CHANGE_CATEGORY, "HARMLESS_DECL_NAME_CHANGE_CATEGORY"},
+  {NON_VIRT_MEM_FUN_CHANGE_CATEGORY, "NON_VIRT_MEM_FUN_CHANGE_CATEGORY"},
+  {STATIC_DATA_MEMBER_CHANGE_CATEGORY, "STATIC_DATA_MEMBER_CHANGE_CATEGORY"},
+  {HARMLESS_ENUM_CHANGE_CATEGORY, "HARMLESS_ENUM_CHANGE_CATEGORY"},
+  {HARMLESS_SYMBOL_ALIAS_CHANGE_CATEORY,
+   "HARMLESS_SYMBOL_ALIAS_CHANGE_CATEORY"},
+  {SUPPRESSED_CATEGORY, "SUPPRESSED_CATEGORY"},
+  {SIZE_OR_OFFSET_CHANGE_CATEGORY, "SIZE_OR_OFFSET_CHANGE_CATEGORY"},
+  {VIRTUAL_MEMBER_CHANGE_CATEGORY, "VIRTUAL_MEMBER_CHANGE_CATEGORY"},
+  {REDUNDANT_CATEGORY, "REDUNDANT_CATEGORY"}
+};
+
+/// Get the name of the kind of a diff node, as emitted in the JSON
+/// representation of a diff tree.
+///
+/// @param d the diff node to consider.
+///
+/// @return the name of the kind of @p d.
+static const char*
+get_json_kind_name(const diff* d)
+{
+  // Note that translation_unit_diff must be tested before
+  // scope_diff, as the former derives from the latter.
+  if (is_function_decl_diff(d))
+    return "function";
+  if (is_var_diff(d))
+    return "variable";
+  if (dynamic_cast<const fn_parm_diff*>(d))
+    return "function-parameter";
+  if (dynamic_cast<const function_type_diff*>(d))
+    return "function-type";
+  if (dynamic_cast<const class_diff*>(d))
+    return "class-type";
+  if (dynamic_cast<const base_diff*>(d))
+    return "base-class";
+  if (dynamic_cast<const enum_diff*>(d))
+    return "enum-type";
+  if (dynamic_cast<const typedef_diff*>(d))
+    return "typedef";
+  if (dynamic_cast<const qualified_type_diff*>(d))
+    return "qualified-type";
+  if (dynamic_cast<const pointer_diff*>(d))
+    return "pointer-type";
+  if (dynamic_cast<const reference_diff*>(d))
+    return "reference-type";
+  if (dynamic_cast<const array_diff*>(d))
+    return "array-type";
+  if (dynamic_cast<const type_decl_diff*>(d))
+    return "basic-type";
+  if (dynamic_cast<const translation_unit_diff*>(d))
+    return "translation-unit";
+  if (dynamic_cast<const scope_diff*>(d))
+    return "scope";
+  if (dynamic_cast<const distinct_diff*>(d))
+    return "distinct";
+  return "unknown";
+}
+
+/// Emit the JSON representation of a diff tree to an output stream.
+///
+/// The representation is written to the output stream as the tree is
+/// walked, so it is never held in memory as a whole.  The pretty
+/// strings of the textual report are not built either; only the
+/// representations of the subjects of the diff nodes are emitted,
+/// along with their categories and the symbols of the functions and
+/// variables.
+///
+/// A diff node that has the same canonical diff as a diff node that
+/// has been emitted already is emitted without its children, much
+/// like the textual report says the details of such a node were
+/// reported earlier.  This also makes the walking of cyclic diff
+/// graphs terminate.
+class json_diff_emitter
+{
+  ostream&	out_;
+  pointer_map	emitted_;
+
+public:
+  json_diff_emitter(ostream& out)
+    : out_(out)
+  {}
+
+  /// Emit a string literal.
+  ///
+  /// @param s the string to emit.
+  void
+  emit_string(const string& s)
+  {emit_json_string(s, out_);}
+
+  /// Emit the id string of an ELF symbol, or null if there is no
+  /// symbol.
+  ///
+  /// @param sym the symbol to consider.
+  void
+  emit_symbol(const elf_symbol_sptr& sym)
+  {
+    if (sym)
+      emit_string(sym->get_id_string());
+    else
+      out_ << "null";
+  }
+
+  /// Emit the pretty representation of the subject of a diff node,
+  /// or null if there is no subject.
+  ///
+  /// @param subject the subject to consider.
+  void
+  emit_subject(const type_or_decl_base_sptr& subject)
+  {
+    if (subject)
+      emit_string(subject->get_pretty_representation());
+    else
+      out_ << "null";
+  }
+
+  /// Emit the array of the names of the categories of a set of
+  /// changes.
+  ///
+  /// @param c the categories to emit.
+  void
+  emit_categories(diff_category c)
+  {
+    out_ << "[";
+    bool emitted_a_category = false;
+    for (size_t i = 0;
+	 i < sizeof(json_category_names) / sizeof(json_category_names[0]);
+	 ++i)
+      if (c & json_category_names[i].category)
+	{
+	  if (emitted_a_category)
+	    out_ << ", ";
+	  out_ << "\"" << json_category_names[i].name << "\"";
+	  emitted_a_category = true;
+	}
+    out_ << "]";
+  }
+
+  /// Emit the JSON object representing a function or a variable that
+  /// got added or removed.
+  ///
+  /// @param d the declaration of the function or variable.
+  ///
+  /// @param sym the ELF symbol of @p d.
+  void
+  emit_decl(const decl_base& d, const elf_symbol_sptr& sym)
+  {
+    out_ << "{\"name\": ";
+    emit_string(d.get_pretty_representation());
+    out_ << ", \"symbol\": ";
+    emit_symbol(sym);
+    out_ << "}";
+  }
+
+  /// Emit the JSON object representing a diff node and, recursively,
+  /// its children nodes that carry changes.
+  ///
+  /// @param d the diff node to emit.
+  void
+  emit_node(const diff* d)
+  {
+    out_ << "{\"kind\": \"" << get_json_kind_name(d) << "\", \"first\": ";
+    emit_subject(d->first_subject());
+    out_ << ", \"second\": ";
+    emit_subject(d->second_subject());
+
+    if (const function_decl_diff* f = is_function_decl_diff(d))
+      {
+	out_ << ", \"first-symbol\": ";
+	emit_symbol(f->first_function_decl()->get_symbol());
+	out_ << ", \"second-symbol\": ";
+	emit_symbol(f->second_function_decl()->get_symbol());
+      }
+    else if (const var_diff* v = is_var_diff(d))
+      {
+	out_ << ", \"first-symbol\": ";
+	emit_symbol(v->first_var()->get_symbol());
+	out_ << ", \"second-symbol\": ";
+	emit_symbol(v->second_var()->get_symbol());
+      }
+
+    diff_category c = d->get_category();
+    out_ << ", \"categories\": ";
+    emit_categories(c);
+    out_ << ", \"suppressed\": "
+	 << ((c & SUPPRESSED_CATEGORY) ? "true" : "false")
+	 << ", \"redundant\": "
+	 << ((c & REDUNDANT_CATEGORY) ? "true" : "false");
+
+    bool filtered_out = d->is_filtered_out();
+    out_ << ", \"filtered-out\": " << (filtered_out ? "true" : "false");
+
+    if (!filtered_out)
+      {
+	const diff* canonical = d->get_canonical_diff();
+	if (!canonical)
+	  canonical = d;
+	size_t key = reinterpret_cast<size_t>(canonical);
+	if (emitted_.find(key) != emitted_.end())
+	  out_ << ", \"emitted-earlier\": true";
+	else
+	  {
+	    emitted_[key] = true;
+	    out_ << ", \"local-changes\": "
+		 << (d->has_local_changes() ? "true" : "false");
+	    out_ << ", \"children\": [";
+	    bool emitted_a_child = false;
+	    for (vector<diff_sptr>::const_iterator i =
+		   d->children_nodes().begin();
+		 i != d->children_nodes().end();
+		 ++i)
+	      {
+		if (!(*i)->has_changes())
+		  continue;
+		if (emitted_a_child)
+		  out_ << ", ";
+		emit_node(i->get());
+		emitted_a_child = true;
+	      }
+	    out_ << "]";
+	  }
+      }
+    out_ << "}";
+  }
+
+  /// Emit the JSON object representing an ABI corpus.
+  ///
+  /// @param c the corpus to emit.
+  void
+  emit_corpus(const corpus& c)
+  {
+    out_ << "{\"path\": ";
+    emit_string(c.get_path());
+    out_ << ", \"soname\": ";
+    emit_string(c.get_soname());
+    out_ << ", \"architecture\": ";
+    emit_string(c.get_architecture_name());
+    out_ << "}";
+  }
+
+  /// Emit the named JSON array of the functions held by a map, sorted
+  /// like in the textual report.
+  ///
+  /// @param name the name of the array.
+  ///
+  /// @param fns the map of the functions to emit.
+  void
+  emit_functions(const char* name, const string_function_ptr_map& fns)
+  {
+    vector<function_decl*> sorted;
+    sort_string_function_ptr_map(fns, sorted);
+    out_ << ",\n\"" << name << "\": [";
+    for (vector<function_decl*>::const_iterator i = sorted.begin();
+	 i != sorted.end();
+	 ++i)
+      {
+	if (i != sorted.begin())
+	  out_ << ",";
+	out_ << "\n  ";
+	emit_decl(**i, (*i)->get_symbol());
+      }
+    out_ << "]";
+  }
+
+  /// Emit the named JSON array of the variables held by a map, sorted
+  /// by their keys in the map.
+  ///
+  /// @param name the name of the array.
+  ///
+  /// @param vars the map of the variables to emit.
+  void
+  emit_variables(const char* name, const string_var_ptr_map& vars)
+  {
+    std::map<string, var_decl*> sorted(vars.begin(), vars.end());
+    out_ << ",\n\"" << name << "\": [";
+    for (std::map<string, var_decl*>::const_iterator i = sorted.begin();
+	 i != sorted.end();
+	 ++i)
+      {
+	if (i != sorted.begin())
+	  out_ << ",";
+	out_ << "\n  ";
+	emit_decl(*i->second, i->second->get_symbol());
+      }
+    out_ << "]";
+  }
+
+  /// Emit the named JSON array of the id strings of the symbols held
+  /// by a map, sorted by their keys in the map.
+  ///
+  /// @param name the name of the array.
+  ///
+  /// @param syms the map of the symbols to emit.
+  void
+  emit_symbols(const char* name, const string_elf_symbol_map& syms)
+  {
+    std::map<string, elf_symbol_sptr> sorted(syms.begin(), syms.end());
+    out_ << ",\n\"" << name << "\": [";
+    for (std::map<string, elf_symbol_sptr>::const_iterator i =
+	   sorted.begin();
+	 i != sorted.end();
+	 ++i)
+      {
+	if (i != sorted.begin())
+	  out_ << ",";
+	out_ << "\n  ";
+	emit_symbol(i->second);
+      }
+    out_ << "]";
+  }
+
+  /// Emit the named JSON array of a sequence of diff nodes.
+  ///
+  /// @param name the name of the array.
+  ///
+  /// @param begin an iterator to the first diff node to emit.
+  ///
+  /// @param end an iterator to the end of the diff nodes to emit.
+  template<typename iterator>
+  void
+  emit_nodes(const char* name, iterator begin, iterator end)
+  {
+    out_ << ",\n\"" << name << "\": [";
+    for (iterator i = begin; i != end; ++i)
+      {
+	if (i != begin)
+	  out_ << ",";
+	out_ << "\n  ";
+	emit_node(i->get());
+      }
+    out_ << "]";
+  }
+
+  /// Emit the JSON object representing a @ref corpus_diff.
+  ///
+  /// The sections of the object follow the ones of the textual
+  /// report, and the same options of the diff context tell which of
+  /// them are emitted.
+  ///
+  /// @param d the @ref corpus_diff to emit.
+  void
+  emit_corpus_diff(corpus_diff& d)
+  {
+    const corpus_diff::diff_stats& s =
+      d.apply_filters_and_suppressions_before_reporting();
+    diff_context_sptr ctxt = d.context();
+
+    out_ << "{\"first-corpus\": ";
+    emit_corpus(*d.first_corpus());
+    out_ << ",\n\"second-corpus\": ";
+    emit_corpus(*d.second_corpus());
+
+    out_ << ",\n\"stats\": {\"functions\": {\"removed\": "
+	 << s.num_func_removed()
+	 << ", \"changed\": " << s.num_func_changed()
+	 << ", \"filtered-out\": " << s.num_func_filtered_out()
+	 << ", \"added\": " << s.num_func_added()
+	 << "}, \"variables\": {\"removed\": " << s.num_vars_removed()
+	 << ", \"changed\": " << s.num_vars_changed()
+	 << ", \"filtered-out\": " << s.num_vars_filtered_out()
+	 << ", \"added\": " << s.num_vars_added() << "}";
+    if (ctxt->show_symbols_unreferenced_by_debug_info())
+      out_ << ", \"unreferenced-function-symbols\": {\"removed\": "
+	   << s.num_func_syms_removed()
+	   << ", \"added\": " << s.num_func_syms_added()
+	   << "}, \"unreferenced-variable-symbols\": {\"removed\": "
+	   << s.num_var_syms_removed()
+	   << ", \"added\": " << s.num_var_syms_added() << "}";
+    out_ << "}";
+
+    if (!ctxt->show_stats_only())
+      {
+	if (ctxt->show_soname_change())
+	  out_ << ",\n\"soname-changed\": "
+	       << (d.soname_changed() ? "true" : "false");
+	if (ctxt->show_architecture_change())
+	  out_ << ",\n\"architecture-changed\": "
+	       << (d.architecture_changed() ? "true" : "false");
+
+	if (ctxt->show_deleted_fns())
+	  emit_functions("removed-functions", d.deleted_functions());
+	if (ctxt->show_added_fns())
+	  emit_functions("added-functions", d.added_functions());
+	if (ctxt->show_changed_fns())
+	  {
+	    vector<function_decl_diff_sptr> sorted;
+	    sort_string_function_decl_diff_sptr_map(d.changed_functions(),
+						    sorted);
+	    emit_nodes("changed-functions", sorted.begin(), sorted.end());
+	  }
+
+	if (ctxt->show_deleted_vars())
+	  emit_variables("removed-variables", d.deleted_variables());
+	if (ctxt->show_added_vars())
+	  emit_variables("added-variables", d.added_variables());
+	if (ctxt->show_changed_vars())
+	  emit_nodes("changed-variables",
+		     d.changed_variables_sorted().begin(),
+		     d.changed_variables_sorted().end());
+
+	if (ctxt->show_symbols_unreferenced_by_debug_info())
+	  {
+	    emit_symbols("removed-unreferenced-function-symbols",
+			 d.deleted_unrefed_function_symbols());
+	    emit_symbols("added-unreferenced-function-symbols",
+			 d.added_unrefed_function_symbols());
+	    emit_symbols("removed-unreferenced-variable-symbols",
+			 d.deleted_unrefed_variable_symbols());
+	    emit_symbols("added-unreferenced-variable-symbols",
+			 d.added_unrefed_variable_symbols());
+	  }
+      }
+    out_ << "}";
+  }
+}; // end class json_diff_emitter
+
+/// Emit the JSON representation of a @ref diff sub-tree to an output
+/// stream.
+///
+/// The representation is a JSON object which members are the kind of
+/// the diff node, the pretty representations of its subjects, its
+/// categories, whether it is suppressed, redundant or filtered out,
+/// the ids of the symbols of the functions or variables it is about
+/// and, unless it is filtered out, the array of the representations
+/// of its children nodes that carry changes.
+///
+/// @param diff_tree the sub-tree to emit the JSON representation for.
+///
+/// @param out the output stream to emit the JSON representation to.
+void
+report_as_json(const diff_sptr& diff_tree, ostream& out)
+{
+  json_diff_emitter e(out);
+  e.emit_node(diff_tree.get());
+}
+
+/// Emit the JSON representation of a @ref corpus_diff tree to an
+/// output stream.
+///
+/// Like corpus_diff::report(), this applies the filters and the
+/// suppression specifications of the diff context to the tree first.
+///
+/// The representation is a JSON object which members describe the
+/// two corpora, the statistics about the changes, the removed and
+/// added functions, variables and symbols, and the arrays of the
+/// representations of the diff nodes of the changed functions and
+/// variables, as emitted by report_as_json(const diff_sptr&,
+/// ostream&).
+///
+/// @param diff_tree the @ref corpus_diff tree to emit the JSON
+/// representation for.
+///
+/// @param out the output stream to emit the JSON representation to.
+void
+report_as_json(const corpus_diff_sptr& diff_tree, ostream& out)
+{
+  json_diff_emitter e(out);
+  e.emit_corpus_diff(*diff_tree);
+}
+
+// </ JSON reporting stuff>
+
 // <redundancy_marking_visitor>
 
 /// A tree visitor to categorize nodes with respect to the
@@ -775,6 +775,7 @@ struct corpus::priv
   elf_symbols			sorted_undefined_fun_symbols;
   elf_symbols			unrefed_fun_symbols;
   elf_symbols			unrefed_var_symbols;
+  location_path_table_sptr	location_paths;
 
 private:
   priv();
@@ -806,101 +807,83 @@ typedef unordered_map<const var_decl*,
 		      var_decl::hash,
 		      var_decl::ptr_equal> var_ptr_map_type;
 
-/// This is a comparison functor for comparing pointers to @ref
-/// function_decl.
-struct func_comp
+/// The sort key of an element of a vector that is being sorted by
+/// sort_by_keys().
+///
+/// The keys are computed once per element before sorting, rather
+/// than once per comparison.
+struct sort_key
+{
+  // The primary key of the element.
+  const string*	key;
+  // The key to compare the element with, when either the element or
+  // the element it's being compared to has an empty primary key.
+  const string*	fallback_key;
+  // The index of the element in the vector being sorted.
+  size_t	index;
+}; // end struct sort_key
+
+/// A comparison functor for @ref sort_key, which compares the primary
+/// keys.
+struct sort_key_comp
 {
-  /// The comparisong operator for pointers to @ref function_decl.  It
-  /// performs a string comparison of the mangled names of the
-  /// functions.  If the functions don't have mangled names, it
-  /// compares their names instead.
-  ///
-  /// @param first the first function to consider in the comparison.
-  ///
-  /// @param second the second function to consider in the comparison.
-  ///
-  /// @return true if the (mangled) name of the first function is less
-  /// than the (mangled)name of the second one, false otherwise.
   bool
-  operator()(const function_decl* first,
-	     const function_decl* second) const
-  {
-    assert(first != 0 && second != 0);
-
-    string first_name, second_name;
-    first_name = first->get_linkage_name();
-    if (first_name.empty())
-      first_name = first->get_name();
-    assert(!first_name.empty());
-
-    second_name = second->get_linkage_name();
-    if (second_name.empty())
-      second_name = second->get_name();
-    assert(!second_name.empty());
-
-    return first_name < second_name;
-  }
-};
-
-/// This is a comparison functor for comparing pointers to @ref
-/// var_decl.
-struct var_comp
+  operator()(const sort_key& l, const sort_key& r) const
+  {return *l.key < *r.key;}
+}; // end struct sort_key_comp
+
+/// A comparison functor for @ref sort_key, which compares the primary
+/// keys, unless either of them is empty, in which case it compares
+/// the fallback keys.
+struct sort_key_with_fallback_comp
 {
-  /// The comparison operator for pointers to @ref var_decl.
-  ///
-  /// It perform a string comparison on the names of the variables.
-  ///
-  /// @param first the first variable to consider for the comparison.
-  ///
-  /// @param second the second variable to consider for the comparison.
-  ///
-  /// @return true if first is less than second, false otherwise.
   bool
-  operator()(const var_decl* first,
-	     const var_decl* second) const
+  operator()(const sort_key& l, const sort_key& r) const
   {
-    assert(first != 0 && second != 0);
-
-    string first_name, second_name;
-    first_name = first->get_linkage_name();
-    if (first_name.empty())
-      {
-	first_name = first->get_pretty_representation();
-	second_name = second->get_pretty_representation();
-	assert(!second_name.empty());
-      }
-    assert(!first_name.empty());
-
-    if (second_name.empty())
-      second_name = second->get_linkage_name();
-
-    if (second_name.empty())
-      {
-	second_name = second->get_pretty_representation();
-	first_name = first->get_pretty_representation();
-	assert(!first_name.empty());
-      }
-    assert(!second_name.empty());
-
-    return first_name < second_name;
+    if (l.key->empty() || r.key->empty())
+      return *l.fallback_key < *r.fallback_key;
+    return *l.key < *r.key;
   }
-};
-
+}; // end struct sort_key_with_fallback_comp
 
-/// A comparison functor to compare elf_symbols for the purpose of
-/// sorting.
-struct comp_elf_symbols_functor
+/// Sort a vector, given the sort keys of its elements.
+///
+/// @param elements the vector to sort.
+///
+/// @param keys the sort keys of the elements of @p elements.  The
+/// sort_key::index data member of each key is the index of the
+/// element it designates in @p elements.
+///
+/// @param comp the functor to compare the sort keys with.
+template<typename T, typename comparator>
+static void
+sort_by_keys(vector<T>& elements, vector<sort_key>& keys, comparator comp)
 {
-  bool
-  operator()(const elf_symbol& l,
-	     const elf_symbol& r) const
-  {return l.get_id_string() < r.get_id_string();}
+  std::sort(keys.begin(), keys.end(), comp);
+
+  vector<T> sorted;
+  sorted.reserve(elements.size());
+  for (vector<sort_key>::const_iterator k = keys.begin();
+       k != keys.end();
+       ++k)
+    sorted.push_back(elements[k->index]);
+  elements.swap(sorted);
+}
 
-  bool
-  operator()(const elf_symbol_sptr l,
-	     const elf_symbol_sptr r) const
-  {return operator()(*l, *r);}
-}; // end struct comp_elf_symbols_functor
+/// Sort a vector of ELF symbols by their ID strings.
+///
+/// @param syms the symbols to sort.
+static void
+sort_elf_symbols(elf_symbols& syms)
+{
+  vector<sort_key> keys(syms.size());
+  for (size_t i = 0; i < syms.size(); ++i)
+    {
+      keys[i].key = &syms[i]->get_id_string();
+      keys[i].index = i;
+    }
+  sort_by_keys(syms, keys, sort_key_comp());
+}
 
 /// Build the tables of symbols that are not referenced by any
 /// function or variables of corpus::get_functions() or
@@ -981,10 +964,7 @@ corpus::priv::build_unreferenced_symbols_tables()
 	      }
 	  }
 
-      comp_elf_symbols_functor comp;
-      std::sort(unrefed_fun_symbols.begin(),
-		unrefed_fun_symbols.end(),
-		comp);
+      sort_elf_symbols(unrefed_fun_symbols);
     }
 
   if (var_symbol_map)
@@ -1020,10 +1000,7 @@ corpus::priv::build_unreferenced_symbols_tables()
 	      }
 	  }
 
-      comp_elf_symbols_functor comp;
-      std::sort(unrefed_var_symbols.begin(),
-		unrefed_var_symbols.end(),
-		comp);
+      sort_elf_symbols(unrefed_var_symbols);
     }
 }
 
@@ -1036,10 +1013,34 @@ corpus::corpus(const string& path)
 /// to the corpus are going to be serialized on disk in the file
 /// associated to the current corpus.
 ///
+/// If no location was created in the translation unit yet, the
+/// translation unit is set to intern the paths of its locations in
+/// the table of paths of the corpus.
+///
 /// @param tu the new translation unit to add.
 void
 corpus::add(const translation_unit_sptr tu)
-{priv_->members.push_back(tu);}
+{
+  if (tu->get_loc_mgr().get_number_of_locations() == 0)
+    tu->get_loc_mgr().set_path_table(get_location_path_table());
+  priv_->members.push_back(tu);
+}
+
+/// Getter of the table of the file paths of the locations of the
+/// translation units of the corpus.
+///
+/// Sharing that table between the translation units of the corpus
+/// means that a given header file path is stored only once, however
+/// many declarations of the corpus it contains.
+///
+/// @return the table of paths.
+const location_path_table_sptr&
+corpus::get_location_path_table() const
+{
+  if (!priv_->location_paths)
+    priv_->location_paths.reset(new location_path_table);
+  return priv_->location_paths;
+}
 
 /// Return the list of translation units of the current corpus.
 ///
@@ -1125,7 +1126,7 @@ corpus::set_needed(const vector<string>& needed)
 ///
 /// @return the soname property of the corpus.
 const string&
-corpus::get_soname()
+corpus::get_soname() const
 {return priv_->soname;}
 
 /// Setter for the soname property of the corpus.
@@ -1147,7 +1148,7 @@ corpus::set_soname(const string& soname)
 ///
 /// @return the architecture name string.
 const string&
-corpus::get_architecture_name()
+corpus::get_architecture_name() const
 {return priv_->architecture_name;}
 
 /// Setter for the architecture name of the corpus.
@@ -1579,13 +1580,24 @@ corpus::get_functions() const
 
 /// Sort the set of functions exported by this corpus.
 ///
+/// The functions are sorted by their linkage names, or by their names
+/// if they don't have linkage names.
+///
 /// Normally, you shouldn't be calling this as the code that creates
 /// the corpus for you should do it for you too.
 void
 corpus::sort_functions()
 {
-  func_comp fc;
-  std::sort(priv_->fns.begin(), priv_->fns.end(), fc);
+  functions& fns = priv_->fns;
+  vector<sort_key> keys(fns.size());
+  for (size_t i = 0; i < fns.size(); ++i)
+    {
+      const string& linkage_name = fns[i]->get_linkage_name();
+      keys[i].key = linkage_name.empty() ? &fns[i]->get_name() : &linkage_name;
+      assert(!keys[i].key->empty());
+      keys[i].index = i;
+    }
+  sort_by_keys(fns, keys, sort_key_comp());
 }
 
 /// Return the public decl table of the global variables of the
@@ -1609,13 +1621,39 @@ corpus::get_variables() const
 
 /// Sort the set of variables exported by this corpus.
 ///
+/// Two variables are compared by their linkage names or, if either of
+/// them doesn't have a linkage name, by their pretty representations.
+///
 /// Normally, you shouldn't be calling this as the code that creates
 /// the corpus for you should do it for you too.
 void
 corpus::sort_variables()
 {
-  var_comp vc;
-  std::sort(priv_->vars.begin(), priv_->vars.end(), vc);
+  variables& vars = priv_->vars;
+  vector<sort_key> keys(vars.size());
+  bool need_pretty_representations = false;
+  for (size_t i = 0; i < vars.size(); ++i)
+    {
+      keys[i].key = &vars[i]->get_linkage_name();
+      keys[i].index = i;
+      if (keys[i].key->empty())
+	need_pretty_representations = true;
+    }
+
+  if (!need_pretty_representations)
+    {
+      sort_by_keys(vars, keys, sort_key_comp());
+      return;
+    }
+
+  vector<string> pretty_representations(vars.size());
+  for (size_t i = 0; i < vars.size(); ++i)
+    {
+      pretty_representations[i] = vars[i]->get_pretty_representation();
+      assert(!pretty_representations[i].empty());
+      keys[i].fallback_key = &pretty_representations[i];
+    }
+  sort_by_keys(vars, keys, sort_key_with_fallback_comp());
 }
 
 /// Getter of the set of function symbols that are not referenced by
@@ -1804,6 +1842,288 @@ corpus::maybe_drop_some_exported_decls()
   priv_->vars = vars_to_keep;
 }
 
+/// The set of the declarations of a corpus that are reachable from
+/// its exported functions and variables.
+///
+/// This is the "type closure" of the exported declarations: the
+/// declarations of all the types that an exported function or
+/// variable refers to, directly or indirectly, along with the
+/// declarations (e.g, the classes) that contain them.
+class reachable_decls_set
+{
+  typedef unordered_map<const decl_base*, bool> decl_ptr_map;
+
+  decl_ptr_map			reached_;
+  vector<const decl_base*>	to_walk_;
+
+public:
+  /// Test if a declaration is reachable.
+  ///
+  /// @param d the declaration to consider.
+  ///
+  /// @return true iff @p d has been reached.
+  bool
+  contains(const decl_base* d) const
+  {return reached_.find(d) != reached_.end();}
+
+  /// Mark a declaration as reachable, along with its enclosing
+  /// declarations that are not namespaces.  The declarations it
+  /// refers to are reached later, by reachable_decls_set::walk().
+  ///
+  /// @param d the declaration to mark.
+  void
+  reach(const decl_base* d)
+  {
+    if (!d || contains(d))
+      return;
+    reached_[d] = true;
+    to_walk_.push_back(d);
+
+    // A member type is emitted as part of its class, so the class
+    // must be kept as well.  So must be a template which pattern is
+    // reached.
+    const scope_decl* s = d->get_scope();
+    if (s
+	&& !dynamic_cast<const namespace_decl*>(s)
+	&& !dynamic_cast<const global_scope*>(s))
+      reach(s);
+  }
+
+  /// Mark the declaration of a type as reachable.
+  ///
+  /// Function types have no declaration, so the types they refer to
+  /// are reached instead.
+  ///
+  /// @param t the type to consider.
+  void
+  reach(const type_base_sptr& t)
+  {
+    if (!t)
+      return;
+
+    if (decl_base* d = get_type_declaration(t.get()))
+      reach(d);
+    else if (function_type* f = dynamic_cast<function_type*>(t.get()))
+      {
+	reach(f->get_return_type());
+	for (function_type::parameters::const_iterator p =
+	       f->get_parameters().begin();
+	     p != f->get_parameters().end();
+	     ++p)
+	  reach((*p)->get_type());
+      }
+  }
+
+  /// Mark as reachable the declarations referred to by the
+  /// parameters of a template.
+  ///
+  /// @param t the template to consider.
+  void
+  reach_template_parameters(const template_decl& t)
+  {
+    for (std::list<template_parameter_sptr>::const_iterator p =
+	   t.get_template_parameters().begin();
+	 p != t.get_template_parameters().end();
+	 ++p)
+      if (type_composition* c = dynamic_cast<type_composition*>(p->get()))
+	reach(c->get_composed_type());
+  }
+
+  /// Mark as reachable the declarations that a class refers to.
+  ///
+  /// As a class is emitted along with all its members, all the
+  /// types its members refer to are reachable.
+  ///
+  /// @param c the class to consider.
+  void
+  reach_class_members(const class_decl& c)
+  {
+    reach(c.get_definition_of_declaration().get());
+    reach(c.get_earlier_declaration().get());
+
+    for (class_decl::base_specs::const_iterator b =
+	   c.get_base_specifiers().begin();
+	 b != c.get_base_specifiers().end();
+	 ++b)
+      reach((*b)->get_base_class().get());
+
+    for (class_decl::member_types::const_iterator t =
+	   c.get_member_types().begin();
+	 t != c.get_member_types().end();
+	 ++t)
+      reach(*t);
+
+    for (class_decl::data_members::const_iterator m =
+	   c.get_data_members().begin();
+	 m != c.get_data_members().end();
+	 ++m)
+      reach((*m)->get_type());
+
+    for (class_decl::member_functions::const_iterator m =
+	   c.get_member_functions().begin();
+	 m != c.get_member_functions().end();
+	 ++m)
+      reach((*m)->get_type());
+
+    for (class_decl::member_function_templates::const_iterator m =
+	   c.get_member_function_templates().begin();
+	 m != c.get_member_function_templates().end();
+	 ++m)
+      reach((*m)->as_function_tdecl().get());
+
+    for (class_decl::member_class_templates::const_iterator m =
+	   c.get_member_class_templates().begin();
+	 m != c.get_member_class_templates().end();
+	 ++m)
+      reach((*m)->as_class_tdecl().get());
+  }
+
+  /// Mark as reachable the declarations that the declarations
+  /// reached so far refer to, until there are no more of them.
+  void
+  walk()
+  {
+    while (!to_walk_.empty())
+      {
+	const decl_base* d = to_walk_.back();
+	to_walk_.pop_back();
+
+	if (const class_decl* c = dynamic_cast<const class_decl*>(d))
+	  reach_class_members(*c);
+	else if (const pointer_type_def* p =
+		 dynamic_cast<const pointer_type_def*>(d))
+	  reach(p->get_pointed_to_type());
+	else if (const reference_type_def* r =
+		 dynamic_cast<const reference_type_def*>(d))
+	  reach(r->get_pointed_to_type());
+	else if (const qualified_type_def* q =
+		 dynamic_cast<const qualified_type_def*>(d))
+	  reach(q->get_underlying_type());
+	else if (const typedef_decl* t = dynamic_cast<const typedef_decl*>(d))
+	  reach(t->get_underlying_type());
+	else if (const array_type_def* a =
+		 dynamic_cast<const array_type_def*>(d))
+	  reach(a->get_element_type());
+	else if (const enum_type_decl* e =
+		 dynamic_cast<const enum_type_decl*>(d))
+	  reach(e->get_underlying_type());
+	else if (const function_decl* f =
+		 dynamic_cast<const function_decl*>(d))
+	  reach(f->get_type());
+	else if (const var_decl* v = dynamic_cast<const var_decl*>(d))
+	  reach(v->get_type());
+	else if (const function_tdecl* f =
+		 dynamic_cast<const function_tdecl*>(d))
+	  {
+	    reach_template_parameters(*f);
+	    reach(f->get_pattern().get());
+	  }
+	else if (const class_tdecl* c = dynamic_cast<const class_tdecl*>(d))
+	  {
+	    reach_template_parameters(*c);
+	    reach(c->get_pattern().get());
+	  }
+      }
+  }
+}; // end class reachable_decls_set
+
+/// Remove the members of a namespace (or global) scope that are not
+/// in a set of reachable declarations.
+///
+/// Nested namespaces are pruned recursively, and removed if they end
+/// up empty.
+///
+/// @param scope the scope to prune.
+///
+/// @param reachable the set of reachable declarations.
+///
+/// @return the number of declarations removed from @p scope and from
+/// its nested namespaces.
+static size_t
+prune_scope(scope_decl& scope, const reachable_decls_set& reachable)
+{
+  size_t num_removed = 0;
+  scope_decl::declarations kept;
+  for (scope_decl::declarations::const_iterator i =
+	 scope.get_member_decls().begin();
+       i != scope.get_member_decls().end();
+       ++i)
+    {
+      if (namespace_decl* n = dynamic_cast<namespace_decl*>(i->get()))
+	{
+	  bool was_empty = n->is_empty();
+	  num_removed += prune_scope(*n, reachable);
+	  if (was_empty || !n->is_empty())
+	    kept.push_back(*i);
+	  else
+	    ++num_removed;
+	}
+      else if (reachable.contains(i->get()))
+	kept.push_back(*i);
+      else
+	++num_removed;
+    }
+
+  if (num_removed == 0)
+    return 0;
+
+  scope_decl::scopes kept_scopes;
+  for (scope_decl::scopes::const_iterator i =
+	 scope.get_member_scopes().begin();
+       i != scope.get_member_scopes().end();
+       ++i)
+    if (dynamic_cast<namespace_decl*>(i->get())
+	? std::find(kept.begin(), kept.end(), *i) != kept.end()
+	: reachable.contains(i->get()))
+      kept_scopes.push_back(*i);
+
+  scope.get_member_decls().swap(kept);
+  scope.get_member_scopes().swap(kept_scopes);
+  return num_removed;
+}
+
+/// Remove, from the translation units of the corpus, the declarations
+/// that are not reachable from the exported functions and variables.
+///
+/// The exported functions and variables are those that remain after
+/// corpus::maybe_drop_some_exported_decls() applied the tunables of
+/// the corpus.  The types they refer to, directly or indirectly, are
+/// their "type closure".  The other types, along with the functions
+/// and variables that are not exported, are removed from the
+/// namespaces of the translation units.  Note that the members of
+/// the classes that are kept are kept as well.
+///
+/// This works the same for corpora read from ELF/DWARF and from the
+/// native XML format.  It makes the XML representation of the corpus
+/// smaller, as well as the work that is needed to walk its
+/// translation units.
+///
+/// @return the number of declarations that got removed.
+size_t
+corpus::prune_unreachable_types()
+{
+  reachable_decls_set reachable;
+
+  for (functions::const_iterator f = get_functions().begin();
+       f != get_functions().end();
+       ++f)
+    reachable.reach(*f);
+  for (variables::const_iterator v = get_variables().begin();
+       v != get_variables().end();
+       ++v)
+    reachable.reach(*v);
+  reachable.walk();
+
+  size_t num_removed = 0;
+  for (translation_units::const_iterator tu =
+	 get_translation_units().begin();
+       tu != get_translation_units().end();
+       ++tu)
+    num_removed += prune_scope(*(*tu)->get_global_scope(), reachable);
+
+  return num_removed;
+}
+
 ///  Getter for the object that is responsible for determining what
 ///  decls ought to be in the set of exported decls.
 ///
@@ -30,20 +30,30 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <dirent.h>
 #include <libgen.h>
 #include <assert.h>
+#include <pthread.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <cmath>
+#include <algorithm>
 #include <elfutils/libdwfl.h>
 #include <dwarf.h>
 #include <tr1/unordered_map>
+#include <tr1/unordered_set>
 #include <stack>
 #include <deque>
 #include <list>
 #include <ostream>
+#include <fstream>
 #include <sstream>
 #include "abg-dwarf-reader.h"
 #include "abg-sptr-utils.h"
+#include "abg-tools-utils.h"
+#include "abg-workers.h"
 
 using std::string;
 
@@ -57,6 +67,7 @@ namespace dwarf_reader
 using std::tr1::dynamic_pointer_cast;
 using std::tr1::static_pointer_cast;
 using std::tr1::unordered_map;
+using std::tr1::unordered_set;
 using std::stack;
 using std::deque;
 using std::list;
@@ -91,13 +102,273 @@ typedef unordered_map<Dwarf_Off, class_decl_sptr> die_class_map_type;
 /// translation_unit_sptr.
 typedef unordered_map<Dwarf_Off, translation_unit_sptr> die_tu_map_type;
 
-/// Convenience typedef for a map which key is an elf address and
-/// which value is an elf_symbol_sptr.
-typedef unordered_map<GElf_Addr, elf_symbol_sptr> addr_elf_symbol_sptr_map_type;
+/// A compact record of a function or variable symbol of the ELF
+/// symbol table.
+///
+/// The name of the symbol points into the string table of the ELF
+/// file, so it's not copied.  It is thus valid as long as the ELF
+/// file is open.
+struct elf_symbol_record
+{
+  /// The kinds of symbols, which are also the kinds of the name ->
+  /// symbols maps of the corpus.  The order of the enumerators is
+  /// the order of the records in the name index of a @ref
+  /// elf_symbol_db.
+  enum kind
+  {
+    PUBLIC_FUNCTION_KIND,
+    PUBLIC_VARIABLE_KIND,
+    UNDEFINED_FUNCTION_KIND,
+    UNDEFINED_VARIABLE_KIND
+  };
+
+  size_t	index;
+  const char*	name;
+  GElf_Addr	value;
+  GElf_Versym	versym;
+  unsigned char	type;
+  unsigned char	binding;
+  bool		is_defined;
+  bool		is_function;
+
+  elf_symbol_record(size_t i, const char* n, const GElf_Sym& s)
+    : index(i),
+      name(n ? n : ""),
+      value(s.st_value),
+      versym(),
+      type(GELF_ST_TYPE(s.st_info)),
+      binding(GELF_ST_BIND(s.st_info)),
+      is_defined(s.st_shndx != SHN_UNDEF),
+      is_function(type == STT_FUNC || type == STT_GNU_IFUNC)
+  {}
+
+  /// @return true iff the symbol is defined and is visible outside
+  /// of the binary.  This mirrors elf_symbol::is_public().
+  bool
+  is_public() const
+  {
+    return (is_defined
+	    && (binding == STB_GLOBAL
+		|| binding == STB_WEAK
+		|| binding == STB_GNU_UNIQUE));
+  }
+
+  /// @return the kind of the symbol.  This must only be invoked on
+  /// symbols that are public or undefined.
+  kind
+  get_kind() const
+  {
+    if (is_defined)
+      return is_function ? PUBLIC_FUNCTION_KIND : PUBLIC_VARIABLE_KIND;
+    return is_function ? UNDEFINED_FUNCTION_KIND : UNDEFINED_VARIABLE_KIND;
+  }
+};// end struct elf_symbol_record
+
+/// A compact database of the public and undefined function and
+/// variable symbols of an ELF symbol table.
+///
+/// The symbol table is scanned once into a contiguous array of @ref
+/// elf_symbol_record, and then one instance of @ref elf_symbol is
+/// built per record.  The records are reached through two kinds of
+/// sorted indexes:
+///
+///   - the name index is a vector of entries designating the
+///     records, sorted by kind of symbol, by hash of the name, by
+///     name and then by position in the symbol table.  Each run of
+///     records of that index with the same kind and name becomes one
+///     entry of one of the name -> symbols maps of the corpus; see
+///     read_context::load_symbol_maps().  Sorting by hash first
+///     spares most of the comparisons of names, which often share
+///     long prefixes.
+///
+///   - the address indexes are vectors of pairs of an address and a
+///     position in the array, for the public function and variable
+///     symbols, sorted by address.  An address appears at most once
+///     in an address index; the symbols sharing an address are
+///     aliases of the one that comes first in the symbol table.
+///
+/// The names of the records point into the string table of the ELF
+/// file.  Once the symbols are built, the records are dropped; the
+/// symbols and the address indexes stay for the lookups of symbols
+/// by address.
+class elf_symbol_db
+{
+public:
+  /// The type of the elements of the name index.
+  struct name_index_entry
+  {
+    elf_symbol_record::kind	kind;
+    // The GNU ELF hash of the name.
+    GElf_Word			name_hash;
+    const char*			name;
+    // The position of the record in the array.
+    size_t			position;
+
+    bool
+    operator<(const name_index_entry& o) const
+    {
+      if (kind != o.kind)
+	return kind < o.kind;
+      if (name_hash != o.name_hash)
+	return name_hash < o.name_hash;
+      if (int c = strcmp(name, o.name))
+	return c < 0;
+      return position < o.position;
+    }
+
+    /// @return true iff the current entry designates a symbol of
+    /// the same kind and name as @p o.
+    bool
+    same_kind_and_name(const name_index_entry& o) const
+    {
+      return (kind == o.kind
+	      && name_hash == o.name_hash
+	      && strcmp(name, o.name) == 0);
+    }
+  };// end struct name_index_entry
+
+  /// The type of the elements of the address indexes.
+  typedef std::pair<GElf_Addr, size_t> address_index_entry;
+
+private:
+  vector<elf_symbol_record>	records_;
+  // The symbol built for each record.
+  vector<elf_symbol_sptr>	symbols_;
+  vector<address_index_entry>	fun_addr_index_;
+  vector<address_index_entry>	var_addr_index_;
+
+  /// A functor that tests if the address of an entry of an address
+  /// index is lower than a given address.  It's used to search the
+  /// address indexes.
+  struct address_lower_than
+  {
+    bool
+    operator()(const address_index_entry& l, GElf_Addr r) const
+    {return l.first < r;}
+  };// end struct address_lower_than
+
+  /// Sort an address index and remove the records which address is
+  /// duplicated.
+  ///
+  /// The symbols of the removed records are added as aliases of the
+  /// symbol of the first record that has the same address.
+  ///
+  /// @param index the address index to sort.
+  void
+  sort_and_alias_by_address(vector<address_index_entry>& index)
+  {
+    if (index.empty())
+      return;
 
-/// Convenience typedef for a shared pointer to an
-/// addr_elf_symbol_sptr_map_type.
-typedef shared_ptr<addr_elf_symbol_sptr_map_type> addr_elf_symbol_sptr_map_sptr;
+    // The entries are pairs of an address and a position, so this
+    // sorts them by address and then by position.
+    std::sort(index.begin(), index.end());
+
+    vector<address_index_entry>::iterator last = index.begin();
+    for (vector<address_index_entry>::iterator i = index.begin() + 1;
+	 i != index.end();
+	 ++i)
+      if (i->first == last->first)
+	symbols_[last->second]->get_main_symbol()->
+	  add_alias(symbols_[i->second].get());
+      else
+	*++last = *i;
+    index.erase(last + 1, index.end());
+  }
+
+  /// Find the symbol at a given address in an address index.
+  ///
+  /// @param index the address index to search.
+  ///
+  /// @param addr the address to look for.
+  ///
+  /// @return the symbol found at @p addr, or nil if none was found.
+  elf_symbol_sptr
+  lookup_by_address(const vector<address_index_entry>& index,
+		    GElf_Addr addr) const
+  {
+    vector<address_index_entry>::const_iterator i =
+      std::lower_bound(index.begin(), index.end(), addr,
+		       address_lower_than());
+    if (i == index.end() || i->first != addr)
+      return elf_symbol_sptr();
+    return symbols_[i->second];
+  }
+
+public:
+
+  /// Getter for the records of the database.
+  ///
+  /// @return the records, in the order of the symbol table.
+  vector<elf_symbol_record>&
+  records()
+  {return records_;}
+
+  /// Getter for the symbols of the database.
+  ///
+  /// @return the symbols.  The n-th symbol is built from the n-th
+  /// record.
+  vector<elf_symbol_sptr>&
+  symbols()
+  {return symbols_;}
+
+  /// Build the name index of the records.
+  ///
+  /// @param index output parameter.  The name index.
+  void
+  build_name_index(vector<name_index_entry>& index) const
+  {
+    index.resize(records_.size());
+    for (size_t i = 0; i < index.size(); ++i)
+      {
+	index[i].kind = records_[i].get_kind();
+	index[i].name_hash = elf_gnu_hash(records_[i].name);
+	index[i].name = records_[i].name;
+	index[i].position = i;
+      }
+    std::sort(index.begin(), index.end());
+  }
+
+  /// Build the address indexes of the public function and variable
+  /// records, and make the symbols sharing an address aliases of one
+  /// another.  Then drop the records.
+  ///
+  /// This must be invoked once all the symbols are built.
+  void
+  build_address_indexes()
+  {
+    for (size_t i = 0; i < records_.size(); ++i)
+      if (records_[i].is_public())
+	(records_[i].is_function
+	 ? fun_addr_index_
+	 : var_addr_index_).push_back(std::make_pair(records_[i].value, i));
+
+    sort_and_alias_by_address(fun_addr_index_);
+    sort_and_alias_by_address(var_addr_index_);
+
+    vector<elf_symbol_record>().swap(records_);
+  }
+
+  /// Find the public function symbol at a given address.
+  ///
+  /// @param addr the address to look for.
+  ///
+  /// @return the main symbol found at @p addr, or nil if none was
+  /// found.
+  elf_symbol_sptr
+  lookup_function_by_address(GElf_Addr addr) const
+  {return lookup_by_address(fun_addr_index_, addr);}
+
+  /// Find the public variable symbol at a given address.
+  ///
+  /// @param addr the address to look for.
+  ///
+  /// @return the main symbol found at @p addr, or nil if none was
+  /// found.
+  elf_symbol_sptr
+  lookup_variable_by_address(GElf_Addr addr) const
+  {return lookup_by_address(var_addr_index_, addr);}
+};// end class elf_symbol_db
 
 /// Convenience typedef for a stack containing the scopes up to the
 /// current point in the abigail Internal Representation (aka IR) tree
@@ -108,10 +379,35 @@ typedef stack<scope_decl*> scope_stack_type;
 /// value is also a dwarf offset.
 typedef unordered_map<Dwarf_Off, Dwarf_Off> offset_offset_map;
 
+/// Convenience typedef for a set of DIE offsets.
+typedef unordered_set<Dwarf_Off> offset_set;
+
+/// Convenience typedef for a set of pointers to types.
+typedef unordered_set<const type_base*> type_ptr_set_type;
+
 /// Convenience typedef for a map which key is a string and which
 /// value is a vector of smart pointer to a class.
 typedef unordered_map<string, classes_type> string_classes_map;
 
+/// The IR nodes built from a class DIE and from its children.  They
+/// are associated to the DIEs of the classes that have the same
+/// fingerprint, instead of building new IR nodes for these.
+struct deduplicated_class
+{
+  class_decl_sptr		klass;
+  // The decl built from each child DIE, in order, or nil if no decl
+  // was built from the child.  The children of the member classes
+  // come right after the DIE of their class, recursively.
+  vector<decl_base_sptr>	member_decls;
+  // Likewise, the type built from each child DIE.
+  vector<type_base_sptr>	member_types;
+};
+
+/// Convenience typedef for a map which key is the fingerprint of a
+/// class DIE, as computed by die_class_fingerprint(), and which value
+/// is the IR nodes built from the first class DIE that had it.
+typedef unordered_map<string, deduplicated_class> class_fingerprint_map_type;
+
 static bool
 find_symbol_table_section(Elf* elf_handle, Elf_Scn*& section);
 
@@ -139,6 +435,10 @@ maybe_canonicalize_type(Dwarf_Off	die_offset,
 			bool		in_alt_di,
 			read_context&	ctxt);
 
+static void
+build_die_parent_relations_under(Dwarf_Die*		die,
+				 offset_offset_map&	die_parent_map);
+
 /// Convert an elf symbol type (given by the ELF{32,64}_ST_TYPE
 /// macros) into an elf_symbol::type value.
 ///
@@ -673,41 +973,896 @@ find_bss_section(Elf* elf_handle)
 /// @param load_address the address where the binary is loaded.  This
 /// is set by the function iff it returns true.
 ///
-/// @return true if the function could get the binary load address
-/// and assign @p load_address to it.
-static bool
-get_binary_load_address(Elf *elf_handle,
-			GElf_Addr &load_address)
+/// @return true if the function could get the binary load address
+/// and assign @p load_address to it.
+static bool
+get_binary_load_address(Elf *elf_handle,
+			GElf_Addr &load_address)
+{
+  GElf_Ehdr eh_mem;
+  GElf_Ehdr *elf_header = gelf_getehdr(elf_handle, &eh_mem);
+  size_t num_segments = elf_header->e_phnum;
+
+  for (unsigned i = 0; i < num_segments; ++i)
+    {
+      GElf_Phdr ph_mem;
+      GElf_Phdr *program_header =gelf_getphdr(elf_handle, i, &ph_mem);
+      if (program_header->p_type == PT_LOAD
+	  && program_header->p_offset == 0)
+	{
+	  // This program header represent the segment containing the
+	  // first byte of this binary.  We want to return the address
+	  // at which the segment is loaded in memory.
+	  load_address = program_header->p_vaddr;
+	  return true;
+	}
+    }
+  return false;
+}
+
+// <build_id_index stuff>
+
+/// The name of the file, at the root of a debug info directory, that
+/// contains the index built by build_debug_info_index().
+static const char* debug_info_index_file_name = ".abigail-debug-info-index";
+
+/// The first line of the file of a debug info index.
+static const char* debug_info_index_header = "# libabigail debug info index 1";
+
+/// Convert a build id to the string of its hexadecimal digits.
+///
+/// @param bits the bytes of the build id.
+///
+/// @param len the number of bytes of the build id.
+///
+/// @return the resulting string.
+static string
+build_id_to_string(const unsigned char* bits, size_t len)
+{
+  static const char digits[] = "0123456789abcdef";
+  string result;
+  result.reserve(2 * len);
+  for (size_t i = 0; i < len; ++i)
+    {
+      result += digits[bits[i] >> 4];
+      result += digits[bits[i] & 0xf];
+    }
+  return result;
+}
+
+/// Get the build id of an ELF file, as found in its
+/// NT_GNU_BUILD_ID note.
+///
+/// @param elf the ELF file to consider.
+///
+/// @param build_id output parameter.  This is set to the hexadecimal
+/// digits of the build id, iff the function returns true.
+///
+/// @param has_debug_info output parameter.  If non-nil, this is set
+/// to true iff @p elf has a .debug_info section.
+///
+/// @return true iff the build id of @p elf was found.
+static bool
+get_elf_build_id(Elf* elf, string& build_id, bool* has_debug_info)
+{
+  if (has_debug_info)
+    *has_debug_info = false;
+
+  // Whether the .debug_info section is still to be looked for.
+  size_t section_names_index = 0;
+  bool look_for_debug_info =
+    has_debug_info && !elf_getshdrstrndx(elf, &section_names_index);
+
+  bool found = false;
+  Elf_Scn* section = 0;
+  while ((!found || look_for_debug_info)
+	 && (section = elf_nextscn(elf, section)) != 0)
+    {
+      GElf_Shdr header_mem, *header = gelf_getshdr(section, &header_mem);
+      if (!header)
+	continue;
+
+      if (look_for_debug_info && header->sh_type == SHT_PROGBITS)
+	{
+	  const char* name = elf_strptr(elf, section_names_index,
+					header->sh_name);
+	  if (name && !strcmp(name, ".debug_info"))
+	    {
+	      *has_debug_info = true;
+	      look_for_debug_info = false;
+	    }
+	  continue;
+	}
+
+      if (found || header->sh_type != SHT_NOTE)
+	continue;
+
+      Elf_Data* data = elf_getdata(section, 0);
+      if (!data)
+	continue;
+
+      GElf_Nhdr note;
+      size_t name_offset = 0, desc_offset = 0;
+      for (size_t offset = 0;
+	   (offset = gelf_getnote(data, offset, &note,
+				  &name_offset, &desc_offset)) != 0;)
+	if (note.n_type == NT_GNU_BUILD_ID
+	    && note.n_namesz == sizeof(ELF_NOTE_GNU)
+	    && !memcmp(static_cast<char*>(data->d_buf) + name_offset,
+		       ELF_NOTE_GNU, sizeof(ELF_NOTE_GNU))
+	    && note.n_descsz != 0)
+	  {
+	    build_id = build_id_to_string
+	      (static_cast<unsigned char*>(data->d_buf) + desc_offset,
+	       note.n_descsz);
+	    found = true;
+	    break;
+	  }
+    }
+  return found;
+}
+
+/// Get the build id of the ELF file that is at a given path.
+///
+/// @param path the path to the file to consider.
+///
+/// @param build_id output parameter.  This is set to the hexadecimal
+/// digits of the build id, iff the function returns true.
+///
+/// @param has_debug_info output parameter.  If non-nil, this is set
+/// to true iff the file has a .debug_info section.
+///
+/// @return true iff the file at @p path is an ELF file which build id
+/// was found.
+static bool
+get_elf_build_id(const string& path, string& build_id, bool* has_debug_info)
+{
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  bool result = false;
+  if (Elf* elf = elf_begin(fd, ELF_C_READ_MMAP, 0))
+    {
+      if (elf_kind(elf) == ELF_K_ELF)
+	result = get_elf_build_id(elf, build_id, has_debug_info);
+      elf_end(elf);
+    }
+  close(fd);
+  return result;
+}
+
+/// An index of the ELF files found under a debug info root
+/// directory, keyed by their build id.
+///
+/// It is built by build_debug_info_index() and stored in a file at
+/// the root of the directory.  The DWARF reader then looks up the
+/// separate debug info files -- and the alternate debug info files --
+/// in the index before letting elfutils search the directory for
+/// them.  This helps when the directory holds a lot of debug info
+/// files that are not laid out as elfutils expects, e.g. without a
+/// .build-id sub-directory.
+class build_id_index
+{
+  string			root_;
+  unordered_map<string, string>	paths_;
+
+  // Forbid this.
+  build_id_index();
+
+  /// Add the ELF files that contain debug info, found under a
+  /// sub-directory of the root directory, to the index.
+  ///
+  /// Symbolic links are not followed.  So the .build-id
+  /// sub-directory, which only contains symbolic links, is not
+  /// walked, and loops are avoided.
+  ///
+  /// @param rel_dir the path of the sub-directory, relative to the
+  /// root directory.  It's either empty or ends with a '/'.
+  void
+  add_dir(const string& rel_dir)
+  {
+    DIR* dir = opendir((root_ + "/" + rel_dir).c_str());
+    if (!dir)
+      return;
+
+    while (struct dirent* entry = readdir(dir))
+      {
+	string name = entry->d_name;
+	if (name == "." || name == ".."
+	    || name == debug_info_index_file_name
+	    || name.find('\n') != string::npos)
+	  continue;
+
+	string rel_path = rel_dir + name, build_id;
+	bool has_debug_info = false;
+	struct stat st;
+	if (lstat((root_ + "/" + rel_path).c_str(), &st))
+	  continue;
+	if (S_ISDIR(st.st_mode))
+	  add_dir(rel_path + "/");
+	else if (S_ISREG(st.st_mode)
+		 && get_elf_build_id(root_ + "/" + rel_path, build_id,
+				     &has_debug_info)
+		 && has_debug_info)
+	  paths_.insert(std::make_pair(build_id, rel_path));
+      }
+    closedir(dir);
+  }
+
+public:
+
+  /// Constructor of @ref build_id_index.
+  ///
+  /// @param root the root directory of the debug info.
+  build_id_index(const string& root)
+    : root_(root)
+  {}
+
+  /// @return the path to the file of the index.
+  string
+  get_file_path() const
+  {return root_ + "/" + debug_info_index_file_name;}
+
+  /// Build the index by walking the root directory.
+  void
+  build()
+  {
+    paths_.clear();
+    add_dir("");
+  }
+
+  /// Load the index from its file.
+  ///
+  /// @return true iff the file of the index could be read.
+  bool
+  load()
+  {
+    std::ifstream in(get_file_path().c_str());
+    string line;
+    if (!std::getline(in, line) || line != debug_info_index_header)
+      return false;
+
+    while (std::getline(in, line))
+      {
+	string::size_type space = line.find(' ');
+	if (space == string::npos || space == 0)
+	  return false;
+	paths_.insert(std::make_pair(line.substr(0, space),
+				     line.substr(space + 1)));
+      }
+    return in.eof();
+  }
+
+  /// Write the index to its file.
+  ///
+  /// @return true upon successful completion.
+  bool
+  write() const
+  {
+    string path = get_file_path(), tmp_path = path + ".tmp";
+    std::ofstream out(tmp_path.c_str());
+    out << debug_info_index_header << "\n";
+    for (unordered_map<string, string>::const_iterator i = paths_.begin();
+	 i != paths_.end();
+	 ++i)
+      out << i->first << " " << i->second << "\n";
+    out.close();
+    if (!out.good() || rename(tmp_path.c_str(), path.c_str()))
+      {
+	unlink(tmp_path.c_str());
+	return false;
+      }
+    return true;
+  }
+
+  /// @return the number of files in the index.
+  size_t
+  size() const
+  {return paths_.size();}
+
+  /// Open the ELF file that has a given build id.
+  ///
+  /// As the index may be out of date, the build id of the file found
+  /// in the index is checked.
+  ///
+  /// @param build_id the hexadecimal digits of the build id to
+  /// consider.
+  ///
+  /// @param path output parameter.  This is set to the path of the
+  /// file, iff the function returns a file descriptor.
+  ///
+  /// @return the file descriptor of the opened file, or -1 if no file
+  /// with build id @p build_id was found.
+  int
+  open_file(const string& build_id, string& path) const
+  {
+    unordered_map<string, string>::const_iterator i = paths_.find(build_id);
+    if (i == paths_.end())
+      return -1;
+
+    string p = root_ + "/" + i->second, actual_build_id;
+    if (!get_elf_build_id(p, actual_build_id, /*has_debug_info=*/0)
+	|| actual_build_id != build_id)
+      return -1;
+
+    int fd = open(p.c_str(), O_RDONLY);
+    if (fd >= 0)
+      path = p;
+    return fd;
+  }
+};// end class build_id_index
+
+/// Convenience typedef for a shared pointer to a @ref
+/// build_id_index.
+typedef shared_ptr<build_id_index> build_id_index_sptr;
+
+/// Get the index of a debug info root directory.
+///
+/// The index is loaded from its file the first time it's requested.
+/// It then stays in memory until the program exits.
+///
+/// @param debug_info_root_path a pointer to the root path of the
+/// debug info.
+///
+/// @return the index, or nil if there is no debug info root path or
+/// if no index was built for it.
+static build_id_index*
+get_debug_info_index(char** debug_info_root_path)
+{
+  if (!debug_info_root_path || !*debug_info_root_path)
+    return 0;
+
+  static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+  static unordered_map<string, build_id_index_sptr> indexes;
+
+  string root = *debug_info_root_path;
+  pthread_mutex_lock(&lock);
+  unordered_map<string, build_id_index_sptr>::const_iterator i =
+    indexes.find(root);
+  if (i == indexes.end())
+    {
+      build_id_index_sptr index(new build_id_index(root));
+      if (!index->load())
+	index.reset();
+      i = indexes.insert(std::make_pair(root, index)).first;
+    }
+  build_id_index* result = i->second.get();
+  pthread_mutex_unlock(&lock);
+
+  return result;
+}
+
+/// Get the index of debug info attached to an elf module by the
+/// read_context::load_debug_info() function.
+///
+/// @param user_data the user data of the elf module.
+///
+/// @return the index, or nil if there is none.
+static const build_id_index*
+get_debug_info_index(void** user_data)
+{
+  if (!user_data)
+    return 0;
+  return static_cast<const build_id_index*>(*user_data);
+}
+
+/// The function that elfutils invokes to find the separate debug
+/// info file of an elf module.
+///
+/// It looks up the debug info file in the index of the debug info
+/// root directory, if there is one, and otherwise falls back to
+/// dwfl_standard_find_debuginfo().  Its parameters are those of
+/// dwfl_standard_find_debuginfo().
+///
+/// @return the file descriptor of the debug info file, or a
+/// negative value if it wasn't found.
+static int
+find_debug_info(Dwfl_Module*	elf_module,
+		void**		user_data,
+		const char*	module_name,
+		Dwarf_Addr	base,
+		const char*	file_name,
+		const char*	debuglink_file,
+		GElf_Word	debuglink_crc,
+		char**		debug_info_file_name)
+{
+  if (const build_id_index* index = get_debug_info_index(user_data))
+    {
+      const unsigned char* bits = 0;
+      GElf_Addr vaddr = 0;
+      int len = dwfl_module_build_id(elf_module, &bits, &vaddr);
+      string path;
+      int fd = len > 0
+	? index->open_file(build_id_to_string(bits, len), path)
+	: -1;
+      if (fd >= 0)
+	{
+	  *debug_info_file_name = strdup(path.c_str());
+	  return fd;
+	}
+    }
+
+  return dwfl_standard_find_debuginfo(elf_module, user_data, module_name,
+				      base, file_name, debuglink_file,
+				      debuglink_crc, debug_info_file_name);
+}
+
+// </build_id_index stuff>
+
+// <alt_debug_info stuff>
+
+/// Test if a type built from the alternate debug info can be shared
+/// by the corpora of all the binaries that refer to the alternate
+/// debug info file, and collect the types it's made of.
+///
+/// A type can be shared if it's canonicalized, if it's declared at
+/// namespace scope and if it says nothing that is specific to the
+/// binary it was read from.  So the classes that have member
+/// functions or static data members are not shared, as these members
+/// carry the ELF symbols of that binary.  Declaration-only classes
+/// are not shared either, as they are resolved to the definitions
+/// found in that binary; nor are the classes that have member types
+/// or member templates.  A type made of a type that can't be shared
+/// can't be shared.
+///
+/// @param t the type to consider.
+///
+/// @param shareable the types that are already known to be
+/// shareable.  They are not collected again.
+///
+/// @param visited the types visited so far.
+///
+/// @param closure output parameter.  The types @p t is made of,
+/// including @p t itself, that are not in @p shareable.
+///
+/// @return true iff @p t can be shared.
+static bool
+collect_shareable_types(const type_base_sptr&		t,
+			const type_ptr_set_type&	shareable,
+			type_ptr_set_type&		visited,
+			vector<type_base_sptr>&	closure)
+{
+  if (!t)
+    return false;
+
+  if (shareable.find(t.get()) != shareable.end()
+      || !visited.insert(t.get()).second)
+    return true;
+
+  if (!t->get_canonical_type())
+    return false;
+
+  if (decl_base* d = get_type_declaration(t.get()))
+    for (scope_decl* s = d->get_scope();
+	 s && !is_global_scope(s);
+	 s = s->get_scope())
+      if (!dynamic_cast<namespace_decl*>(s))
+	return false;
+
+  closure.push_back(t);
+
+  if (is_type_decl(t))
+    return true;
+
+  if (pointer_type_def_sptr p = is_pointer_type(t))
+    return collect_shareable_types(p->get_pointed_to_type(),
+				   shareable, visited, closure);
+
+  if (reference_type_def_sptr r = is_reference_type(t))
+    return collect_shareable_types(r->get_pointed_to_type(),
+				   shareable, visited, closure);
+
+  if (qualified_type_def_sptr q = is_qualified_type(t))
+    return collect_shareable_types(q->get_underlying_type(),
+				   shareable, visited, closure);
+
+  if (typedef_decl_sptr d = is_typedef(t))
+    return collect_shareable_types(d->get_underlying_type(),
+				   shareable, visited, closure);
+
+  if (enum_type_decl_sptr e = is_enum_type(t))
+    return collect_shareable_types(e->get_underlying_type(),
+				   shareable, visited, closure);
+
+  if (array_type_def_sptr a = is_array_type(t))
+    return collect_shareable_types(a->get_element_type(),
+				   shareable, visited, closure);
+
+  if (function_type_sptr f = is_function_type(t))
+    {
+      if (!collect_shareable_types(f->get_return_type(),
+				   shareable, visited, closure))
+	return false;
+      for (function_decl::parameters::const_iterator p =
+	     f->get_parameters().begin();
+	   p != f->get_parameters().end();
+	   ++p)
+	if (!collect_shareable_types((*p)->get_type(),
+				     shareable, visited, closure))
+	  return false;
+      return true;
+    }
+
+  if (class_decl_sptr c = is_class_type(t))
+    {
+      if (c->get_is_declaration_only()
+	  || !c->get_member_functions().empty()
+	  || !c->get_member_types().empty()
+	  || !c->get_member_function_templates().empty()
+	  || !c->get_member_class_templates().empty())
+	return false;
+
+      for (class_decl::base_specs::const_iterator b =
+	     c->get_base_specifiers().begin();
+	   b != c->get_base_specifiers().end();
+	   ++b)
+	if (!collect_shareable_types((*b)->get_base_class(),
+				     shareable, visited, closure))
+	  return false;
+
+      for (class_decl::data_members::const_iterator m =
+	     c->get_data_members().begin();
+	   m != c->get_data_members().end();
+	   ++m)
+	if (get_member_is_static(*m)
+	    || !collect_shareable_types((*m)->get_type(),
+					shareable, visited, closure))
+	  return false;
+      return true;
+    }
+
+  return false;
+}
+
+/// An alternate debug info file, as shared by all the read contexts
+/// of the process that read binaries referring to it.
+///
+/// Distributions use dwz to factorize the debug info of the binaries
+/// of a package into one alternate debug info file, so it's common to
+/// read many binaries referring to the same alternate debug info.
+/// The file is thus searched for and opened only once, and its DIE
+/// -> parent map, which is built by walking all its DIEs, is built
+/// only once too.
+///
+/// As a libdw handle is not meant to be used by several threads at
+/// once, each read context gets a handle on the file that it uses
+/// exclusively.  Handles are given back to the pool of the file when
+/// the read context is destroyed, for the next read context to use.
+///
+/// The types built from the DIEs of the file are shared too.  Once a
+/// read context is done building and canonicalizing a corpus, it
+/// hands the types it built from the alternate debug info over to
+/// share_types().  The read contexts that come next look these types
+/// up with lookup_shared_decl() and lookup_shared_type() rather than
+/// building them again.  The translation units that own the shared
+/// types are kept alive, and the abixml writer serializes the shared
+/// types a corpus refers to in the translation units of that corpus.
+/// Only the types that are not specific to a binary are shared; see
+/// collect_shareable_types().
+///
+/// Note that "alternate debug info sections" is a GNU extension as
+/// of DWARF4 and is described at
+/// http://www.dwarfstd.org/ShowIssue.php?issue=120604.1
+class alt_debug_info
+{
+  string		path_;
+  pthread_mutex_t	lock_;
+  // The handles that no read context is using.
+  vector<Dwarf*>	idle_dwarfs_;
+  offset_offset_map	die_parent_map_;
+  bool			die_parent_map_built_;
+  // The IR nodes shared by the read contexts, and the DIEs they were
+  // built from.
+  die_decl_map_type	shared_decls_;
+  die_type_map_type	shared_types_;
+  // The types that the shared types are made of.
+  type_ptr_set_type	shared_type_parts_;
+  // The translation units that own the shared types.
+  unordered_set<const translation_unit*> translation_units_set_;
+  translation_units	translation_units_;
+  // A translation unit that just keeps the shared function types
+  // alive, as they are owned by no scope.
+  translation_unit_sptr	function_types_;
+
+  /// A DIE which type is to be shared, and the range of the types it
+  /// is made of in the vector of types handed to share_types().
+  struct shared_die
+  {
+    Dwarf_Off		offset;
+    decl_base_sptr	decl;
+    type_base_sptr	type;
+    size_t		first_part;
+    size_t		last_part;
+  };
+
+  alt_debug_info();
+  alt_debug_info(const alt_debug_info&);
+
+public:
+
+  /// Constructor of @ref alt_debug_info.
+  ///
+  /// @param path the path to the alternate debug info file.
+  ///
+  /// @param dwarf a handle on the file, which becomes the first
+  /// handle of the pool.
+  alt_debug_info(const string& path, Dwarf* dwarf)
+    : path_(path),
+      die_parent_map_built_(),
+      function_types_(new translation_unit(path))
+  {
+    pthread_mutex_init(&lock_, 0);
+    idle_dwarfs_.push_back(dwarf);
+  }
+
+  /// Getter of the path to the alternate debug info file.
+  ///
+  /// @return the path.
+  const string&
+  path() const
+  {return path_;}
+
+  /// Get a handle on the alternate debug info file, for the exclusive
+  /// use of the caller, until it gives it back with release_dwarf().
+  ///
+  /// @return the handle, or nil if the file could not be opened.
+  Dwarf*
+  acquire_dwarf()
+  {
+    Dwarf* result = 0;
+    pthread_mutex_lock(&lock_);
+    if (!idle_dwarfs_.empty())
+      {
+	result = idle_dwarfs_.back();
+	idle_dwarfs_.pop_back();
+      }
+    pthread_mutex_unlock(&lock_);
+
+    if (!result)
+      {
+	int fd = open(path_.c_str(), O_RDONLY);
+	if (fd >= 0 && !(result = dwarf_begin(fd, DWARF_C_READ)))
+	  close(fd);
+      }
+
+    return result;
+  }
+
+  /// Give back a handle that was returned by acquire_dwarf().
+  ///
+  /// @param dwarf the handle to give back.
+  void
+  release_dwarf(Dwarf* dwarf)
+  {
+    pthread_mutex_lock(&lock_);
+    idle_dwarfs_.push_back(dwarf);
+    pthread_mutex_unlock(&lock_);
+  }
+
+  /// Get the map that associates each DIE of the alternate debug info
+  /// to its parent DIE.
+  ///
+  /// The map is built the first time it's requested.  It's not
+  /// modified afterwards, so several threads can look it up at once.
+  ///
+  /// @param dwarf the handle to walk the DIEs with, if the map is to
+  /// be built.  It must have been returned by acquire_dwarf().
+  ///
+  /// @return the DIE -> parent map.
+  const offset_offset_map&
+  die_parent_map(Dwarf* dwarf)
+  {
+    pthread_mutex_lock(&lock_);
+    if (!die_parent_map_built_)
+      {
+	uint8_t address_size = 0;
+	size_t header_size = 0;
+	for (Dwarf_Off offset = 0, next_offset = 0;
+	     (dwarf_next_unit(dwarf, offset, &next_offset, &header_size,
+			      NULL, NULL, &address_size, NULL, NULL, NULL) == 0);
+	     offset = next_offset)
+	  {
+	    Dwarf_Die unit;
+	    if (dwarf_offdie(dwarf, offset + header_size, &unit))
+	      build_die_parent_relations_under(&unit, die_parent_map_);
+	  }
+	die_parent_map_built_ = true;
+      }
+    pthread_mutex_unlock(&lock_);
+    return die_parent_map_;
+  }
+
+  /// Look up the shared decl built from a given DIE.
+  ///
+  /// @param die_offset the offset of the DIE to consider.
+  ///
+  /// @return the decl, or nil if no decl built from the DIE is
+  /// shared.
+  decl_base_sptr
+  lookup_shared_decl(Dwarf_Off die_offset)
+  {
+    decl_base_sptr result;
+    pthread_mutex_lock(&lock_);
+    die_decl_map_type::const_iterator i = shared_decls_.find(die_offset);
+    if (i != shared_decls_.end())
+      result = i->second;
+    pthread_mutex_unlock(&lock_);
+    return result;
+  }
+
+  /// Look up the shared type built from a given DIE.
+  ///
+  /// @param die_offset the offset of the DIE to consider.
+  ///
+  /// @return the type, or nil if no type built from the DIE is
+  /// shared.
+  type_base_sptr
+  lookup_shared_type(Dwarf_Off die_offset)
+  {
+    type_base_sptr result;
+    pthread_mutex_lock(&lock_);
+    die_type_map_type::const_iterator i = shared_types_.find(die_offset);
+    if (i != shared_types_.end())
+      result = i->second;
+    pthread_mutex_unlock(&lock_);
+    return result;
+  }
+
+  /// Share the types that a read context built from the DIEs of the
+  /// alternate debug info with the read contexts that come next.
+  ///
+  /// The types that can't be shared, and the DIEs which type is
+  /// already shared, are ignored.  The properties of the shared types
+  /// that are computed lazily are computed here, as the types may
+  /// then be used by several threads at once.
+  ///
+  /// @param decls the DIE -> decl map of the read context, for the
+  /// DIEs of the alternate debug info.
+  ///
+  /// @param types the DIE -> type map of the read context, for the
+  /// DIEs of the alternate debug info.
+  ///
+  /// @param tus the translation units of the corpus built by the
+  /// read context.
+  void
+  share_types(const die_decl_map_type&	decls,
+	      const die_type_map_type&	types,
+	      const translation_units&	tus)
+  {
+    vector<shared_die> dies;
+    vector<type_base_sptr> parts;
+    type_ptr_set_type shareable;
+    decl_base_sptr void_type = type_decl::get_void_type_decl();
+
+    for (die_type_map_type::const_iterator t = types.begin();
+	 t != types.end();
+	 ++t)
+      {
+	die_decl_map_type::const_iterator d = decls.find(t->first);
+	if (d == decls.end()
+	    || d->second == void_type
+	    || get_type_declaration(t->second.get()) != d->second.get())
+	  continue;
+
+	type_ptr_set_type visited;
+	size_t first_part = parts.size();
+	if (!collect_shareable_types(t->second, shareable, visited, parts))
+	  {
+	    parts.resize(first_part);
+	    continue;
+	  }
+
+	for (size_t i = first_part; i < parts.size(); ++i)
+	  {
+	    shareable.insert(parts[i].get());
+	    if (decl_base* decl = get_type_declaration(parts[i].get()))
+	      {
+		decl->get_qualified_name();
+		decl->get_hash();
+	      }
+	  }
+	shared_die s = {t->first, d->second, t->second,
+			first_part, parts.size()};
+	dies.push_back(s);
+      }
+
+    unordered_map<const translation_unit*, translation_unit_sptr> tu_map;
+    for (translation_units::const_iterator i = tus.begin();
+	 i != tus.end();
+	 ++i)
+      tu_map[i->get()] = *i;
+
+    pthread_mutex_lock(&lock_);
+    for (vector<shared_die>::const_iterator s = dies.begin();
+	 s != dies.end();
+	 ++s)
+      {
+	if (!shared_types_.insert(std::make_pair(s->offset, s->type)).second)
+	  continue;
+	shared_decls_[s->offset] = s->decl;
+
+	for (size_t i = s->first_part; i < s->last_part; ++i)
+	  {
+	    const type_base_sptr& part = parts[i];
+	    if (!shared_type_parts_.insert(part.get()).second)
+	      continue;
+	    if (function_type_sptr f = is_function_type(part))
+	      function_types_->bind_function_type_life_time(f);
+	    else
+	      {
+		unordered_map<const translation_unit*,
+			      translation_unit_sptr>::const_iterator tu =
+		  tu_map.find(get_translation_unit(get_type_declaration
+						   (part.get())));
+		if (tu != tu_map.end()
+		    && translation_units_set_.insert(tu->first).second)
+		  translation_units_.push_back(tu->second);
+	      }
+	  }
+      }
+    pthread_mutex_unlock(&lock_);
+  }
+};// end class alt_debug_info
+
+/// Convenience typedef for a shared pointer to a @ref
+/// alt_debug_info.
+typedef shared_ptr<alt_debug_info> alt_debug_info_sptr;
+
+/// Look up an alternate debug info file among those that were opened
+/// so far by the process, or add it to them.
+///
+/// The alternate debug info files stay open until the program exits.
+///
+/// @param build_id the build id of the alternate debug info file, as
+/// a string of hexadecimal digits.
+///
+/// @param path the path to the alternate debug info file.  This is
+/// used only if @p fd is valid.
+///
+/// @param fd a file descriptor on the alternate debug info file, or
+/// a negative value to only look the file up.  If the file is not
+/// added, then @p fd is closed.
+///
+/// @return the alternate debug info file, or nil if it's not found.
+static alt_debug_info_sptr
+get_alt_debug_info(const string& build_id, const string& path, int fd)
 {
-  GElf_Ehdr eh_mem;
-  GElf_Ehdr *elf_header = gelf_getehdr(elf_handle, &eh_mem);
-  size_t num_segments = elf_header->e_phnum;
-
-  for (unsigned i = 0; i < num_segments; ++i)
+  static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+  static unordered_map<string, alt_debug_info_sptr> alt_debug_infos;
+
+  alt_debug_info_sptr result;
+  pthread_mutex_lock(&lock);
+  unordered_map<string, alt_debug_info_sptr>::const_iterator i =
+    alt_debug_infos.find(build_id);
+  if (i != alt_debug_infos.end())
+    result = i->second;
+  else if (fd >= 0)
     {
-      GElf_Phdr ph_mem;
-      GElf_Phdr *program_header =gelf_getphdr(elf_handle, i, &ph_mem);
-      if (program_header->p_type == PT_LOAD
-	  && program_header->p_offset == 0)
+      if (Dwarf* dwarf = dwarf_begin(fd, DWARF_C_READ))
 	{
-	  // This program header represent the segment containing the
-	  // first byte of this binary.  We want to return the address
-	  // at which the segment is loaded in memory.
-	  load_address = program_header->p_vaddr;
-	  return true;
+	  result.reset(new alt_debug_info(path, dwarf));
+	  alt_debug_infos[build_id] = result;
+	  fd = -1;
 	}
     }
-  return false;
+  pthread_mutex_unlock(&lock);
+
+  if (fd >= 0)
+    close(fd);
+
+  return result;
 }
 
+// </alt_debug_info stuff>
+
 /// Return the alternate debug info associated to a given main debug
 /// info file.
 ///
-/// @param elf_module the elf module to consider.
+/// If the alternate debug info file was already opened by the
+/// process, it's not searched for again.
 ///
-/// @param alt_file_name output parameter.  This is set to the file
-/// path of the alternate debug info file associated to @p elf_module.
-/// This is set iff the function returns a non-null result.
+/// @param elf_module the elf module to consider.
 ///
 /// Note that the alternate debug info file is a DWARF extension as of
 /// DWARF 4 ans is decribed at
@@ -715,12 +1870,11 @@ get_binary_load_address(Elf *elf_handle,
 ///
 /// @return the alternate debuginfo, or null
 ///
-static Dwarf*
-find_alt_debug_info(Dwfl_Module *elf_module,
-		    string& alt_file_name)
+static alt_debug_info_sptr
+find_alt_debug_info(Dwfl_Module *elf_module)
 {
   if (elf_module == 0)
-    return 0;
+    return alt_debug_info_sptr();
 
   GElf_Addr bias = 0;
   Elf *elf = dwarf_getelf(dwfl_module_getdwarf(elf_module, &bias));
@@ -753,7 +1907,7 @@ find_alt_debug_info(Dwfl_Module *elf_module,
 		(char *) memchr(alt_name, '\0', data->d_size);
 	      build_id_len = data->d_size - (end_of_alt_name - alt_name + 1);
 	      if (build_id_len == 0)
-		return 0;
+		return alt_debug_info_sptr();
 	      build_id = end_of_alt_name + 1;
 	    }
 	}
@@ -761,7 +1915,14 @@ find_alt_debug_info(Dwfl_Module *elf_module,
 	continue;
 
       if (build_id == 0 || alt_name == 0)
-	return 0;
+	return alt_debug_info_sptr();
+
+      string build_id_str =
+	build_id_to_string(reinterpret_cast<unsigned char*>(build_id),
+			   build_id_len);
+      if (alt_debug_info_sptr result =
+	  get_alt_debug_info(build_id_str, "", -1))
+	return result;
 
       const char *file_name = 0;
       void **user_data = 0;
@@ -771,19 +1932,28 @@ find_alt_debug_info(Dwfl_Module *elf_module,
       file_name = dwfl_module_info(elf_module, &user_data,
 				   &low_addr, 0, 0, 0, 0, 0);
 
-      int alt_fd = dwfl_standard_find_debuginfo(elf_module, user_data,
-						file_name, low_addr,
-						alt_name, file_name,
-						0, &alt_file);
+      int alt_fd = -1;
+      if (const build_id_index* index = get_debug_info_index(user_data))
+	{
+	  string path;
+	  alt_fd = index->open_file(build_id_str, path);
+	  if (alt_fd >= 0)
+	    alt_file = strdup(path.c_str());
+	}
+      if (alt_fd < 0)
+	alt_fd = dwfl_standard_find_debuginfo(elf_module, user_data,
+					      file_name, low_addr,
+					      alt_name, file_name,
+					      0, &alt_file);
 
-      Dwarf *result = dwarf_begin(alt_fd, DWARF_C_READ);
-      if (alt_file)
-	alt_file_name = alt_file;
+      alt_debug_info_sptr result =
+	get_alt_debug_info(build_id_str, alt_file ? alt_file : "", alt_fd);
+      free(alt_file);
 
       return result;
     }
 
-  return 0;
+  return alt_debug_info_sptr();
 }
 
 /// Compare a symbol name against another name, possibly demangling
@@ -1717,7 +2887,11 @@ class read_context
   // DWARF extension as of DWARF4 and are described at
   // http://www.dwarfstd.org/ShowIssue.php?issue=120604.1.
   Dwarf*			alt_dwarf_;
-  string			alt_debug_info_path_;
+  // The alternate debug info file alt_dwarf_ is a handle on.  It's
+  // shared by all the read contexts of binaries that refer to it.
+  alt_debug_info_sptr		alt_debug_info_;
+  // The index of the debug info root directory, if any.
+  build_id_index*		debug_info_index_;
   // The address range of the offline elf file we are looking at.
   Dwfl_Module*			elf_module_;
   mutable Elf*			elf_handle_;
@@ -1743,6 +2917,12 @@ class read_context
   die_class_map_type		die_wip_classes_map_;
   vector<Dwarf_Off>		types_to_canonicalize_;
   vector<Dwarf_Off>		alt_types_to_canonicalize_;
+  // If this is true, the types are not canonicalized while the debug
+  // info is read; they are recorded in deferred_types_to_canonicalize_
+  // instead, in the order in which canonicalization is attempted.
+  bool				defer_type_canonicalization_;
+  vector<type_base_sptr>	deferred_types_to_canonicalize_;
+  bool				void_type_is_in_cur_tu_;
   string_classes_map		decl_only_classes_map_;
   die_tu_map_type		die_tu_map_;
   corpus_sptr			cur_corpus_;
@@ -1750,8 +2930,23 @@ class read_context
   scope_stack_type		scope_stack_;
   offset_offset_map		die_parent_map_;
   // A DIE -> parent map for DIEs coming from the alternate debug info
-  // file.
-  offset_offset_map		alternate_die_parent_map_;
+  // file.  It's owned by alt_debug_info_.
+  const offset_offset_map*	alternate_die_parent_map_;
+  // If this is true, the DIE -> decl, DIE -> type and DIE -> parent
+  // maps of the main debug info are purged from the DIEs of each
+  // compile unit once it's read.  Only the DIEs that can be referred
+  // to from other units are kept.
+  bool				bounded_memory_;
+  // The DIEs of the compile units of the main debug info that are
+  // referred to from other units, along with their ancestors.
+  offset_set			cross_unit_dies_;
+  // The types of the main debug info that are scheduled for late
+  // canonicalization, and which DIEs might have been purged.
+  vector<type_base_sptr>	purged_types_to_canonicalize_;
+  // If this is true, the IR of the complete classes of the main debug
+  // info is built once per class fingerprint.
+  bool				deduplicate_types_;
+  class_fingerprint_map_type	class_fingerprint_map_;
   list<var_decl_sptr>		var_decls_to_add_;
   Elf_Scn*			symtab_section_;
   bool				symbol_versionning_sections_loaded_;
@@ -1759,9 +2954,9 @@ class read_context
   Elf_Scn*			versym_section_;
   Elf_Scn*			verdef_section_;
   Elf_Scn*			verneed_section_;
-  addr_elf_symbol_sptr_map_sptr fun_addr_sym_map_;
+  bool				symbol_maps_loaded_;
+  elf_symbol_db			symbol_db_;
   string_elf_symbols_map_sptr	fun_syms_;
-  addr_elf_symbol_sptr_map_sptr var_addr_sym_map_;
   string_elf_symbols_map_sptr	var_syms_;
   string_elf_symbols_map_sptr	undefined_fun_syms_;
   string_elf_symbols_map_sptr	undefined_var_syms_;
@@ -1780,20 +2975,37 @@ public:
       handle_(handle),
       dwarf_(0),
       alt_dwarf_(0),
+      debug_info_index_(0),
       elf_module_(0),
       elf_handle_(0),
       elf_path_(elf_path),
       cur_tu_die_(0),
+      defer_type_canonicalization_(),
+      void_type_is_in_cur_tu_(),
+      alternate_die_parent_map_(),
+      bounded_memory_(),
+      deduplicate_types_(),
       symtab_section_(),
       symbol_versionning_sections_loaded_(),
       symbol_versionning_sections_found_(),
       versym_section_(),
       verdef_section_(),
       verneed_section_(),
+      symbol_maps_loaded_(),
       exported_decls_builder_(),
       load_all_types_()
   {}
 
+  /// Destructor of @ref read_context.
+  ///
+  /// It gives the handle on the alternate debug info back to the
+  /// alternate debug info file, for other read contexts to use.
+  ~read_context()
+  {
+    if (alt_debug_info_ && alt_dwarf_)
+      alt_debug_info_->release_dwarf(alt_dwarf_);
+  }
+
   /// Clear the data that is relevant only for the current translation
   /// unit being read.  The rest of the data is relevant for the
   /// entire ABI corpus.
@@ -1803,7 +3015,7 @@ public:
     while (!scope_stack().empty())
       scope_stack().pop();
     var_decls_to_re_add_to_tree().clear();
-    type_decl::get_void_type_decl()->set_scope(0);
+    void_type_is_in_cur_tu_ = false;
   }
 
   /// Clear the data that is relevant for the current corpus being
@@ -1817,6 +3029,9 @@ public:
     die_type_map(/*in_alt_di=*/false).clear();
     types_to_canonicalize(/*in_alt_di=*/true).clear();
     types_to_canonicalize(/*in_alt_di=*/false).clear();
+    purged_types_to_canonicalize_.clear();
+    cross_unit_dies_.clear();
+    class_fingerprint_map_.clear();
   }
 
   unsigned short
@@ -1835,6 +3050,15 @@ public:
   elf_module() const
   {return elf_module_;}
 
+  /// Setter of the index of the debug info root directory, in which
+  /// the debug info files are looked up before elfutils searches for
+  /// them.
+  ///
+  /// @param index the new index, or nil if there is none.
+  void
+  debug_info_index(build_id_index* index)
+  {debug_info_index_ = index;}
+
   /// Return the ELF descriptor for the binary we are analizing.
   ///
   /// @return a pointer to the Elf descriptor representing the binary
@@ -1898,10 +3122,22 @@ public:
 			  -1);
     dwfl_report_end(dwfl_handle().get(), 0, 0);
 
+    if (elf_module_ && debug_info_index_)
+      {
+	// Let find_debug_info() and find_alt_debug_info() get the
+	// index from the user data of the module.
+	void** user_data = 0;
+	dwfl_module_info(elf_module_, &user_data, 0, 0, 0, 0, 0, 0);
+	if (user_data)
+	  *user_data = debug_info_index_;
+      }
+
     Dwarf_Addr bias = 0;
 
     dwarf_ = dwfl_module_getdwarf(elf_module_, &bias);
-    alt_dwarf_ = find_alt_debug_info(elf_module_, alt_debug_info_path_);
+    alt_debug_info_ = find_alt_debug_info(elf_module_);
+    if (alt_debug_info_)
+      alt_dwarf_ = alt_debug_info_->acquire_dwarf();
 
     return dwarf_;
   }
@@ -1935,7 +3171,10 @@ public:
   /// path if no alternate debug info file is associated.
   const string&
   alt_debug_info_path() const
-  {return alt_debug_info_path_;}
+  {
+    static const string empty_path;
+    return alt_debug_info_ ? alt_debug_info_->path() : empty_path;
+  }
 
   const string&
   elf_path() const
@@ -2065,6 +3304,10 @@ public:
   /// Lookup the decl for a given DIE.  This works on DIEs that come
   /// from the alternate debug info sections.
   ///
+  /// If no decl was built from the DIE by this context, the decl
+  /// shared by the contexts that read the same alternate debug info
+  /// file is looked up; see alt_debug_info::share_types().
+  ///
   /// Note that "alternate debug info sections" is a GNU extension as
   /// of DWARF4 and is described at
   /// http://www.dwarfstd.org/ShowIssue.php?issue=120604.1
@@ -2078,9 +3321,53 @@ public:
   {
     die_decl_map_type::const_iterator it =
       alternate_die_decl_map().find(die_offset);
-    if (it == alternate_die_decl_map().end())
-      return decl_base_sptr();
-    return it->second;
+    if (it != alternate_die_decl_map().end())
+      return it->second;
+    if (load_shared_alternate_type(die_offset))
+      return alternate_die_decl_map()[die_offset];
+    return decl_base_sptr();
+  }
+
+  /// Load the decl and the type that the contexts reading the same
+  /// alternate debug info file share for a given DIE of that file,
+  /// into the die -> decl and die -> type maps of this context.
+  ///
+  /// @param die_offset the offset of the DIE to consider.
+  ///
+  /// @return true iff a shared type was found for the DIE.
+  bool
+  load_shared_alternate_type(size_t die_offset)
+  {
+    if (!alt_debug_info_)
+      return false;
+
+    type_base_sptr t = alt_debug_info_->lookup_shared_type(die_offset);
+    if (!t)
+      return false;
+
+    alternate_die_type_map_[die_offset] = t;
+    alternate_die_decl_map()[die_offset] =
+      alt_debug_info_->lookup_shared_decl(die_offset);
+    return true;
+  }
+
+  /// Share the types built from the alternate debug info by this
+  /// context with the contexts that come next and read the same
+  /// alternate debug info file.
+  ///
+  /// This must be called once the types of the current corpus are
+  /// canonicalized, as only canonicalized types are shared.
+  void
+  share_alternate_types()
+  {
+    if (!alt_debug_info_
+	|| type_canonicalization_is_deferred()
+	|| !current_corpus())
+      return;
+
+    alt_debug_info_->share_types(alternate_die_decl_map(),
+				 alternate_die_type_map_,
+				 current_corpus()->get_translation_units());
   }
 
   /// Lookup the decl for a given DIE.
@@ -2163,6 +3450,8 @@ public:
 
     if (i != m.end())
       result = i->second;
+    else if (in_alt_die && load_shared_alternate_type(die_offset))
+      result = m[die_offset];
     return result;
   }
 
@@ -2366,6 +3655,13 @@ public:
   void
   canonicalize_types_scheduled(bool in_alt_di)
   {
+    if (!in_alt_di)
+      for (vector<type_base_sptr>::const_iterator i =
+	     purged_types_to_canonicalize_.begin();
+	   i != purged_types_to_canonicalize_.end();
+	   ++i)
+	canonicalize_type_scheduled(*i);
+
     if (!types_to_canonicalize(in_alt_di).empty())
       {
 	for (vector<Dwarf_Off>::iterator i =
@@ -2375,12 +3671,25 @@ public:
 	  {
 	    type_base_sptr t = lookup_type_from_die_offset(*i, in_alt_di);
 	    assert(t);
-	    if (!type_has_non_canonicalized_subtype(t))
-	      canonicalize(t);
+	    canonicalize_type_scheduled(t);
 	  }
       }
   }
 
+  /// Canonicalize a type that was scheduled for late
+  /// canonicalization.  This is a sub-routine of
+  /// read_context::canonicalize_types_scheduled().
+  ///
+  /// @param t the type to canonicalize.
+  void
+  canonicalize_type_scheduled(const type_base_sptr& t)
+  {
+    if (type_canonicalization_is_deferred())
+      deferred_types_to_canonicalize_.push_back(t);
+    else if (!type_has_non_canonicalized_subtype(t))
+      canonicalize(t);
+  }
+
   // Look at the types that need to be canonicalized after the
   // translation unit has been constructed and canonicalize them.
   void
@@ -2390,6 +3699,64 @@ public:
     canonicalize_types_scheduled(/*in_alt_di=*/true);
   }
 
+  /// Setter of the flag that says if the canonicalization of the
+  /// types built from the debug info is deferred.
+  ///
+  /// When it's deferred, no type is canonicalized while the debug
+  /// info is read, so that several contexts can read debug info
+  /// concurrently.  The types are then canonicalized by
+  /// canonicalize_deferred_types(), once the reading is done.
+  ///
+  /// @param f the new value of the flag.
+  void
+  defer_type_canonicalization(bool f)
+  {defer_type_canonicalization_ = f;}
+
+  /// Getter of the flag that says if the canonicalization of the
+  /// types built from the debug info is deferred.
+  ///
+  /// @return the flag.
+  bool
+  type_canonicalization_is_deferred() const
+  {return defer_type_canonicalization_;}
+
+  /// Getter of the types which canonicalization was deferred, in the
+  /// order in which it was attempted.
+  ///
+  /// @return the vector of types.
+  vector<type_base_sptr>&
+  deferred_types_to_canonicalize()
+  {return deferred_types_to_canonicalize_;}
+
+  /// Canonicalize a type, or record it for later canonicalization if
+  /// the canonicalization of types is deferred.
+  ///
+  /// @param t the type to canonicalize.
+  void
+  canonicalize_type(const type_base_sptr& t)
+  {
+    if (type_canonicalization_is_deferred())
+      deferred_types_to_canonicalize_.push_back(t);
+    else
+      canonicalize(t);
+  }
+
+  /// Getter of the flag that says if the void type has been added to
+  /// the current translation unit.
+  ///
+  /// @return the flag.
+  bool
+  void_type_is_in_cur_tu() const
+  {return void_type_is_in_cur_tu_;}
+
+  /// Setter of the flag that says if the void type has been added to
+  /// the current translation unit.
+  ///
+  /// @param f the new value of the flag.
+  void
+  void_type_is_in_cur_tu(bool f)
+  {void_type_is_in_cur_tu_ = f;}
+
   const die_tu_map_type&
   die_tu_map() const
   {return die_tu_map_;}
@@ -2440,22 +3807,257 @@ public:
   /// of DWARF4 and is described at
   /// http://www.dwarfstd.org/ShowIssue.php?issue=120604.1
   ///
+  /// The map is shared by all the read contexts of binaries that
+  /// refer to the same alternate debug info file.  It must have been
+  /// loaded by load_alternate_die_parent_map().
+  ///
   /// @return the DIE -> parent map.
   const offset_offset_map&
   alternate_die_parent_map() const
-  {return alternate_die_parent_map_;}
+  {
+    assert(alternate_die_parent_map_);
+    return *alternate_die_parent_map_;
+  }
 
-  /// Get the map that associates each DIE coming from the alternate
-  /// debug info sections to its parent DIE.
+  /// Load the map that associates each DIE coming from the alternate
+  /// debug info sections to its parent DIE, if there is an alternate
+  /// debug info.
   ///
-  /// Note that "alternate debug info sections" is a GNU extension as
-  /// of DWARF4 and is described at
-  /// http://www.dwarfstd.org/ShowIssue.php?issue=120604.1
+  /// The map is built by walking all the DIEs of the alternate debug
+  /// info, unless another read context did it already.
+  void
+  load_alternate_die_parent_map()
+  {
+    if (alt_debug_info_ && alt_dwarf_)
+      alternate_die_parent_map_ = &alt_debug_info_->die_parent_map(alt_dwarf_);
+  }
+
+  /// Setter of the flag that says if the memory used to read the
+  /// debug info is bounded.
   ///
-  /// @return the DIE -> parent map.
-  offset_offset_map&
-  alternate_die_parent_map()
-  {return alternate_die_parent_map_;}
+  /// When it is, the parent relations of the DIEs of a compile unit
+  /// of the main debug info are built just before the unit is read.
+  /// Once the unit is read, its DIEs are purged from the DIE -> decl,
+  /// DIE -> type and DIE -> parent maps, except for the DIEs that can
+  /// be referred to from other units.  The DIEs of the partial units
+  /// and of the alternate debug info are never purged.
+  ///
+  /// @param f the new value of the flag.
+  void
+  bounded_memory(bool f)
+  {bounded_memory_ = f;}
+
+  /// Getter of the flag that says if the memory used to read the
+  /// debug info is bounded.
+  ///
+  /// @return the flag.
+  bool
+  bounded_memory() const
+  {return bounded_memory_;}
+
+  /// Setter of the flag that says if the IR of the complete classes
+  /// of the main debug info is built once per class fingerprint.
+  ///
+  /// C++ compile units repeat the definitions of the classes they
+  /// use, so the same classes are otherwise built and canonicalized
+  /// once per compile unit.
+  ///
+  /// @param f the new value of the flag.
+  void
+  deduplicate_types(bool f)
+  {deduplicate_types_ = f;}
+
+  /// Getter of the flag that says if the IR of the complete classes
+  /// of the main debug info is built once per class fingerprint.
+  ///
+  /// @return the flag.
+  bool
+  deduplicate_types() const
+  {return deduplicate_types_;}
+
+  /// Look up the IR nodes built from a class DIE with a given
+  /// fingerprint.
+  ///
+  /// @param fingerprint the fingerprint computed by
+  /// die_class_fingerprint().
+  ///
+  /// @return the IR nodes, or nil if no class with that fingerprint
+  /// was built.
+  const deduplicated_class*
+  lookup_class_from_fingerprint(const string& fingerprint) const
+  {
+    class_fingerprint_map_type::const_iterator i =
+      class_fingerprint_map_.find(fingerprint);
+    if (i == class_fingerprint_map_.end())
+      return 0;
+    return &i->second;
+  }
+
+  /// Record the IR nodes built from a class DIE of the main debug
+  /// info, and from its children, for the classes that have the same
+  /// fingerprint to reuse them.
+  ///
+  /// @param fingerprint the fingerprint of @p die, computed by
+  /// die_class_fingerprint().
+  ///
+  /// @param die the class DIE to consider.
+  ///
+  /// @param klass the class built from @p die.
+  void
+  record_class_fingerprint(const string&		fingerprint,
+			   Dwarf_Die*			die,
+			   const class_decl_sptr&	klass)
+  {
+    deduplicated_class& c = class_fingerprint_map_[fingerprint];
+    c.klass = klass;
+    record_deduplicated_class_members(die, c);
+  }
+
+  /// Record the IR nodes built from the children of a class DIE, and
+  /// from the children of its member classes, recursively.
+  ///
+  /// @param die the class DIE to consider.
+  ///
+  /// @param c the deduplicated class to record the IR nodes in.
+  void
+  record_deduplicated_class_members(Dwarf_Die*		die,
+				    deduplicated_class&	c)
+  {
+    Dwarf_Die child;
+    if (dwarf_child(die, &child) != 0)
+      return;
+    do
+      {
+	Dwarf_Off o = dwarf_dieoffset(&child);
+	c.member_decls.push_back(lookup_decl_from_die_offset(o, false));
+	c.member_types.push_back(lookup_type_from_die_offset(o, false));
+	unsigned tag = dwarf_tag(&child);
+	if (tag == DW_TAG_class_type || tag == DW_TAG_structure_type)
+	  record_deduplicated_class_members(&child, c);
+      }
+    while (dwarf_siblingof(&child, &child) == 0);
+  }
+
+  /// Associate a class DIE of the main debug info, and its children,
+  /// to the IR nodes built from another class DIE with the same
+  /// fingerprint.
+  ///
+  /// @param die the class DIE to consider.
+  ///
+  /// @param c the IR nodes to associate to @p die and to its
+  /// children.
+  void
+  associate_die_to_deduplicated_class(Dwarf_Die*			die,
+				      const deduplicated_class&	c)
+  {
+    associate_die_to_type(dwarf_dieoffset(die), false, c.klass);
+    size_t i = 0;
+    associate_deduplicated_class_members(die, c, i);
+    assert(i == c.member_decls.size());
+  }
+
+  /// Associate the children of a class DIE of the main debug info,
+  /// and the children of its member classes, recursively, to the IR
+  /// nodes recorded by record_deduplicated_class_members().
+  ///
+  /// The children of member classes have to be associated too: the
+  /// definition of a member function of a member class, for
+  /// instance, refers to its declaration in the member class.
+  ///
+  /// @param die the class DIE to consider.
+  ///
+  /// @param c the IR nodes to associate to the children of @p die.
+  ///
+  /// @param i the index of the IR nodes of the first child of @p die
+  /// in @p c.  It's updated to the index of the IR nodes that come
+  /// after the children of @p die.
+  void
+  associate_deduplicated_class_members(Dwarf_Die*			die,
+				       const deduplicated_class&	c,
+				       size_t&				i)
+  {
+    Dwarf_Die child;
+    if (dwarf_child(die, &child) != 0)
+      return;
+    do
+      {
+	// The fingerprint of a class accounts for each of its
+	// children, and for the children of its member classes, so
+	// both classes have the same number of them.
+	assert(i < c.member_decls.size());
+	Dwarf_Off o = dwarf_dieoffset(&child);
+	if (c.member_decls[i])
+	  associate_die_to_decl(o, false, c.member_decls[i]);
+	if (c.member_types[i])
+	  associate_die_to_type(o, false, c.member_types[i]);
+	++i;
+	unsigned tag = dwarf_tag(&child);
+	if (tag == DW_TAG_class_type || tag == DW_TAG_structure_type)
+	  associate_deduplicated_class_members(&child, c, i);
+      }
+    while (dwarf_siblingof(&child, &child) == 0);
+  }
+
+  /// Getter of the set of the DIEs of the compile units of the main
+  /// debug info that can be referred to from other units, that is,
+  /// the targets of DW_FORM_ref_addr attributes and their ancestors.
+  ///
+  /// @return the set of DIE offsets.
+  offset_set&
+  cross_unit_dies()
+  {return cross_unit_dies_;}
+
+  /// Purge the DIEs of a compile unit of the main debug info from the
+  /// DIE -> decl, DIE -> type and DIE -> parent maps, once the unit
+  /// has been read.
+  ///
+  /// The DIEs that can be referred to from other units are kept.
+  /// The types that are scheduled for late canonicalization are
+  /// looked up before their DIEs are purged.
+  ///
+  /// @param unit the DW_TAG_compile_unit DIE to consider.
+  void
+  purge_unit_dies(Dwarf_Die* unit)
+  {
+    vector<Dwarf_Off>& scheduled = types_to_canonicalize(/*in_alt_di=*/false);
+    for (vector<Dwarf_Off>::const_iterator i = scheduled.begin();
+	 i != scheduled.end();
+	 ++i)
+      {
+	type_base_sptr t = lookup_type_from_die_offset(*i, /*in_alt_di=*/false);
+	assert(t);
+	purged_types_to_canonicalize_.push_back(t);
+      }
+    scheduled.clear();
+
+    purge_dies_under(unit);
+  }
+
+  /// Purge the descendants of a DIE of the main debug info from the
+  /// DIE -> decl, DIE -> type and DIE -> parent maps, except for those
+  /// that can be referred to from other units.
+  ///
+  /// @param die the DIE to consider.
+  void
+  purge_dies_under(Dwarf_Die* die)
+  {
+    Dwarf_Die child;
+    if (dwarf_child(die, &child) != 0)
+      return;
+
+    do
+      {
+	Dwarf_Off o = dwarf_dieoffset(&child);
+	if (cross_unit_dies_.find(o) == cross_unit_dies_.end())
+	  {
+	    die_decl_map_.erase(o);
+	    die_type_map_.erase(o);
+	    die_parent_map_.erase(o);
+	  }
+	purge_dies_under(&child);
+      }
+    while (dwarf_siblingof(&child, &child) == 0);
+  }
 
   const translation_unit_sptr
   current_translation_unit() const
@@ -2568,6 +4170,24 @@ public:
   get_version_for_symbol(size_t		symbol_index,
 			 bool			get_def_version,
 			 elf_symbol::version&	version)
+  {
+    GElf_Versym versym = 0;
+    if (!get_versym_for_symbol(symbol_index, versym))
+      return false;
+    return get_version_for_versym(versym, get_def_version, version);
+  }
+
+  /// Return the entry of the SHT_GNU_versym section for a symbol that
+  /// is at a given index in its SHT_SYMTAB section.
+  ///
+  /// @param symbol_index the index of the symbol to consider.
+  ///
+  /// @param versym output parameter.  The entry found.  This is set
+  /// iff the function returns true.
+  ///
+  /// @return true iff the entry was found.
+  bool
+  get_versym_for_symbol(size_t symbol_index, GElf_Versym& versym)
   {
     Elf_Scn *versym_section = NULL,
       *verdef_section = NULL,
@@ -2580,8 +4200,41 @@ public:
 
     Elf_Data* versym_data = elf_getdata(versym_section, NULL);
     GElf_Versym versym_mem;
-    GElf_Versym* versym = gelf_getversym(versym_data, symbol_index, &versym_mem);
-    if (versym == 0 || *versym <= 1)
+    GElf_Versym* v = gelf_getversym(versym_data, symbol_index, &versym_mem);
+    if (v == 0)
+      return false;
+    versym = *v;
+    return true;
+  }
+
+  /// Return the version designated by an entry of the SHT_GNU_versym
+  /// section.
+  ///
+  /// @param versym the entry to consider.
+  ///
+  /// @param get_def_version if this is true, the version is looked
+  /// for in a section of type SHT_GNU_verdef, as for defined symbols.
+  /// Otherwise, it's looked for in a section of type
+  /// SHT_GNU_verneed, as for undefined symbols.
+  ///
+  /// @param version the version found for @p versym.
+  ///
+  /// @return true iff a version was found for @p versym.
+  bool
+  get_version_for_versym(GElf_Versym		versym,
+			 bool			get_def_version,
+			 elf_symbol::version&	version)
+  {
+    Elf_Scn *versym_section = NULL,
+      *verdef_section = NULL,
+      *verneed_section = NULL;
+
+    if (!get_symbol_versionning_sections(versym_section,
+					 verdef_section,
+					 verneed_section))
+      return false;
+
+    if (versym <= 1)
       // I got these value from the code of readelf.c in elfutils.
       // Apparently, if the symbol version entry has these values, the
       // symbol must be discarded. This is not documented in the
@@ -2590,19 +4243,19 @@ public:
 
     if (get_def_version)
       {
-	if (*versym == 0x8001)
+	if (versym == 0x8001)
 	  // I got this value from the code of readelf.c in elfutils
 	  // too.  It's not really documented in the official
 	  // specification.
 	  return false;
 
-	if (get_version_definition_for_versym(elf_handle(), versym,
+	if (get_version_definition_for_versym(elf_handle(), &versym,
 					      verdef_section, version))
 	  return true;
       }
     else
       {
-	if (get_version_needed_for_versym(elf_handle(), versym,
+	if (get_version_needed_for_versym(elf_handle(), &versym,
 					  verneed_section, version))
 	  return true;
       }
@@ -2700,13 +4353,13 @@ public:
   lookup_elf_fn_symbol_from_address(GElf_Addr symbol_start_addr,
 				    elf_symbol& sym)
   {
-    addr_elf_symbol_sptr_map_type::const_iterator i,
-      nil = fun_addr_sym_map().end();
-
-    if ((i = fun_addr_sym_map().find(symbol_start_addr)) == nil)
+    maybe_load_symbol_maps();
+    elf_symbol_sptr s =
+      symbol_db_.lookup_function_by_address(symbol_start_addr);
+    if (!s)
       return false;
 
-    sym = *i->second;
+    sym = *s;
     return true;
   }
 
@@ -2740,13 +4393,13 @@ public:
   lookup_elf_var_symbol_from_address(GElf_Addr symbol_start_addr,
 				     elf_symbol& symbol)
   {
-    addr_elf_symbol_sptr_map_type::const_iterator i,
-      nil = var_addr_sym_map().end();
-
-    if ((i = var_addr_sym_map().find(symbol_start_addr)) == nil)
+    maybe_load_symbol_maps();
+    elf_symbol_sptr s =
+      symbol_db_.lookup_variable_by_address(symbol_start_addr);
+    if (!s)
       return false;
 
-    symbol = *i->second;
+    symbol = *s;
     return true;
   }
 
@@ -2803,50 +4456,6 @@ public:
 								syms);
   }
 
-  /// Getter for the map of function address -> symbol.
-  ///
-  /// @return the function address -> symbol map.
-  const addr_elf_symbol_sptr_map_sptr
-  fun_addr_sym_map_sptr() const
-  {
-    maybe_load_symbol_maps();
-    return fun_addr_sym_map_;
-  }
-
-  /// Getter for the map of function address -> symbol.
-  ///
-  /// @return the function address -> symbol map.
-  addr_elf_symbol_sptr_map_sptr
-  fun_addr_sym_map_sptr()
-  {
-    maybe_load_symbol_maps();
-    return fun_addr_sym_map_;
-  }
-
-  /// Getter for the map of function symbol address -> function symbol
-  /// index.
-  ///
-  /// @return the map.  Note that this initializes the map once when
-  /// its nedded.
-  const addr_elf_symbol_sptr_map_type&
-  fun_addr_sym_map() const
-  {
-    maybe_load_symbol_maps();
-    return *fun_addr_sym_map_;
-  }
-
-  /// Getter for the map of function symbol address -> function symbol
-  /// index.
-  ///
-  /// @return the map.  Note that this initializes the map once when
-  /// its nedded.
-  addr_elf_symbol_sptr_map_type&
-  fun_addr_sym_map()
-  {
-    maybe_load_symbol_maps();
-    return *fun_addr_sym_map_;
-  }
-
   /// Getter for the map of function symbols (name -> sym).
   ///
   /// @return a shared pointer to the map of function symbols.
@@ -3054,67 +4663,39 @@ public:
   bool
   current_elf_file_is_dso() const
   {
-    GElf_Ehdr eh_mem;
-    GElf_Ehdr* elf_header = gelf_getehdr(elf_handle(), &eh_mem);
-    return elf_header->e_type == ET_DYN;
-  }
-
-  /// Getter for the map of global variables symbol address -> global
-  /// variable symbol index.
-  ///
-  /// @return the map.  Note that this initializes the map once when
-  /// its nedded.
-  const addr_elf_symbol_sptr_map_type&
-  var_addr_sym_map() const
-  {
-    maybe_load_symbol_maps();
-    return *var_addr_sym_map_;
-  }
-
-  /// Getter for the map of global variables symbol address -> global
-  /// variable symbol index.
-  ///
-  /// @return the map.  Note that this initializes the map once when
-  /// its nedded.
-  addr_elf_symbol_sptr_map_type&
-  var_addr_sym_map()
-  {
-    maybe_load_symbol_maps();
-    return *var_addr_sym_map_;
+    GElf_Ehdr eh_mem;
+    GElf_Ehdr* elf_header = gelf_getehdr(elf_handle(), &eh_mem);
+    return elf_header->e_type == ET_DYN;
   }
 
   /// Load the maps of function symbol address -> function symbol,
   /// global variable symbol address -> variable symbol and also the
   /// maps of function and variable undefined symbols.
   ///
+  /// The symbol table is scanned once into the compact symbol
+  /// database of the context; see @ref elf_symbol_db.  Then the
+  /// records of the database are walked in the order of its name
+  /// index, building an instance of @ref elf_symbol per record, and
+  /// one entry of the name -> symbols maps per run of records of the
+  /// same kind and name.  The maps are sized up-front.  The versions
+  /// of the symbols are looked up once per distinct entry of the
+  /// SHT_GNU_versym section.
+  ///
+  /// The maps are loaded only once; subsequent invocations do
+  /// nothing.
+  ///
   /// @return true iff everything went fine.
   bool
   load_symbol_maps()
   {
-    bool load_fun_map = !fun_addr_sym_map_ || fun_addr_sym_map_->empty();
-    bool load_var_map = !var_addr_sym_map_ || var_addr_sym_map_->empty();
-    bool load_undefined_fun_map = (!undefined_fun_syms_
-				    || undefined_fun_syms_->empty());
-    bool load_undefined_var_map = (!undefined_var_syms_
-				   || undefined_var_syms_->empty());
-
-    if (!fun_syms_)
-      fun_syms_.reset(new string_elf_symbols_map_type);
-
-    if (!fun_addr_sym_map_)
-      fun_addr_sym_map_.reset(new addr_elf_symbol_sptr_map_type);
-
-    if (!var_syms_)
-      var_syms_.reset(new string_elf_symbols_map_type);
-
-    if (!var_addr_sym_map_)
-      var_addr_sym_map_.reset(new addr_elf_symbol_sptr_map_type);
-
-    if (!undefined_fun_syms_)
-      undefined_fun_syms_.reset(new string_elf_symbols_map_type);
+    if (symbol_maps_loaded_)
+      return true;
+    symbol_maps_loaded_ = true;
 
-    if (!undefined_var_syms_)
-      undefined_var_syms_.reset(new string_elf_symbols_map_type);
+    fun_syms_.reset(new string_elf_symbols_map_type);
+    var_syms_.reset(new string_elf_symbols_map_type);
+    undefined_fun_syms_.reset(new string_elf_symbols_map_type);
+    undefined_var_syms_.reset(new string_elf_symbols_map_type);
 
     Elf_Scn* symtab_section = find_symbol_table_section();
     assert(symtab_section);
@@ -3127,106 +4708,98 @@ public:
     Elf_Data* symtab = elf_getdata(symtab_section, 0);
     assert(symtab);
 
+    vector<elf_symbol_record>& records = symbol_db_.records();
+    records.reserve(nb_syms);
+    const int nb_kinds = elf_symbol_record::UNDEFINED_VARIABLE_KIND + 1;
+    size_t nb_syms_of_kind[nb_kinds] = {0, 0, 0, 0};
+
     for (size_t i = 0; i < nb_syms; ++i)
       {
 	GElf_Sym* sym, sym_mem;
 	sym = gelf_getsym(symtab, i, &sym_mem);
 	assert(sym);
 
-	if ((load_fun_map || load_undefined_fun_map)
-	    && (GELF_ST_TYPE(sym->st_info) == STT_FUNC
-		|| GELF_ST_TYPE(sym->st_info) == STT_GNU_IFUNC))
-	  {
-	    elf_symbol_sptr symbol(new elf_symbol);
-	    assert(lookup_elf_symbol_from_index(i, *symbol));
-	    assert(symbol->is_function());
+	unsigned char type = GELF_ST_TYPE(sym->st_info);
+	if (type != STT_FUNC
+	    && type != STT_GNU_IFUNC
+	    && type != STT_OBJECT
+	    && type != STT_TLS)
+	  continue;
 
+	// If the symbol is for an OBJECT, the index of the section it
+	// refers to cannot be absolute.  Otherwise that OBJECT is not
+	// a variable.
+	if (type == STT_OBJECT && sym->st_shndx == SHN_ABS)
+	  continue;
 
-	    if (load_fun_map && symbol->is_public())
-	      {
-		{
-		  string_elf_symbols_map_type::iterator it =
-		    fun_syms_->find(symbol->get_name());
-		  if (it == fun_syms_->end())
-		    {
-		      (*fun_syms_)[symbol->get_name()] = elf_symbols();
-		      it = fun_syms_->find(symbol->get_name());
-		    }
-		  string name = symbol->get_name();
-		  it->second.push_back(symbol);
-		}
+	elf_symbol_record r(i,
+			    elf_strptr(elf_handle(),
+				       symtab_sheader->sh_link,
+				       sym->st_name),
+			    *sym);
+	if (!r.is_public() && r.is_defined)
+	  continue;
+	get_versym_for_symbol(i, r.versym);
+	++nb_syms_of_kind[r.get_kind()];
+	records.push_back(r);
+      }
 
-		{
-		  addr_elf_symbol_sptr_map_type::const_iterator it =
-		    fun_addr_sym_map_->find(sym->st_value);
-		  if (it == fun_addr_sym_map_->end())
-		    (*fun_addr_sym_map_)[sym->st_value] = symbol;
-		  else
-		    it->second->get_main_symbol()->add_alias(symbol.get());
-		}
-	      }
-	    else if (load_undefined_fun_map && !symbol->is_defined())
-	      {
-		string_elf_symbols_map_type::iterator it =
-		  undefined_fun_syms_->find(symbol->get_name());
-		if (it == undefined_fun_syms_->end())
-		  {
-		    (*undefined_fun_syms_)[symbol->get_name()] = elf_symbols();
-		    it = undefined_fun_syms_->find(symbol->get_name());
-		  }
-		it->second.push_back(symbol);
-	      }
-	  }
-	else if ((load_var_map || load_undefined_var_map)
-		 && (GELF_ST_TYPE(sym->st_info) == STT_OBJECT
-		     || GELF_ST_TYPE(sym->st_info) == STT_TLS)
-		 // If the symbol is for an OBJECT, the index of the
-		 // section it refers to cannot be absolute.
-		 // Otherwise that OBJECT is not a variable.
-		 && (sym->st_shndx != SHN_ABS
-		     || GELF_ST_TYPE(sym->st_info) != STT_OBJECT ))
+    // The maps, in the order of the kinds of symbols.
+    string_elf_symbols_map_type* maps[nb_kinds] =
+      {fun_syms_.get(), var_syms_.get(),
+       undefined_fun_syms_.get(), undefined_var_syms_.get()};
+    for (int k = 0; k < nb_kinds; ++k)
+      maps[k]->rehash(nb_syms_of_kind[k]);
+
+    // The versions of the symbols, keyed by their entry in the
+    // SHT_GNU_versym section and by whether they are defined.
+    typedef unordered_map<size_t, elf_symbol::version> versym_version_map;
+    versym_version_map versions;
+
+    vector<elf_symbol_sptr>& symbols = symbol_db_.symbols();
+    symbols.resize(records.size());
+
+    typedef vector<elf_symbol_db::name_index_entry> name_index_type;
+    name_index_type name_index;
+    symbol_db_.build_name_index(name_index);
+
+    string name;
+    for (name_index_type::const_iterator b = name_index.begin(), e = b;
+	 b != name_index.end();
+	 b = e)
+      {
+	for (e = b + 1;
+	     e != name_index.end() && e->same_kind_and_name(*b);
+	     ++e)
+	  ;
+
+	name = b->name;
+	elf_symbols& syms = (*maps[b->kind])[name];
+	syms.reserve(e - b);
+	for (name_index_type::const_iterator i = b; i != e; ++i)
 	  {
-	    elf_symbol_sptr symbol(new elf_symbol);
-	    assert(lookup_elf_symbol_from_index(i, *symbol));
-	    assert(symbol->is_variable());
-
-	    if (load_var_map && symbol->is_public())
-	      {
-		{
-		  string_elf_symbols_map_type::iterator it =
-		    var_syms_->find(symbol->get_name());
-		  if (it == var_syms_->end())
-		    {
-		      (*var_syms_)[symbol->get_name()] = elf_symbols();
-		      it = var_syms_->find(symbol->get_name());
-		    }
-		  string name = symbol->get_name();
-		  it->second.push_back(symbol);
-		}
-
-		{
-		  addr_elf_symbol_sptr_map_type::const_iterator it =
-		    var_addr_sym_map_->find(sym->st_value);
-		  if (it == var_addr_sym_map_->end())
-		    (*var_addr_sym_map_)[sym->st_value] = symbol;
-		  else
-		    it->second->get_main_symbol()->add_alias(symbol.get());
-		}
-	      }
-	    else if (load_undefined_var_map && !symbol->is_defined())
+	    const elf_symbol_record& r = records[i->position];
+	    size_t key = (size_t(r.versym) << 1) | r.is_defined;
+	    versym_version_map::iterator v = versions.find(key);
+	    if (v == versions.end())
 	      {
-		string_elf_symbols_map_type::iterator it =
-		  undefined_var_syms_->find(symbol->get_name());
-		if (it == undefined_var_syms_->end())
-		  {
-		    (*undefined_var_syms_)[symbol->get_name()] = elf_symbols();
-		    it = undefined_var_syms_->find(symbol->get_name());
-		  }
-		it->second.push_back(symbol);
+		v = versions.insert(std::make_pair(key,
+						   elf_symbol::version())).first;
+		get_version_for_versym(r.versym, r.is_defined, v->second);
 	      }
+
+	    elf_symbol_sptr symbol(new elf_symbol(r.index, name,
+						  stt_to_elf_symbol_type(r.type),
+						  stb_to_elf_symbol_binding
+						  (r.binding),
+						  r.is_defined, v->second));
+	    symbols[i->position] = symbol;
+	    syms.push_back(symbol);
 	  }
       }
 
+    symbol_db_.build_address_indexes();
+
     return true;
   }
 
@@ -3237,12 +4810,7 @@ public:
   bool
   maybe_load_symbol_maps() const
   {
-    if (!fun_addr_sym_map_ || fun_addr_sym_map_->empty()
-	|| !var_addr_sym_map_ || var_addr_sym_map_->empty()
-	|| !fun_syms_ || fun_syms_->empty()
-	|| !var_syms_ || var_syms_->empty()
-	|| !undefined_fun_syms_ || undefined_fun_syms_->empty()
-	|| !undefined_var_syms_ || undefined_var_syms_->empty())
+    if (!symbol_maps_loaded_)
       return const_cast<read_context*>(this)->load_symbol_maps();
     return false;
   }
@@ -3656,7 +5224,7 @@ create_default_dwfl(char** debug_info_root_path)
   static Dwfl_Callbacks offline_callbacks;
 
   memset(&offline_callbacks, 0, sizeof(offline_callbacks));
-  offline_callbacks.find_debuginfo = dwfl_standard_find_debuginfo;
+  offline_callbacks.find_debuginfo = find_debug_info;
   offline_callbacks.section_address = dwfl_offline_section_address;
   offline_callbacks.debuginfo_path = debug_info_root_path;
   return dwfl_begin(&offline_callbacks);
@@ -5435,69 +7003,151 @@ static void
 build_primary_die_parent_relations_under(read_context& ctxt, Dwarf_Die *die)
 {build_die_parent_relations_under(die, ctxt.die_parent_map());}
 
-/// Walk the DIEs under a given die and for each child, populate the
-/// read_context::alternate_die_parent_map() to record the child ->
-/// parent relationship that exists between the child and the given
-/// die.
+/// The callback of dwarf_getattrs() used by
+/// collect_cross_unit_references_under().
 ///
-/// This is done recursively as for each child DIE, this function
-/// walks its children as well.
+/// @param attr the attribute to consider.
 ///
-/// @param ctxt the read context to consider.
+/// @param arg the set of DIE offsets to populate with the target of
+/// @p attr, if it's a reference to a DIE of the same debug info which
+/// might be in another unit.
+///
+/// @return DWARF_CB_OK, to keep walking the attributes.
+static int
+collect_cross_unit_reference(Dwarf_Attribute* attr, void* arg)
+{
+  if (dwarf_whatform(attr) == DW_FORM_ref_addr)
+    {
+      Dwarf_Die target;
+      if (dwarf_formref_die(attr, &target))
+	static_cast<offset_set*>(arg)->insert(dwarf_dieoffset(&target));
+    }
+  return DWARF_CB_OK;
+}
+
+/// Walk the DIEs under a given DIE, and collect the offsets of the
+/// DIEs they refer to, using the DW_FORM_ref_addr form.  Such
+/// references can cross unit boundaries.
 ///
 /// @param die the DIE whose children to walk recursively.
+///
+/// @param targets the set to populate with the offsets of the
+/// referred-to DIEs.
 static void
-build_alternate_die_parent_relations_under(read_context& ctxt, Dwarf_Die *die)
-{build_die_parent_relations_under(die, ctxt.alternate_die_parent_map());}
+collect_cross_unit_references_under(Dwarf_Die* die, offset_set& targets)
+{
+  Dwarf_Die child;
+  if (dwarf_child(die, &child) != 0)
+    return;
+
+  do
+    {
+      dwarf_getattrs(&child, collect_cross_unit_reference, &targets, 0);
+      collect_cross_unit_references_under(&child, targets);
+    }
+  while (dwarf_siblingof(&child, &child) == 0);
+}
 
-/// Walk the DIEs under a given die and for each childde, populate the
-/// appropriate die -> parent map to record the child -> parent
-/// relationship that exists between the child and the given DIE.
+/// Walk the DIEs under a given DIE, and add the ancestors of the DIEs
+/// that are referred to from other units to the set of DIEs that
+/// are referred to from other units.
 ///
-/// @param ctxt the read context to use.
+/// @param die the DIE whose children to walk recursively.
+///
+/// @param ancestors the ancestors of @p die, @p die included.
 ///
-/// @param die the DIEs whose children to walk recursively.
+/// @param targets the set of DIEs referred to from other units.
+/// Note that it's not updated while it's walked; the ancestors to
+/// add to it are collected in @p result.
 ///
-/// @param die_is_from_alt_debug_info true if @p die is from the
-/// alternate debug info section, false otherwise.
+/// @param result the ancestors of the DIEs of @p targets.
 static void
-build_die_parent_relations_under(read_context& ctxt, Dwarf_Die *die,
-				 bool die_is_from_alt_debug_info)
+collect_ancestors_of_cross_unit_dies(Dwarf_Die*		die,
+				     vector<Dwarf_Off>&	ancestors,
+				     const offset_set&	targets,
+				     offset_set&		result)
 {
-  if (die_is_from_alt_debug_info)
-    build_alternate_die_parent_relations_under(ctxt, die);
-  else
-    build_primary_die_parent_relations_under(ctxt, die);
+  Dwarf_Die child;
+  if (dwarf_child(die, &child) != 0)
+    return;
+
+  do
+    {
+      if (targets.find(dwarf_dieoffset(&child)) != targets.end())
+	result.insert(ancestors.begin(), ancestors.end());
+      ancestors.push_back(dwarf_dieoffset(&child));
+      collect_ancestors_of_cross_unit_dies(&child, ancestors,
+					   targets, result);
+      ancestors.pop_back();
+    }
+  while (dwarf_siblingof(&child, &child) == 0);
 }
 
-/// Walk all the DIEs accessible in the debug info (and in the
-/// alternate debug info as well) and build maps representing the
-/// relationship DIE -> parent.  That is, make it so that we can get
-/// the parent for a given DIE.
+/// Walk all the DIEs of the compile units of the main debug info and
+/// populate read_context::cross_unit_dies() with the DIEs that are
+/// referred to from other units, along with their ancestors.
 ///
-/// @param ctxt the read context from which to get the needed
-/// information.
+/// The DIEs of that set are the only DIEs of the compile units that
+/// are kept in the DIE -> decl, DIE -> type and DIE -> parent maps
+/// when the memory used to read the debug info is bounded.
+///
+/// @param ctxt the read context to consider.
 static void
-build_die_parent_maps(read_context& ctxt)
+collect_cross_unit_dies(read_context& ctxt)
 {
+  offset_set targets;
   uint8_t address_size = 0;
   size_t header_size = 0;
+  for (Dwarf_Off offset = 0, next_offset = 0;
+       (dwarf_next_unit(ctxt.dwarf(), offset, &next_offset, &header_size,
+			NULL, NULL, &address_size, NULL, NULL, NULL) == 0);
+       offset = next_offset)
+    {
+      Dwarf_Die unit;
+      if (dwarf_offdie(ctxt.dwarf(), offset + header_size, &unit))
+	collect_cross_unit_references_under(&unit, targets);
+    }
 
+  offset_set ancestors_of_targets;
   for (Dwarf_Off offset = 0, next_offset = 0;
-       (dwarf_next_unit(ctxt.alt_dwarf(), offset, &next_offset, &header_size,
+       (dwarf_next_unit(ctxt.dwarf(), offset, &next_offset, &header_size,
 			NULL, NULL, &address_size, NULL, NULL, NULL) == 0);
        offset = next_offset)
     {
-      Dwarf_Off die_offset = offset + header_size;
-      Dwarf_Die cu;
-      if (!dwarf_offdie(ctxt.alt_dwarf(), die_offset, &cu))
+      Dwarf_Die unit;
+      if (!dwarf_offdie(ctxt.dwarf(), offset + header_size, &unit)
+	  || dwarf_tag(&unit) != DW_TAG_compile_unit)
 	continue;
-      build_die_parent_relations_under(ctxt, &cu,
-				       /*die_is_from_alt_debug_info=*/true);
+      vector<Dwarf_Off> ancestors;
+      ancestors.push_back(dwarf_dieoffset(&unit));
+      collect_ancestors_of_cross_unit_dies(&unit, ancestors, targets,
+					   ancestors_of_targets);
     }
 
-  address_size = 0;
-  header_size = 0;
+  offset_set& result = ctxt.cross_unit_dies();
+  result.swap(targets);
+  result.insert(ancestors_of_targets.begin(), ancestors_of_targets.end());
+}
+
+/// Walk all the DIEs accessible in the debug info (and in the
+/// alternate debug info as well) and build maps representing the
+/// relationship DIE -> parent.  That is, make it so that we can get
+/// the parent for a given DIE.
+///
+/// When the memory used to read the debug info is bounded, the
+/// parent relations of the DIEs of the compile units of the main
+/// debug info are not built here; they are built by
+/// read_debug_info_into_corpus() just before each unit is read.
+///
+/// @param ctxt the read context from which to get the needed
+/// information.
+static void
+build_die_parent_maps(read_context& ctxt)
+{
+  ctxt.load_alternate_die_parent_map();
+
+  uint8_t address_size = 0;
+  size_t header_size = 0;
   for (Dwarf_Off offset = 0, next_offset = 0;
        (dwarf_next_unit(ctxt.dwarf(), offset, &next_offset, &header_size,
 			NULL, NULL, &address_size, NULL, NULL, NULL) == 0);
@@ -5505,11 +7155,14 @@ build_die_parent_maps(read_context& ctxt)
     {
       Dwarf_Off die_offset = offset + header_size;
       Dwarf_Die cu;
-      if (!dwarf_offdie(ctxt.dwarf(), die_offset, &cu))
+      if (!dwarf_offdie(ctxt.dwarf(), die_offset, &cu)
+	  || (ctxt.bounded_memory() && dwarf_tag(&cu) == DW_TAG_compile_unit))
 	continue;
-      build_die_parent_relations_under(ctxt, &cu,
-				       /*die_is_from_alt_debug_info=*/false);
+      build_primary_die_parent_relations_under(ctxt, &cu);
     }
+
+  if (ctxt.bounded_memory())
+    collect_cross_unit_dies(ctxt);
 }
 
 /// Get the last point where a DW_AT_import DIE is used to import a
@@ -5705,6 +7358,16 @@ get_parent_die(read_context&	ctxt,
     }
   else
     {
+      if (i == ctxt.die_parent_map().end() && ctxt.bounded_memory())
+	{
+	  // The parent relations of the DIEs of a compile unit are
+	  // built just before the unit is read, so this DIE belongs to
+	  // a unit that is yet to be read, or that was purged already.
+	  Dwarf_Die unit;
+	  assert(dwarf_diecu(die, &unit, 0, 0));
+	  build_primary_die_parent_relations_under(ctxt, &unit);
+	  i = ctxt.die_parent_map().find(dwarf_dieoffset(die));
+	}
       assert(i != ctxt.die_parent_map().end());
       assert(dwarf_offdie(ctxt.dwarf(), i->second, &parent_die));
     }
@@ -6116,7 +7779,7 @@ build_enum_type(read_context& ctxt,
   translation_unit_sptr tu = ctxt.cur_tu();
   decl_base_sptr d =
     add_decl_to_scope(t, tu->get_global_scope().get());
-  canonicalize(t);
+  ctxt.canonicalize_type(t);
 
   t = dynamic_pointer_cast<type_decl>(d);
   assert(t);
@@ -6133,78 +7796,346 @@ build_enum_type(read_context& ctxt,
 /// the member class.  That is, it updates properties like
 /// virtualness, access, constness, cdtorness, etc ...
 ///
-/// @param die the DIE of the function_decl that has been just built.
+/// @param die the DIE of the function_decl that has been just built.
+///
+/// @param f the function_decl that has just been built from @p die.
+///
+/// @param klass the class_decl that @p f belongs to.
+static void
+finish_member_function_reading(Dwarf_Die*		die,
+			       function_decl_sptr	f,
+			       class_decl_sptr		klass)
+{
+  assert(klass);
+
+  class_decl::method_decl_sptr m =
+    dynamic_pointer_cast<class_decl::method_decl>(f);
+  assert(m);
+
+  bool is_ctor = (f->get_name() == klass->get_name());
+  bool is_dtor = (!f->get_name().empty()
+		  && f->get_name()[0] == '~');
+  bool is_virtual = die_is_virtual(die);
+  size_t vindex = 0;
+  if (is_virtual)
+    die_virtual_function_index(die, vindex);
+  access_specifier access =
+    klass->is_struct()
+    ? public_access
+    : private_access;
+  die_access_specifier(die, access);
+  bool is_static = false;
+  {
+    // Let's see if the first parameter is a pointer to an instance of
+    // the same class type as the current class and has a
+    // DW_AT_artificial attribute flag set.  We are not looking at
+    // DW_AT_object_pointer (for DWARF 3) because it wasn't being
+    // emitted in GCC 4_4, which was already DWARF 3.
+    function_decl::parameter_sptr first_parm;
+    if (!f->get_parameters().empty())
+      first_parm = f->get_parameters()[0];
+
+    bool is_artificial =
+      first_parm && first_parm->get_artificial();;
+    pointer_type_def_sptr this_ptr_type;
+    type_base_sptr other_klass;
+
+    if (is_artificial)
+      this_ptr_type = is_pointer_type(first_parm->get_type());
+    if (this_ptr_type)
+      other_klass = this_ptr_type->get_pointed_to_type();
+    // Sometimes, other_klass can be qualified; e.g, volatile.  In
+    // that case, let's get the unqualified version of other_klass.
+    if (qualified_type_def_sptr q = is_qualified_type(other_klass))
+      other_klass = q->get_underlying_type();
+
+    if (other_klass
+	&& (ir::get_type_declaration(other_klass)->get_qualified_name()
+	    == klass->get_qualified_name()))
+      ;
+    else
+      is_static = true;
+  }
+  set_member_access_specifier(m, access);
+  set_member_function_is_virtual(m, is_virtual);
+  set_member_function_vtable_offset(m, vindex);
+  set_member_is_static(m, is_static);
+  set_member_function_is_ctor(m, is_ctor);
+  set_member_function_is_dtor(m, is_dtor);
+  set_member_function_is_const(m, false);
+
+  assert(is_member_function(m));
+}
+
+/// Compute the fingerprint of the type of a child of a class DIE,
+/// for die_class_fingerprint().
+///
+/// Unnamed pointer, reference, qualified, array and function types
+/// are followed down to the types they are made of.  A named type is
+/// described by its qualified name and its size.  A named type of a
+/// partial unit or of the alternate debug info is described by its
+/// offset instead, as its DIE is shared by all the compile units that
+/// refer to it.
+///
+/// @param ctxt the read context to consider.
+///
+/// @param die the type DIE to consider.
+///
+/// @param die_is_in_alt_di true if @p die is in the alternate debug
+/// info, false otherwise.
+///
+/// @param o the stream to write the fingerprint to.
+///
+/// @return true if the type has a fingerprint.  Anonymous classes,
+/// unions and enums, and types that are local to a function or in an
+/// anonymous namespace, have none.
+static bool
+die_type_fingerprint(read_context&	ctxt,
+		     Dwarf_Die*	die,
+		     bool		die_is_in_alt_di,
+		     std::ostream&	o)
+{
+  int tag = dwarf_tag(die);
+  o << tag;
+
+  string name = die_string_attribute(die, DW_AT_name);
+  if (!name.empty())
+    {
+      size_t size = 0;
+      if (die_size_in_bits(die, size))
+	o << ' ' << size;
+
+      Dwarf_Die unit;
+      if (die_is_in_alt_di
+	  || !dwarf_diecu(die, &unit, 0, 0)
+	  || dwarf_tag(&unit) != DW_TAG_compile_unit)
+	{
+	  o << (die_is_in_alt_di ? " alt@" : " @") << dwarf_dieoffset(die);
+	  return true;
+	}
+
+      // A type defined out of the scope it's declared in has the
+      // scope of its declaration.
+      Dwarf_Die scope_die = *die, parent_die;
+      bool spec_is_in_alt_di = false;
+      if (die_die_attribute(die, /*die_is_in_alt_di=*/false,
+			    DW_AT_specification, parent_die,
+			    spec_is_in_alt_di, false))
+	{
+	  if (spec_is_in_alt_di)
+	    return false;
+	  scope_die = parent_die;
+	}
+      for (;;)
+	{
+	  get_parent_die(ctxt, &scope_die, /*die_is_from_alt_di=*/false,
+			 parent_die, /*where_offset=*/0);
+	  scope_die = parent_die;
+	  int scope_tag = dwarf_tag(&scope_die);
+	  if (scope_tag == DW_TAG_compile_unit)
+	    break;
+	  if (scope_tag != DW_TAG_namespace
+	      && scope_tag != DW_TAG_class_type
+	      && scope_tag != DW_TAG_structure_type
+	      && scope_tag != DW_TAG_union_type)
+	    return false;
+	  string scope_name = die_string_attribute(&scope_die, DW_AT_name);
+	  if (scope_name.empty())
+	    return false;
+	  name = scope_name + "::" + name;
+	}
+      o << ' ' << name;
+      return true;
+    }
+
+  switch (tag)
+    {
+    case DW_TAG_pointer_type:
+    case DW_TAG_reference_type:
+    case DW_TAG_rvalue_reference_type:
+    case DW_TAG_const_type:
+    case DW_TAG_volatile_type:
+    case DW_TAG_restrict_type:
+    case DW_TAG_array_type:
+    case DW_TAG_subroutine_type:
+      break;
+    default:
+      return false;
+    }
+
+  Dwarf_Die child;
+  if ((tag == DW_TAG_array_type || tag == DW_TAG_subroutine_type)
+      && dwarf_child(die, &child) == 0)
+    do
+      {
+	int child_tag = dwarf_tag(&child);
+	size_t bound = 0;
+	if (child_tag == DW_TAG_subrange_type)
+	  {
+	    o << " [";
+	    if (die_unsigned_constant_attribute(&child, DW_AT_lower_bound,
+						bound))
+	      o << bound;
+	    o << ':';
+	    if (die_unsigned_constant_attribute(&child, DW_AT_upper_bound,
+						bound))
+	      o << bound;
+	    else if (die_unsigned_constant_attribute(&child, DW_AT_count,
+						     bound))
+	      o << '#' << bound;
+	    o << ']';
+	  }
+	else if (child_tag == DW_TAG_formal_parameter)
+	  {
+	    Dwarf_Die parm_type_die;
+	    bool parm_type_die_is_in_alt_di = false;
+	    o << " (";
+	    if (!die_die_attribute(&child, die_is_in_alt_di, DW_AT_type,
+				   parm_type_die, parm_type_die_is_in_alt_di)
+		|| !die_type_fingerprint(ctxt, &parm_type_die,
+					 parm_type_die_is_in_alt_di, o))
+	      return false;
+	    o << ')';
+	  }
+	else if (child_tag == DW_TAG_unspecified_parameters)
+	  o << " (...)";
+      }
+    while (dwarf_siblingof(&child, &child) == 0);
+
+  Dwarf_Die type_die;
+  bool type_die_is_in_alt_di = false;
+  if (!die_die_attribute(die, die_is_in_alt_di, DW_AT_type,
+			 type_die, type_die_is_in_alt_di))
+    {
+      o << " void";
+      return true;
+    }
+  o << " : ";
+  return die_type_fingerprint(ctxt, &type_die, type_die_is_in_alt_di, o);
+}
+
+/// Compute the part of the fingerprint of a class DIE of the main
+/// debug info that describes its children, for
+/// die_class_fingerprint().
+///
+/// The children of the member classes are described too,
+/// recursively, as their DIEs are associated to the IR nodes of the
+/// class that is reused, along with the DIEs of the children of the
+/// class.
 ///
-/// @param f the function_decl that has just been built from @p die.
+/// @param ctxt the read context to consider.
 ///
-/// @param klass the class_decl that @p f belongs to.
-static void
-finish_member_function_reading(Dwarf_Die*		die,
-			       function_decl_sptr	f,
-			       class_decl_sptr		klass)
+/// @param die the class DIE to consider.
+///
+/// @param o the stream to write the fingerprint to.
+///
+/// @return true if the children of @p die have a fingerprint, that
+/// is, if the type of each of them has one.
+static bool
+die_class_members_fingerprint(read_context&	ctxt,
+			      Dwarf_Die*	die,
+			      std::ostream&	o)
 {
-  assert(klass);
+  Dwarf_Die child;
+  if (dwarf_child(die, &child) == 0)
+    do
+      {
+	unsigned tag = dwarf_tag(&child);
+	o << '\n' << tag
+	  << ' ' << die_string_attribute(&child, DW_AT_name)
+	  << ' ' << die_linkage_name(&child);
+
+	ssize_t offset = 0;
+	if (die_member_offset(&child, offset))
+	  o << " @" << offset;
+
+	Dwarf_Die type_die;
+	bool type_die_is_in_alt_di = false;
+	if (die_die_attribute(&child, /*die_is_in_alt_di=*/false,
+			      DW_AT_type, type_die, type_die_is_in_alt_di))
+	  {
+	    o << " : ";
+	    if (!die_type_fingerprint(ctxt, &type_die,
+				      type_die_is_in_alt_di, o))
+	      return false;
+	  }
 
-  class_decl::method_decl_sptr m =
-    dynamic_pointer_cast<class_decl::method_decl>(f);
-  assert(m);
+	if (tag == DW_TAG_class_type || tag == DW_TAG_structure_type)
+	  {
+	    size_t size = 0;
+	    die_size_in_bits(&child, size);
+	    o << ' ' << size << " {";
+	    if (!die_class_members_fingerprint(ctxt, &child, o))
+	      return false;
+	    o << "\n}";
+	  }
+      }
+    while (dwarf_siblingof(&child, &child) == 0);
 
-  bool is_ctor = (f->get_name() == klass->get_name());
-  bool is_dtor = (!f->get_name().empty()
-		  && f->get_name()[0] == '~');
-  bool is_virtual = die_is_virtual(die);
-  size_t vindex = 0;
-  if (is_virtual)
-    die_virtual_function_index(die, vindex);
-  access_specifier access =
-    klass->is_struct()
-    ? public_access
-    : private_access;
-  die_access_specifier(die, access);
-  bool is_static = false;
-  {
-    // Let's see if the first parameter is a pointer to an instance of
-    // the same class type as the current class and has a
-    // DW_AT_artificial attribute flag set.  We are not looking at
-    // DW_AT_object_pointer (for DWARF 3) because it wasn't being
-    // emitted in GCC 4_4, which was already DWARF 3.
-    function_decl::parameter_sptr first_parm;
-    if (!f->get_parameters().empty())
-      first_parm = f->get_parameters()[0];
+  return true;
+}
 
-    bool is_artificial =
-      first_parm && first_parm->get_artificial();;
-    pointer_type_def_sptr this_ptr_type;
-    type_base_sptr other_klass;
+/// Compute the fingerprint of a class DIE of the main debug info.
+///
+/// Two class DIEs of different compile units that have the same
+/// fingerprint are deemed to describe the same class, so the IR nodes
+/// built from the first one are reused for the second one.  The
+/// fingerprint is made of the tag, qualified name, size and source
+/// location of the class, and of the tag, name, linkage name and
+/// offset of each child DIE, along with the fingerprint of its type,
+/// as computed by die_type_fingerprint(), and with the size and the
+/// children of the member classes, recursively.  Computing it only
+/// requires reading the attributes of the class DIE, of its
+/// descendants and of the DIEs their types are made of, and of their
+/// scopes.
+///
+/// Note that the DIEs of DWARF 4 type units need no fingerprint: all
+/// the references to a given type signature resolve to the same DIE,
+/// and thus to the same IR node.
+///
+/// @param ctxt the read context to consider.
+///
+/// @param die the DW_TAG_class_type or DW_TAG_structure_type DIE to
+/// consider.
+///
+/// @param scope the scope the class is to be added to.
+///
+/// @param fingerprint output parameter.  This is set to the
+/// fingerprint of @p die iff the function returns true.
+///
+/// @return true if @p die has a fingerprint.  Anonymous classes,
+/// declarations of classes, classes with no size or source location
+/// and classes with a child, or a child of a member class, which type
+/// has no fingerprint have none.
+/// These are built as usual.
+static bool
+die_class_fingerprint(read_context&		ctxt,
+		      Dwarf_Die*		die,
+		      const scope_decl*	scope,
+		      string&		fingerprint)
+{
+  if (die_is_declaration_only(die))
+    return false;
 
-    if (is_artificial)
-      this_ptr_type = is_pointer_type(first_parm->get_type());
-    if (this_ptr_type)
-      other_klass = this_ptr_type->get_pointed_to_type();
-    // Sometimes, other_klass can be qualified; e.g, volatile.  In
-    // that case, let's get the unqualified version of other_klass.
-    if (qualified_type_def_sptr q = is_qualified_type(other_klass))
-      other_klass = q->get_underlying_type();
+  string name = die_string_attribute(die, DW_AT_name);
+  string file = die_decl_file_attribute(die);
+  size_t size = 0, line = 0;
+  if (name.empty()
+      || file.empty()
+      || !die_size_in_bits(die, size)
+      || !die_unsigned_constant_attribute(die, DW_AT_decl_line, line))
+    return false;
 
-    if (other_klass
-	&& (ir::get_type_declaration(other_klass)->get_qualified_name()
-	    == klass->get_qualified_name()))
-      ;
-    else
-      is_static = true;
-  }
-  set_member_access_specifier(m, access);
-  set_member_function_is_virtual(m, is_virtual);
-  set_member_function_vtable_offset(m, vindex);
-  set_member_is_static(m, is_static);
-  set_member_function_is_ctor(m, is_ctor);
-  set_member_function_is_dtor(m, is_dtor);
-  set_member_function_is_const(m, false);
+  std::ostringstream o;
+  o << dwarf_tag(die) << ' '
+    << (scope ? scope->get_qualified_name() : string()) << "::" << name
+    << ' ' << size << ' ' << file << ':' << line;
 
-  assert(is_member_function(m));
+  if (!die_class_members_fingerprint(ctxt, die, o))
+    return false;
 
-  if (is_virtual)
-    klass->sort_virtual_mem_fns();
+  fingerprint = o.str();
+  return true;
 }
 
 /// Build a an IR node for class type from a DW_TAG_structure_type or
@@ -6261,6 +8192,24 @@ build_class_type_and_add_to_ir(read_context&	ctxt,
       return i->second;
   }
 
+  // Reuse the class built from a DIE of another compile unit that has
+  // the same fingerprint, if any.  Only the classes that are built
+  // with all their members are considered.
+  string fingerprint;
+  bool has_fingerprint =
+    (!klass
+     && !is_in_alt_di
+     && ctxt.deduplicate_types()
+     && (called_from_public_decl || ctxt.load_all_types())
+     && die_class_fingerprint(ctxt, die, scope, fingerprint));
+  if (has_fingerprint)
+    if (const deduplicated_class* c =
+	ctxt.lookup_class_from_fingerprint(fingerprint))
+      {
+	ctxt.associate_die_to_deduplicated_class(die, *c);
+	return c->klass;
+      }
+
   string name, linkage_name;
   location loc;
   die_loc_and_name(ctxt, die, loc, name, linkage_name);
@@ -6472,6 +8421,9 @@ build_class_type_and_add_to_ir(read_context&	ctxt,
       }
   }
 
+  if (has_fingerprint)
+    ctxt.record_class_fingerprint(fingerprint, die, result);
+
   ctxt.maybe_schedule_declaration_only_class_for_resolution(result);
   return result;
 }
@@ -7224,11 +9176,17 @@ read_debug_info_into_corpus(read_context& ctxt)
 
       address_size *= 8;
 
+      if (ctxt.bounded_memory())
+	build_primary_die_parent_relations_under(ctxt, &unit);
+
       // Build a translation_unit IR node from cu; note that cu must
       // be a DW_TAG_compile_unit die.
       translation_unit_sptr ir_node =
 	build_translation_unit_and_add_to_ir(ctxt, &unit, address_size);
       assert(ir_node);
+
+      if (ctxt.bounded_memory())
+	ctxt.purge_unit_dies(&unit);
     }
 
   ctxt.resolve_declaration_only_classes();
@@ -7246,6 +9204,7 @@ read_debug_info_into_corpus(read_context& ctxt)
   /// the main debug info section.
 
   ctxt.perform_late_type_canonicalizing();
+  ctxt.share_alternate_types();
 
   ctxt.current_corpus()->sort_functions();
   ctxt.current_corpus()->sort_variables();
@@ -7285,6 +9244,14 @@ maybe_canonicalize_type(Dwarf_Off	die_offset,
 	  && (klass->get_definition_of_declaration() == 0))
 	ctxt.schedule_type_for_late_canonicalization(die_offset, in_alt_di);
     }
+  else if (ctxt.type_canonicalization_is_deferred())
+    {
+      // Record the type for an early canonicalization attempt, and
+      // schedule it for a late one as well, in case its sub-types
+      // are not canonicalized by the time the early attempt is made.
+      ctxt.canonicalize_type(t);
+      ctxt.schedule_type_for_late_canonicalization(die_offset, in_alt_di);
+    }
   else if (!type_has_non_canonicalized_subtype(t))
     canonicalize(t);
   else
@@ -7381,7 +9348,7 @@ build_ir_node_from_die(read_context&	ctxt,
 					     die))
 	  {
 	    result = add_decl_to_scope(t, ctxt.cur_tu()->get_global_scope());
-	    canonicalize(t);
+	    ctxt.canonicalize_type(t);
 	  }
       break;
 
@@ -7531,7 +9498,7 @@ build_ir_node_from_die(read_context&	ctxt,
 		//   the non-canonicalized sub-type needs to be
 		//   canonicalized before this type is.
 		&& !type_has_non_canonicalized_subtype(klass)))
-	  canonicalize(klass);
+	  ctxt.canonicalize_type(klass);
 	else
 	  // So klass is not suitable for early canonicalization.
 	  // Let's schedule it for late canonicalization then.
@@ -7819,6 +9786,10 @@ build_ir_node_from_die(read_context&	ctxt,
   return result;
 }
 
+/// The lock that serializes the additions of the void type to the
+/// translation units being read.
+static pthread_mutex_t void_type_lock = PTHREAD_MUTEX_INITIALIZER;
+
 ///  Build the IR node for a void type.
 ///
 ///  @param ctxt the read context to use.
@@ -7828,9 +9799,17 @@ static decl_base_sptr
 build_ir_node_for_void_type(read_context& ctxt)
 {
   decl_base_sptr t = type_decl::get_void_type_decl();
-  if (!has_scope(t))
-    add_decl_to_scope(t, ctxt.cur_tu()->get_global_scope());
-  canonicalize(is_type(t));
+  if (!ctxt.void_type_is_in_cur_tu())
+    {
+      // The void type is shared by all the translation units being
+      // read, possibly concurrently.
+      pthread_mutex_lock(&void_type_lock);
+      t->set_scope(0);
+      add_decl_to_scope(t, ctxt.cur_tu()->get_global_scope());
+      pthread_mutex_unlock(&void_type_lock);
+      ctxt.void_type_is_in_cur_tu(true);
+    }
+  ctxt.canonicalize_type(is_type(t));
   return t;
 }
 
@@ -7931,9 +9910,112 @@ create_read_context(const std::string&	elf_path,
   dwfl_sptr handle = create_default_dwfl_sptr(debug_info_root_path);
   read_context_sptr result(new read_context(handle, elf_path));
   result->load_all_types(load_all_types);
+  result->debug_info_index(get_debug_info_index(debug_info_root_path));
   return result;
 }
 
+/// Bound the memory used to read the debug info with a given read
+/// context, or not.
+///
+/// When the memory is bounded, the mappings between the DIEs of a
+/// compile unit and the IR nodes built from them are released once
+/// the unit is read.  Only the mappings of the DIEs that can be
+/// referred to from other units are retained; these are the DIEs of
+/// partial units, the DIEs of the alternate debug info, and the DIEs
+/// that are the targets of DW_FORM_ref_addr references, along with
+/// their ancestors.  This lowers the peak memory usage of the reading
+/// of large binaries, at the cost of walking the DIEs a few more
+/// times.
+///
+/// @param ctxt the read context to consider.
+///
+/// @param f true to bound the memory used by @p ctxt.
+void
+set_bounded_memory(read_context& ctxt, bool f)
+{ctxt.bounded_memory(f);}
+
+/// Build the IR of the classes of the debug info read with a given
+/// read context once per class, or not.
+///
+/// C++ compile units repeat the definitions of the classes they use,
+/// e.g. the classes of the standard library, and each definition is
+/// otherwise built into a new IR node which is later canonicalized.
+/// When types are deduplicated, a cheap fingerprint of each complete
+/// class DIE is computed from the attributes of the DIE, of its
+/// children and of their types; see die_class_fingerprint().  The IR
+/// nodes built for the first DIE with a given fingerprint are then
+/// reused for the other DIEs with that fingerprint, instead of
+/// building new ones.
+///
+/// The reused classes belong to the translation unit where they were
+/// first built.  The types of the corpus are the same, but the
+/// translation units they are emitted in by abidw may differ.
+///
+/// @param ctxt the read context to consider.
+///
+/// @param f true to deduplicate the classes read by @p ctxt.
+void
+set_deduplicate_types(read_context& ctxt, bool f)
+{ctxt.deduplicate_types(f);}
+
+/// Build the index of the ELF files found under a debug info root
+/// directory, keyed by their build id, and store it in a file at the
+/// root of the directory.
+///
+/// Afterwards, when reading an ELF file with that debug info root
+/// path, the separate debug info file and the alternate debug info
+/// file are looked up in the index first, before letting elfutils
+/// search the directory for them.  Files that are added to the
+/// directory later are not in the index, but elfutils can still find
+/// them.
+///
+/// @param debug_info_root_path the root path of the debug info.
+///
+/// @param num_files output parameter.  This is set to the number of
+/// ELF files found under @p debug_info_root_path.
+///
+/// @return true upon successful completion, false if the index could
+/// not be written.
+bool
+build_debug_info_index(const string& debug_info_root_path,
+		       size_t& num_files)
+{
+  num_files = 0;
+  if (elf_version(EV_CURRENT) == EV_NONE)
+    return false;
+
+  build_id_index index(debug_info_root_path);
+  index.build();
+  num_files = index.size();
+  return index.write();
+}
+
+/// Load the ELF symbol tables of the binary being read, if they are
+/// not loaded already.
+///
+/// This is done by read_corpus_from_elf() as well; invoking this
+/// beforehand makes it possible to measure or check the loading of
+/// the symbols independently from the loading of the debug info.
+///
+/// @param ctxt the context to use for reading the elf file.
+///
+/// @return the resulting status.
+status
+load_elf_symbols(read_context& ctxt)
+{
+  enum status status = STATUS_UNKNOWN;
+
+  if (!ctxt.load_debug_info())
+    status |= STATUS_DEBUG_INFO_NOT_FOUND;
+
+  if (!ctxt.load_symbol_maps())
+    status |= STATUS_NO_SYMBOLS_FOUND;
+  else
+    status |= STATUS_OK;
+
+  return status;
+}
+
 /// Read all @ref abigail::translation_unit possible from the debug info
 /// accessible from an elf file, stuff them into a libabigail ABI
 /// Corpus and return it.
@@ -7981,6 +10063,338 @@ read_corpus_from_elf(read_context& ctxt, corpus_sptr& resulting_corp)
   return status;
 }
 
+/// Canonicalize the types which canonicalization was deferred while
+/// reading debug info.
+///
+/// The types are considered in the order in which their
+/// canonicalization was attempted during the reading.  A type is
+/// canonicalized only if all its sub-types are, which is the
+/// condition used when the canonicalization is not deferred.
+///
+/// @param types the types to canonicalize, as returned by
+/// read_context::deferred_types_to_canonicalize().
+static void
+canonicalize_deferred_types(const vector<type_base_sptr>& types)
+{
+  for (vector<type_base_sptr>::const_iterator i = types.begin();
+       i != types.end();
+       ++i)
+    if (!(*i)->get_canonical_type()
+	&& !type_has_non_canonicalized_subtype(*i))
+      canonicalize(*i);
+}
+
+/// Append the symbols of a map of ELF symbols to another map.
+///
+/// @param from the map to take the symbols from.
+///
+/// @param to the map to append the symbols to.
+static void
+merge_symbol_maps(const string_elf_symbols_map_type& from,
+		  string_elf_symbols_map_type& to)
+{
+  for (string_elf_symbols_map_type::const_iterator i = from.begin();
+       i != from.end();
+       ++i)
+    {
+      elf_symbols& syms = to[i->first];
+      syms.insert(syms.end(), i->second.begin(), i->second.end());
+    }
+}
+
+/// Remove from a map of undefined ELF symbols the symbols which name
+/// is in a map of defined symbols.
+///
+/// @param defined the map of defined symbols.
+///
+/// @param undefined the map of undefined symbols to prune.
+static void
+remove_defined_symbols(const string_elf_symbols_map_type& defined,
+		       string_elf_symbols_map_type& undefined)
+{
+  for (string_elf_symbols_map_type::const_iterator i = defined.begin();
+       i != defined.end();
+       ++i)
+    undefined.erase(i->first);
+}
+
+/// An ELF object file that is a member of a static archive, together
+/// with the result of reading it.
+struct static_archive_member
+{
+  string		name;
+  Elf*			elf;
+  string		tmp_path;
+  read_context_sptr	ctxt;
+  corpus_sptr		corp;
+  vector<type_base_sptr> types_to_canonicalize;
+  status		s;
+
+  static_archive_member(const string& n, Elf* e)
+    : name(n),
+      elf(e),
+      s(STATUS_UNKNOWN)
+  {}
+};// end struct static_archive_member
+
+/// Write the bytes of a member of a static archive into a file.
+///
+/// @param m the member to consider.  Its bytes are written into the
+/// file which path is @p m.tmp_path.
+///
+/// @return true upon successful completion.
+static bool
+extract_static_archive_member(const static_archive_member& m)
+{
+  size_t size = 0;
+  char* bytes = elf_rawfile(m.elf, &size);
+  if (!bytes)
+    return false;
+
+  int fd = open(m.tmp_path.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0600);
+  if (fd < 0)
+    return false;
+
+  bool is_ok = true;
+  while (size)
+    {
+      ssize_t n = write(fd, bytes, size);
+      if (n < 0)
+	{
+	  if (errno == EINTR)
+	    continue;
+	  is_ok = false;
+	  break;
+	}
+      bytes += n;
+      size -= n;
+    }
+
+  if (close(fd))
+    is_ok = false;
+  return is_ok;
+}
+
+/// The task of reading one member of a static archive, performed by
+/// a worker thread.
+///
+/// The member is extracted into a temporary file, which is read with
+/// the type canonicalization deferred, and then removed.
+class static_archive_read_task : public workers::task
+{
+  static_archive_member& member_;
+
+public:
+  static_archive_read_task(static_archive_member& m)
+    : member_(m)
+  {}
+
+  virtual void
+  perform()
+  {
+    if (!extract_static_archive_member(member_))
+      {
+	member_.s = STATUS_NO_SYMBOLS_FOUND;
+	member_.ctxt.reset();
+	unlink(member_.tmp_path.c_str());
+	return;
+      }
+
+    member_.ctxt->defer_type_canonicalization(true);
+    member_.s = read_corpus_from_elf(*member_.ctxt, member_.corp);
+    member_.types_to_canonicalize.swap
+      (member_.ctxt->deferred_types_to_canonicalize());
+    member_.ctxt.reset();
+    unlink(member_.tmp_path.c_str());
+  }
+};// end class static_archive_read_task
+
+/// Read the debug info of all the ELF object files of a static
+/// archive and stuff them into one ABI corpus.
+///
+/// The members of the archive are read concurrently by a pool of
+/// worker threads.  Their types are then canonicalized by the calling
+/// thread, in the order of the members in the archive, so that the
+/// types shared by several members are represented only once in the
+/// canonical type system.  Finally, the translation units, the
+/// exported declarations and the ELF symbols of all the members are
+/// gathered into the resulting corpus.
+///
+/// @param archive_path the path to the static archive.
+///
+/// @param debug_info_root_path a pointer to the root path under which
+/// to look for split debug info.  Leave this to NULL if the debug info
+/// is in the object files.
+///
+/// @param load_all_types if set to false only the types that are
+/// reachable from publicly exported declarations (of functions and
+/// variables) are read.  If set to true then all types found in the
+/// debug information are loaded.
+///
+/// @param num_threads the number of worker threads to use.  If this
+/// is zero, the members are read by the calling thread.
+///
+/// @param resulting_corp the resulting corpus.  It's set iff at least
+/// one member of the archive could be read.
+///
+/// @return the resulting status.
+status
+read_corpus_from_static_archive(const std::string&	archive_path,
+				char**			debug_info_root_path,
+				bool			load_all_types,
+				unsigned		num_threads,
+				corpus_sptr&		resulting_corp)
+{
+  if (elf_version(EV_CURRENT) == EV_NONE)
+    return STATUS_UNKNOWN;
+
+  int fd = open(archive_path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return STATUS_UNKNOWN;
+
+  Elf* archive = elf_begin(fd, ELF_C_READ_MMAP, 0);
+  if (archive == 0 || elf_kind(archive) != ELF_K_AR)
+    {
+      if (archive)
+	elf_end(archive);
+      close(fd);
+      return STATUS_UNKNOWN;
+    }
+
+  string dir_template =
+    tools_utils::get_temporary_directory() + "/libabigail-ar-XXXXXX";
+  vector<char> dir_path(dir_template.begin(), dir_template.end());
+  dir_path.push_back(0);
+  if (mkdtemp(&dir_path[0]) == 0)
+    {
+      elf_end(archive);
+      close(fd);
+      return STATUS_UNKNOWN;
+    }
+
+  // Walk the members of the archive.  Their Elf handles are kept
+  // open until the members are read, as their bytes are mapped by
+  // the handle of the archive.  Note that elf_getarhdr returns the
+  // header of the current member of the archive, which elf_next
+  // overwrites with the header of the next member.
+  vector<static_archive_member> members;
+  Elf_Cmd cmd = ELF_C_READ_MMAP;
+  while (Elf* e = elf_begin(fd, cmd, archive))
+    {
+      Elf_Arhdr* h = elf_getarhdr(e);
+      bool is_object_file = h != 0 && elf_kind(e) == ELF_K_ELF;
+      string name = h && h->ar_name ? h->ar_name : "";
+      cmd = elf_next(e);
+      if (!is_object_file)
+	{
+	  elf_end(e);
+	  continue;
+	}
+      members.push_back(static_archive_member(name, e));
+    }
+
+  // The read contexts are created by this thread, as creating a
+  // Dwfl handle is not thread safe.  The void and variadic parameter
+  // types are shared by all the translation units, so their lazily
+  // computed properties are computed here too.
+  vector<workers::task_sptr> tasks;
+  for (size_t i = 0; i < members.size(); ++i)
+    {
+      std::ostringstream o;
+      o << &dir_path[0] << "/" << i << ".o";
+      members[i].tmp_path = o.str();
+      members[i].ctxt = create_read_context(members[i].tmp_path,
+					    debug_info_root_path,
+					    load_all_types);
+      tasks.push_back(workers::task_sptr
+		      (new static_archive_read_task(members[i])));
+    }
+  canonicalize(type_decl::get_void_type_decl());
+  type_decl::get_void_type_decl()->get_qualified_name();
+  type_decl::get_variadic_parameter_type_decl()->get_qualified_name();
+
+  {
+    workers::queue q(std::min<size_t>(num_threads, members.size()));
+    q.schedule_tasks(tasks);
+    q.wait_for_workers_to_complete();
+  }
+
+  status result = members.empty() ? STATUS_NO_SYMBOLS_FOUND : STATUS_UNKNOWN;
+  corpus_sptr corp;
+  string_elf_symbols_map_sptr fun_syms(new string_elf_symbols_map_type),
+    var_syms(new string_elf_symbols_map_type),
+    undefined_fun_syms(new string_elf_symbols_map_type),
+    undefined_var_syms(new string_elf_symbols_map_type);
+
+  for (vector<static_archive_member>::iterator m = members.begin();
+       m != members.end();
+       ++m)
+    {
+      result |= m->s;
+      elf_end(m->elf);
+      if (!m->corp)
+	continue;
+
+      canonicalize_deferred_types(m->types_to_canonicalize);
+      m->types_to_canonicalize.clear();
+
+      if (!corp)
+	{
+	  corp.reset(new corpus(archive_path));
+	  corp->set_origin(corpus::DWARF_ORIGIN);
+	  corp->set_architecture_name(m->corp->get_architecture_name());
+	}
+
+      for (translation_units::const_iterator tu =
+	     m->corp->get_translation_units().begin();
+	   tu != m->corp->get_translation_units().end();
+	   ++tu)
+	corp->add(*tu);
+
+      corpus::exported_decls_builder_sptr b =
+	corp->get_exported_decls_builder();
+      for (corpus::functions::const_iterator f =
+	     m->corp->get_functions().begin();
+	   f != m->corp->get_functions().end();
+	   ++f)
+	b->maybe_add_fn_to_exported_fns(*f);
+      for (corpus::variables::const_iterator v =
+	     m->corp->get_variables().begin();
+	   v != m->corp->get_variables().end();
+	   ++v)
+	b->maybe_add_var_to_exported_vars(*v);
+
+      merge_symbol_maps(m->corp->get_fun_symbol_map(), *fun_syms);
+      merge_symbol_maps(m->corp->get_var_symbol_map(), *var_syms);
+      merge_symbol_maps(m->corp->get_undefined_fun_symbol_map(),
+			*undefined_fun_syms);
+      merge_symbol_maps(m->corp->get_undefined_var_symbol_map(),
+			*undefined_var_syms);
+    }
+
+  elf_end(archive);
+  close(fd);
+  rmdir(&dir_path[0]);
+
+  if (!corp)
+    return result;
+
+  // A symbol that is undefined in a member but defined in another one
+  // is not undefined in the archive.
+  remove_defined_symbols(*fun_syms, *undefined_fun_syms);
+  remove_defined_symbols(*var_syms, *undefined_var_syms);
+
+  corp->set_fun_symbol_map(fun_syms);
+  corp->set_var_symbol_map(var_syms);
+  corp->set_undefined_fun_symbol_map(undefined_fun_syms);
+  corp->set_undefined_var_symbol_map(undefined_var_syms);
+  corp->sort_functions();
+  corp->sort_variables();
+
+  resulting_corp = corp;
+  return result | STATUS_OK;
+}
+
 /// Read all @ref abigail::translation_unit possible from the debug info
 /// accessible from an elf file, stuff them into a libabigail ABI
 /// Corpus and return it.
@@ -7996,6 +10410,10 @@ read_corpus_from_elf(read_context& ctxt, corpus_sptr& resulting_corp)
 /// /usr/lib/debug will be searched for sub-directories containing the
 /// debug info file.
 ///
+/// If @p elf_path is a static archive, then the object files it
+/// contains are read concurrently into one corpus, using
+/// read_corpus_from_static_archive().
+///
 /// @param load_all_types if set to false only the types that are
 /// reachable from publicly exported declarations (of functions and
 /// variables) are read.  If set to true then all types found in the
@@ -8010,6 +10428,13 @@ read_corpus_from_elf(const std::string& elf_path,
 		     bool load_all_types,
 		     corpus_sptr& resulting_corp)
 {
+  if (tools_utils::guess_file_type(elf_path) == tools_utils::FILE_TYPE_AR)
+    return read_corpus_from_static_archive(elf_path,
+					   debug_info_root_path,
+					   load_all_types,
+					   workers::get_number_of_threads(),
+					   resulting_corp);
+
   // Create a DWARF Front End Library handle to be used by functions
   // of that library.
   dwfl_sptr handle = create_default_dwfl_sptr(debug_info_root_path);
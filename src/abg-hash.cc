@@ -20,6 +20,7 @@
 
 /// @file
 
+#include <tr1/unordered_set>
 #include "abg-hash.h"
 #include "abg-ir.h"
 
@@ -56,6 +57,7 @@ combine_hashes(size_t val1, size_t val2)
 
 using std::list;
 using std::vector;
+using std::tr1::unordered_set;
 
 using namespace abigail::ir;
 
@@ -582,15 +584,80 @@ class_decl::member_class_template::hash::operator()
   return v;
 }
 
+/// The set of the classes that are being hashed by an invocation of
+/// class_decl::hash::operator() and by the hashing it recursively
+/// triggers.
+///
+/// If via the hashing of a data member or a member function a class
+/// is reached again while it is being hashed, it hashes to zero.  That
+/// avoids an infinite recursion.
+///
+/// The top-most class hashing of a thread creates an instance of this
+/// type on its stack, and makes it the current context of the thread
+/// until it returns.  So several threads can hash the same classes
+/// concurrently.
+class class_hashing_context
+{
+  unordered_set<const class_decl*>	classes_;
+  static __thread class_hashing_context*	current_;
+
+public:
+
+  /// Constructor of @ref class_hashing_context.
+  ///
+  /// The new instance becomes the current context of the thread.
+  class_hashing_context()
+  {current_ = this;}
+
+  /// Destructor of @ref class_hashing_context.
+  ///
+  /// The thread is left without current context.
+  ~class_hashing_context()
+  {current_ = 0;}
+
+  /// @return the current context of the thread, or nil if the thread
+  /// isn't hashing classes.
+  static class_hashing_context*
+  get_current()
+  {return current_;}
+
+  /// Mark a class as being currently hashed.
+  ///
+  /// @param klass the class to mark.
+  void
+  mark_as_being_hashed(const class_decl& klass)
+  {classes_.insert(&klass);}
+
+  /// Unmark a class that was marked by mark_as_being_hashed().
+  ///
+  /// @param klass the class to unmark.
+  void
+  unmark_as_being_hashed(const class_decl& klass)
+  {classes_.erase(&klass);}
+
+  /// Test if a given class is being currently hashed.
+  ///
+  /// @param klass the class to test.
+  ///
+  /// @return true if @p klass is being hashed, false otherwise.
+  bool
+  hashing_started(const class_decl& klass) const
+  {return classes_.find(&klass) != classes_.end();}
+};// end class class_hashing_context
+
+__thread class_hashing_context* class_hashing_context::current_;
+
 /// Compute a hash for a @ref class_decl
 ///
 /// @param t the class_decl for which to compute the hash value.
 ///
+/// @param ctxt the context of the hashing of the current thread.
+///
 /// @return the computed hash value.
-size_t
-class_decl::hash::operator()(const class_decl& t) const
+static size_t
+hash_class(const class_decl& t, class_hashing_context& ctxt)
 {
-  if (t.hashing_started()
+  if (ctxt.hashing_started(t)
       || (t.get_is_declaration_only() && !t.get_definition_of_declaration()))
     return 0;
 
@@ -610,7 +677,7 @@ class_decl::hash::operator()(const class_decl& t) const
   v = hashing::combine_hashes(v, hash_scope_type(t));
   v = hashing::combine_hashes(v, hash_bool(t.get_is_declaration_only()));
 
-  t.hashing_started(true);
+  ctxt.mark_as_being_hashed(t);
 
   // Hash bases.
   for (class_decl::base_specs::const_iterator b =
@@ -663,11 +730,26 @@ class_decl::hash::operator()(const class_decl& t) const
        ++c)
     v = hashing::combine_hashes(v, hash_member_class_tmpl(**c));
 
-  t.hashing_started(false);
+  ctxt.unmark_as_being_hashed(t);
 
   return v;
 }
 
+/// Compute a hash for a @ref class_decl
+///
+/// @param t the class_decl for which to compute the hash value.
+///
+/// @return the computed hash value.
+size_t
+class_decl::hash::operator()(const class_decl& t) const
+{
+  if (class_hashing_context* ctxt = class_hashing_context::get_current())
+    return hash_class(t, *ctxt);
+
+  class_hashing_context ctxt;
+  return hash_class(t, ctxt);
+}
+
 /// Compute a hash for a @ref class_decl
 ///
 /// @param t the class_decl for which to compute the hash value.
@@ -26,9 +26,11 @@
 /// the libabigail library.
 
 #include <cassert>
+#include <cstdio>
 #include <utility>
 #include <memory>
 #include <fstream>
+#include <sstream>
 #include "abg-ini.h"
 
 namespace abigail
@@ -128,14 +130,82 @@ config::section::~section()
 
 // <read_context stuff>
 
+/// An input stream over a buffer that holds the whole content to
+/// parse.
+///
+/// It has the peek(), get(), good() and eof() member functions of
+/// std::istream, with the same semantics: good() becomes false (and
+/// eof() becomes true) once peek() or get() has been invoked at the
+/// end of the buffer.  But unlike those of std::istream, these are
+/// inline and don't go through a stream buffer for each character.
+///
+/// This is a private type that is used only in the internals of the
+/// ini file parsing.
+class input_buffer
+{
+  const char* cur_;
+  const char* end_;
+  bool eof_;
+
+  // Forbid this;
+  input_buffer();
+
+public:
+
+  /// @param begin the beginning of the buffer to read from.
+  ///
+  /// @param end the end of the buffer to read from.
+  input_buffer(const char* begin, const char* end)
+    : cur_(begin),
+      end_(end),
+      eof_(false)
+  {}
+
+  /// @return the next character of the buffer, without consuming it,
+  /// or EOF if the end of the buffer is reached.
+  int
+  peek()
+  {
+    if (cur_ == end_)
+      {
+	eof_ = true;
+	return EOF;
+      }
+    return static_cast<unsigned char>(*cur_);
+  }
+
+  /// @return the next character of the buffer, after consuming it,
+  /// or EOF if the end of the buffer is reached.
+  int
+  get()
+  {
+    if (cur_ == end_)
+      {
+	eof_ = true;
+	return EOF;
+      }
+    return static_cast<unsigned char>(*cur_++);
+  }
+
+  /// @return true iff the end of the buffer wasn't reached yet.
+  bool
+  good() const
+  {return !eof_;}
+
+  /// @return true iff the end of the buffer was reached.
+  bool
+  eof() const
+  {return eof_;}
+};//end class input_buffer
+
 /// The context of the ini file parsing.
 ///
 /// This is a private type that is used only in the internals of the
 /// ini file parsing.
 class read_context
 {
-  /// The input stream we are parsing from.
-  istream& in_;
+  /// The input buffer we are parsing from.
+  input_buffer& in_;
   /// The current line being parsed.
   unsigned cur_line_;
   /// The current column on the current line.
@@ -146,8 +216,8 @@ class read_context
 
 public:
 
-  /// @param in the input stream to parse from.
-  read_context(istream& in)
+  /// @param in the input buffer to parse from.
+  read_context(input_buffer& in)
     : in_(in),
       cur_line_(0),
       cur_column_(0)
@@ -623,19 +693,20 @@ config::set_sections(const sections_type& sections)
 
 // <config reader stuff>
 
-/// Parse the sections of an *.ini file.
+/// Parse the sections of an *.ini file held in a memory buffer.
 ///
-/// @param input the input stream to parse the ini file from.
+/// @param begin the beginning of the buffer to parse.
 ///
-/// @param section out parameter.  This is set to the vector of
-/// sections that have been parsed from the input stream.
+/// @param end the end of the buffer to parse.
 ///
-/// @return true upon successful completion and if if the stream is
-/// left in a non-erratic state.
-bool
-read_sections(std::istream& input,
+/// @param section out parameter.  This is set to the vector of
+/// sections that have been parsed from the buffer.
+static void
+read_sections(const char* begin,
+	      const char* end,
 	      config::sections_type& sections)
 {
+  input_buffer input(begin, end);
   read_context ctxt(input);
 
   while (input.good())
@@ -646,6 +717,33 @@ read_sections(std::istream& input,
       else
 	break;
     }
+}
+
+/// Parse the sections of an *.ini file.
+///
+/// The content of the stream is read at once, and then parsed from
+/// memory.
+///
+/// @param input the input stream to parse the ini file from.
+///
+/// @param section out parameter.  This is set to the vector of
+/// sections that have been parsed from the input stream.
+///
+/// @return true upon successful completion and if if the stream is
+/// left in a non-erratic state.
+bool
+read_sections(std::istream& input,
+	      config::sections_type& sections)
+{
+  if (!input.good())
+    return input.eof();
+
+  std::ostringstream o;
+  if (input.peek() != EOF)
+    o << input.rdbuf();
+  string content = o.str();
+
+  read_sections(content.data(), content.data() + content.size(), sections);
 
   return input.good() || input.eof();
 }
@@ -33,6 +33,7 @@
 #include <sstream>
 #include <tr1/memory>
 #include <tr1/unordered_map>
+#include <tr1/unordered_set>
 #include "abg-sptr-utils.h"
 #include "abg-ir.h"
 
@@ -47,60 +48,84 @@ using std::string;
 using std::list;
 using std::vector;
 using std::tr1::unordered_map;
+using std::tr1::unordered_set;
 using std::tr1::dynamic_pointer_cast;
 using std::tr1::static_pointer_cast;
 
 /// @brief the location of a token represented in its simplest form.
-/// Instances of this type are to be stored in a sorted vector, so the
-/// type must have proper relational operators.
-class expanded_location
+///
+/// The file path is designated by its index in a @ref
+/// location_path_table, so an instance of this type is just three
+/// integers.
+struct packed_location
 {
-  string	path_;
-  unsigned	line_;
-  unsigned	column_;
-
-  expanded_location();
-
-public:
-
-  friend class location_manager;
+  unsigned	path_id;
+  unsigned	line;
+  unsigned	column;
 
-  expanded_location(const string& path, unsigned line, unsigned column)
-  : path_(path), line_(line), column_(column)
+  packed_location(unsigned p, unsigned l, unsigned c)
+    : path_id(p), line(l), column(c)
   {}
+};
 
-  bool
-  operator==(const expanded_location& l) const
-  {
-    return (path_ == l.path_
-	    && line_ == l.line_
-	    && column_ && l.column_);
-  }
+struct location_path_table::priv
+{
+  /// The map of interned paths.  The elements of an unordered_map
+  /// are never moved, so the paths vector below can point to its
+  /// keys.
+  unordered_map<string, unsigned> ids;
+  /// The interned paths, indexed by their ID.
+  vector<const string*> paths;
+};
 
-  bool
-  operator<(const expanded_location& l) const
-  {
-    if (path_ < l.path_)
-      return true;
-    else if (path_ > l.path_)
-      return false;
+location_path_table::location_path_table()
+  : priv_(new priv)
+{}
 
-    if (line_ < l.line_)
-      return true;
-    else if (line_ > l.line_)
-      return false;
+/// Intern a file path into the table.
+///
+/// @param path the path to intern.
+///
+/// @return the ID of @p path in the table.  Interning the same path
+/// twice yields the same ID.
+unsigned
+location_path_table::intern_path(const std::string& path)
+{
+  std::pair<unordered_map<string, unsigned>::iterator, bool> r =
+    priv_->ids.insert(std::make_pair(path, priv_->paths.size()));
+  if (r.second)
+    priv_->paths.push_back(&r.first->first);
+  return r.first->second;
+}
 
-    return column_ < l.column_;
-  }
-};
+/// Get the path that has a given ID.
+///
+/// @param id the ID of the path, as returned by
+/// location_path_table::intern_path().
+///
+/// @return the path which ID is @p id.
+const std::string&
+location_path_table::get_path(unsigned id) const
+{return *priv_->paths[id];}
+
+/// @return the number of distinct paths in the table.
+size_t
+location_path_table::get_number_of_paths() const
+{return priv_->paths.size();}
 
 struct location_manager::priv
 {
-  /// This sorted vector contains the expanded locations of the tokens
-  /// coming from a given ABI Corpus.  The index of a given expanded
-  /// location in the table gives us an integer that is used to build
-  /// instance of location types.
-  std::vector<expanded_location> locs;
+  /// This vector contains the locations of the tokens coming from a
+  /// given translation unit.  The index of a given location in the
+  /// table gives us an integer that is used to build instance of
+  /// location types.
+  std::vector<packed_location> locs;
+  /// The table of the file paths of the locations.
+  location_path_table_sptr paths;
+
+  priv()
+    : paths(new location_path_table)
+  {}
 };
 
 location_manager::location_manager()
@@ -119,10 +144,10 @@ location_manager::create_new_location(const std::string&	file_path,
 				      size_t			line,
 				      size_t			col)
 {
-  expanded_location l(file_path, line, col);
+  packed_location l(priv_->paths->intern_path(file_path), line, col);
 
-  // Just append the new expanded location to the end of the vector
-  // and return its index.  Note that indexes start at 1.
+  // Just append the new location to the end of the vector and return
+  // its index.  Note that indexes start at 1.
   priv_->locs.push_back(l);
   return location(priv_->locs.size());
 }
@@ -145,10 +170,38 @@ location_manager::expand_location(const location	location,
 {
   if (location.value_ == 0)
     return;
-  expanded_location &l = priv_->locs[location.value_ - 1];
-  path = l.path_;
-  line = l.line_;
-  column = l.column_;
+  const packed_location &l = priv_->locs[location.value_ - 1];
+  path = priv_->paths->get_path(l.path_id);
+  line = l.line;
+  column = l.column;
+}
+
+/// @return the number of locations created by this location manager.
+size_t
+location_manager::get_number_of_locations() const
+{return priv_->locs.size();}
+
+/// Getter of the table of the file paths of the locations.
+///
+/// @return the table of paths.
+const location_path_table_sptr&
+location_manager::get_path_table() const
+{return priv_->paths;}
+
+/// Setter of the table of the file paths of the locations.
+///
+/// This is used to share a table of paths between several location
+/// managers, e.g, the ones of the translation units of a given
+/// corpus.  It must be invoked before any location is created by
+/// this location manager.
+///
+/// @param t the new table of paths.
+void
+location_manager::set_path_table(const location_path_table_sptr& t)
+{
+  assert(priv_->locs.empty());
+  if (t)
+    priv_->paths = t;
 }
 
 typedef unordered_map<function_type_sptr,
@@ -994,9 +1047,28 @@ elf_symbol::version::version(const string& v,
   : priv_(new priv(v, is_default))
 {}
 
+/// Copy constructor of the version.
+///
+/// The new version shares its private data with @p v, until one of
+/// them is modified; see elf_symbol::version::make_private_data_unique.
+///
+/// @param v the version to copy.
 elf_symbol::version::version(const elf_symbol::version& v)
-  : priv_(new priv(v.str(), v.is_default()))
+  : priv_(v.priv_)
+{
+}
+
+/// Give the current version its own copy of the private data it
+/// shares with other versions, if any, so that it can be modified.
+///
+/// A symbol table can hold hundreds of thousands of symbols that all
+/// carry a copy of a handful of versions, so copying a version
+/// doesn't duplicate its private data until it is modified.
+void
+elf_symbol::version::make_private_data_unique()
 {
+  if (!priv_.unique())
+    priv_.reset(new priv(*priv_));
 }
 
 /// Cast the version_type into a string that is its name.
@@ -1017,7 +1089,10 @@ elf_symbol::version::str() const
 /// @param s the version name.
 void
 elf_symbol::version::str(const string& s)
-{priv_->version_ = s;}
+{
+  make_private_data_unique();
+  priv_->version_ = s;
+}
 
 /// Getter for the 'is_default' property of the version.
 ///
@@ -1031,7 +1106,10 @@ elf_symbol::version::is_default() const
 /// @param f true if this is the default version.
 void
 elf_symbol::version::is_default(bool f)
-{priv_->is_default_ = f;}
+{
+  make_private_data_unique();
+  priv_->is_default_ = f;
+}
 
 bool
 elf_symbol::version::is_empty() const
@@ -1054,8 +1132,7 @@ elf_symbol::version::operator==(const elf_symbol::version& o) const
 elf_symbol::version&
 elf_symbol::version::operator=(const elf_symbol::version& o)
 {
-  str(o.str());
-  is_default(o.is_default());
+  priv_ = o.priv_;
   return *this;
 }
 
@@ -2266,14 +2343,21 @@ set_member_function_vtable_offset(function_decl& f, size_t s)
 
   ctxt->vtable_offset(s);
 }
-/// Get the vtable offset of a member function.
+/// Set the vtable offset of a member function.
+///
+/// If the member function is virtual, the ordering of the virtual
+/// member functions of its class is updated accordingly.
 ///
 /// @param f the member function to consider.
 ///
 /// @param s the new vtable offset.
 void
 set_member_function_vtable_offset(const function_decl_sptr& f, size_t s)
-{return set_member_function_vtable_offset(*f, s);}
+{
+  set_member_function_vtable_offset(*f, s);
+  fixup_virtual_member_function
+    (dynamic_pointer_cast<class_decl::method_decl>(f));
+}
 
 /// Test if a given member function is virtual.
 ///
@@ -8135,7 +8219,6 @@ sort_virtual_member_functions(class_decl::member_functions& mem_fns);
 /// The private data for the class_decl type.
 struct class_decl::priv
 {
-  static unordered_map<string, bool>	classes_being_compared_;
   bool					is_declaration_only_;
   bool					is_struct_;
   decl_base_sptr			declaration_;
@@ -8145,12 +8228,19 @@ struct class_decl::priv
   data_members				data_members_;
   member_functions			member_functions_;
   member_functions			virtual_mem_fns_;
+  // The set of the elements of virtual_mem_fns_.
+  unordered_set<const method_decl*>	virtual_mem_fns_set_;
+  // Whether virtual_mem_fns_ is sorted.  Sorting it is deferred until
+  // it is needed, so that adding N virtual member functions to a
+  // class doesn't sort the vector N times.
+  bool					virtual_mem_fns_sorted_;
   member_function_templates		member_function_templates_;
   member_class_templates		member_class_templates_;
 
   priv()
     : is_declaration_only_(false),
-      is_struct_(false)
+      is_struct_(false),
+      virtual_mem_fns_sorted_(true)
   {}
 
   priv(bool is_struct, class_decl::base_specs& bases,
@@ -8162,114 +8252,103 @@ struct class_decl::priv
       bases_(bases),
       member_types_(mbr_types),
       data_members_(data_mbrs),
-      member_functions_(mbr_fns)
+      member_functions_(mbr_fns),
+      virtual_mem_fns_sorted_(true)
   {}
 
   priv(bool is_struct)
     : is_declaration_only_(false),
-      is_struct_(is_struct)
+      is_struct_(is_struct),
+      virtual_mem_fns_sorted_(true)
   {}
 
   priv(bool is_declaration_only, bool is_struct)
     : is_declaration_only_(is_declaration_only),
-      is_struct_(is_struct)
+      is_struct_(is_struct),
+      virtual_mem_fns_sorted_(true)
   {}
 
-  /// Mark a class as being currently compared using the class_decl==
-  /// operator.
-  ///
-  /// This method is not thread safe because it uses the static data
-  /// member classes_being_compared_.  If you wish to use it in a
-  /// multi-threaded environment you should probably protect the
-  /// access to that static data member with a mutex or somesuch.
+  /// Add a virtual member function to the vector of virtual member
+  /// functions, unless it's already there.
   ///
-  /// Note that is marking business is to avoid infinite loop when
-  /// comparing a class. If via the comparison of a data member or a
-  /// member function a recursive re-comparison of the class is
-  /// attempted, the marking business help to detect that infinite
-  /// loop possibility and avoid it.
+  /// The vector is then going to be sorted again the next time it's
+  /// needed.
   ///
-  /// @param klass the class to mark as being currently compared.
+  /// @param f the virtual member function to add.
   void
-  mark_as_being_compared(const class_decl& klass) const
-  {classes_being_compared_[klass.get_qualified_name()] = true;}
+  add_virtual_mem_fn(const method_decl_sptr& f)
+  {
+    if (virtual_mem_fns_set_.insert(f.get()).second)
+      virtual_mem_fns_.push_back(f);
+    virtual_mem_fns_sorted_ = false;
+  }
+};// end struct class_decl::priv
 
-  /// Mark a class as being currently compared using the class_decl==
-  /// operator.
-  ///
-  /// Note that is marking business is to avoid infinite loop when
-  /// comparing a class. If via the comparison of a data member or a
-  /// member function a recursive re-comparison of the class is
-  /// attempted, the marking business help to detect that infinite
-  /// loop possibility and avoid it.
-  ///
-  /// @param klass the class to mark as being currently compared.
-  void
-  mark_as_being_compared(const class_decl* klass) const
-  {mark_as_being_compared(*klass);}
+/// The set of the classes that are being compared by an invocation of
+/// equals(const class_decl&, const class_decl&, change_kind*) and by
+/// the comparisons it recursively triggers.
+///
+/// If via the comparison of a data member or a member function a
+/// recursive re-comparison of a class is attempted, this set helps
+/// to detect that infinite loop possibility and avoid it.
+///
+/// The top-most class comparison of a thread creates an instance of
+/// this type on its stack, and makes it the current context of the
+/// thread until it returns.  So several threads can compare classes
+/// concurrently.
+class class_comparison_context
+{
+  unordered_set<const class_decl*>	classes_;
+  static __thread class_comparison_context*	current_;
 
-  /// Mark a class as being currently compared using the class_decl==
-  /// operator.
+public:
+
+  /// Constructor of @ref class_comparison_context.
   ///
-  /// Note that is marking business is to avoid infinite loop when
-  /// comparing a class. If via the comparison of a data member or a
-  /// member function a recursive re-comparison of the class is
-  /// attempted, the marking business help to detect that infinite
-  /// loop possibility and avoid it.
+  /// The new instance becomes the current context of the thread.
+  class_comparison_context()
+  {current_ = this;}
+
+  /// Destructor of @ref class_comparison_context.
   ///
-  /// @param klass the class to mark as being currently compared.
-  void
-  mark_as_being_compared(const class_decl_sptr& klass) const
-  {mark_as_being_compared(*klass);}
+  /// The thread is left without current context.
+  ~class_comparison_context()
+  {current_ = 0;}
 
-  /// If the instance of class_decl has been previously marked as
-  /// being compared -- via an invocation of mark_as_being_compared()
-  /// this method unmarks it.  Otherwise is has no effect.
+  /// @return the current context of the thread, or nil if the thread
+  /// isn't comparing classes.
+  static class_comparison_context*
+  get_current()
+  {return current_;}
+
+  /// Mark a class as being currently compared.
   ///
-  /// This method is not thread safe because it uses the static data
-  /// member classes_being_compared_.  If you wish to use it in a
-  /// multi-threaded environment you should probably protect the
-  /// access to that static data member with a mutex or somesuch.
+  /// @param klass the class to mark.
   ///
-  /// @param klass the instance of class_decl to unmark.
-  void
-  unmark_as_being_compared(const class_decl& klass) const
-  {classes_being_compared_.erase(klass.get_qualified_name());}
+  /// @return true if @p klass got marked by this invocation, false if
+  /// it was marked already, e.g, by an enclosing comparison.
+  bool
+  mark_as_being_compared(const class_decl& klass)
+  {return classes_.insert(&klass).second;}
 
-  /// If the instance of class_decl has been previously marked as
-  /// being compared -- via an invocation of mark_as_being_compared()
-  /// this method unmarks it.  Otherwise is has no effect.
+  /// Unmark a class that was marked by mark_as_being_compared().
   ///
-  /// @param klass the instance of class_decl to unmark.
+  /// @param klass the class to unmark.
   void
-  unmark_as_being_compared(const class_decl* klass) const
-  {classes_being_compared_.erase(klass->get_qualified_name());}
+  unmark_as_being_compared(const class_decl& klass)
+  {classes_.erase(&klass);}
 
-  /// Test if a given instance of class_decl is being currently
-  /// compared.
+  /// Test if a given class is being currently compared.
   ///
-  ///@param klass the class to test.
+  /// @param klass the class to test.
   ///
   /// @return true if @p klass is being compared, false otherwise.
   bool
   comparison_started(const class_decl& klass) const
-  {
-    return (classes_being_compared_.find(klass.get_qualified_name())
-	    != classes_being_compared_.end());
-  }
-
-  /// Test if a given instance of class_decl is being currently
-  /// compared.
-  ///
-  ///@param klass the class to test.
-  ///
-  /// @return true if @p klass is being compared, false otherwise.
-  bool
-  comparison_started(const class_decl* klass) const
-  {return comparison_started(*klass);}
-};// end struct class_decl::priv
+  {return classes_.find(&klass) != classes_.end();}
+};// end class class_comparison_context
 
-unordered_map<string, bool> class_decl::priv::classes_being_compared_;
+__thread class_comparison_context* class_comparison_context::current_;
 
 /// A Constructor for instances of \ref class_decl
 ///
@@ -8432,15 +8511,32 @@ class_decl::get_member_functions() const
 
 /// Get the virtual member functions of this class.
 ///
+/// They are sorted by their vtable offset.
+///
 /// @param return a vector of the virtual member functions of this
 /// class.
 const class_decl::member_functions&
 class_decl::get_virtual_mem_fns() const
-{return priv_->virtual_mem_fns_;}
+{
+  if (!priv_->virtual_mem_fns_sorted_)
+    {
+      sort_virtual_member_functions(priv_->virtual_mem_fns_);
+      priv_->virtual_mem_fns_sorted_ = true;
+    }
+  return priv_->virtual_mem_fns_;
+}
 
+/// Sort the virtual member functions of this class by their vtable
+/// offset.
+///
+/// Note that get_virtual_mem_fns() takes care of sorting them when
+/// needed, so calling this is never necessary.
 void
 class_decl::sort_virtual_mem_fns()
-{sort_virtual_member_functions(priv_->virtual_mem_fns_);}
+{
+  sort_virtual_member_functions(priv_->virtual_mem_fns_);
+  priv_->virtual_mem_fns_sorted_ = true;
+}
 
 /// Get the member function templates of this class.
 ///
@@ -9042,16 +9138,14 @@ class_decl::add_member_function(method_decl_sptr f,
   priv_->member_functions_.push_back(f);
   scope_decl::add_member_decl(f);
   if (get_member_function_is_virtual(f))
-    {
-      priv_->virtual_mem_fns_.push_back(f);
-      sort_virtual_member_functions(priv_->virtual_mem_fns_);
-    }
+    priv_->add_virtual_mem_fn(f);
 }
 
 /// When a virtual member function has seen its virtualness set by
-/// set_member_function_is_virtual(), this function ensures that the
-/// member function is added to the specific vectors of virtual member
-/// function of its class.
+/// set_member_function_is_virtual(), or its vtable offset set by
+/// set_member_function_vtable_offset(), this function ensures that
+/// the member function is added to the specific vectors of virtual
+/// member function of its class, and that their ordering is updated.
 ///
 /// @param method the method to fixup.
 void
@@ -9061,17 +9155,7 @@ fixup_virtual_member_function(class_decl::method_decl_sptr method)
     return;
 
   class_decl_sptr klass = method->get_type()->get_class_type();
-  class_decl::member_functions::iterator m;
-  for (m = klass->priv_->virtual_mem_fns_.begin();
-       m != klass->priv_->virtual_mem_fns_.end();
-       ++m)
-    if (m->get() == method.get())
-      break;
-  if (m == klass->priv_->virtual_mem_fns_.end())
-    {
-      klass->priv_->virtual_mem_fns_.push_back(method);
-      klass->sort_virtual_mem_fns();
-    }
+  klass->priv_->add_virtual_mem_fn(method);
 }
 
 /// Append a member function template to the class.
@@ -9155,15 +9239,31 @@ class_decl::get_hash() const
 /// equal, the function keeps up the comparison in order to determine
 /// the different kinds of ways in which they are different.
 ///
+/// @param ctxt the context of the comparison.
+///
 /// @return true if @p l equals @p r, false otherwise.
-bool
-equals(const class_decl& l, const class_decl& r, change_kind* k)
-{
-#define RETURN(value)				\
-  do {						\
-    l.priv_->unmark_as_being_compared(l);	\
-    l.priv_->unmark_as_being_compared(r);	\
-    return value;				\
+static bool
+equals(const class_decl& l, const class_decl& r, change_kind* k,
+       class_comparison_context& ctxt)
+{
+  // The classes this invocation marks as being compared.  A class
+  // that was marked already, by an enclosing comparison or because it
+  // is both a declaration and its own definition, is not recorded
+  // here, so that this invocation doesn't unmark it.
+  const class_decl* marked[4];
+  unsigned num_marked = 0;
+
+#define MARK(klass)					\
+  do {							\
+    if (ctxt.mark_as_being_compared(klass))		\
+      marked[num_marked++] = &(klass);			\
+  } while(0)
+
+#define RETURN(value)					\
+  do {							\
+    for (unsigned i = 0; i < num_marked; ++i)		\
+      ctxt.unmark_as_being_compared(*marked[i]);	\
+    return value;					\
   } while(0)
 
   // if one of the classes is declaration-only, look through it to
@@ -9194,12 +9294,16 @@ equals(const class_decl& l, const class_decl& r, change_kind* k)
 	  RETURN(true);
 	}
 
-      if (l.priv_->comparison_started(l)
-	  || l.priv_->comparison_started(r))
+      if (ctxt.comparison_started(l)
+	  || ctxt.comparison_started(r))
 	return true;
 
-      l.priv_->mark_as_being_compared(l);
-      l.priv_->mark_as_being_compared(r);
+      // As far as recursion is concerned, a declaration and its
+      // definition are the same class.
+      MARK(l);
+      MARK(r);
+      MARK(*def1);
+      MARK(*def2);
 
       bool val = *def1 == *def2;
       if (!val)
@@ -9217,12 +9321,12 @@ equals(const class_decl& l, const class_decl& r, change_kind* k)
       RETURN(false);
     }
 
-  if (l.priv_->comparison_started(l)
-      || l.priv_->comparison_started(r))
+  if (ctxt.comparison_started(l)
+      || ctxt.comparison_started(r))
     return true;
 
-  l.priv_->mark_as_being_compared(l);
-  l.priv_->mark_as_being_compared(r);
+  MARK(l);
+  MARK(r);
 
   bool result = true;
 
@@ -9387,6 +9491,38 @@ equals(const class_decl& l, const class_decl& r, change_kind* k)
   }
 
   RETURN(result);
+#undef RETURN
+#undef MARK
+}
+
+/// Compares two instances of @ref class_decl.
+///
+/// If the two intances are different, set a bitfield to give some
+/// insight about the kind of differences there are.
+///
+/// @param l the first artifact of the comparison.
+///
+/// @param r the second artifact of the comparison.
+///
+/// @param k a pointer to a bitfield that gives information about the
+/// kind of changes there are between @p l and @p r.  This one is set
+/// iff @p k is non-null and the function returns false.
+///
+/// Please note that setting k to a non-null value does have a
+/// negative performance impact because even if @p l and @p r are not
+/// equal, the function keeps up the comparison in order to determine
+/// the different kinds of ways in which they are different.
+///
+/// @return true if @p l equals @p r, false otherwise.
+bool
+equals(const class_decl& l, const class_decl& r, change_kind* k)
+{
+  if (class_comparison_context* ctxt =
+      class_comparison_context::get_current())
+    return equals(l, r, k, *ctxt);
+
+  class_comparison_context ctxt;
+  return equals(l, r, k, ctxt);
 }
 
 /// Comparison operator for @ref class_decl.
@@ -22,6 +22,13 @@
 
 #include <string>
 #include <iostream>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <climits>
+#include <zlib.h>
 #include "abg-libxml-utils.h"
 
 namespace abigail
@@ -51,14 +58,113 @@ namespace xml
 {
 using std::istream;
 
+/// This functor is used to instantiate a shared_ptr for an
+/// xmlTextReader that parses a memory mapped file.  It frees the
+/// reader and then unmaps the file the reader was parsing.
+struct mmaped_reader_deleter
+{
+  void*		addr_;
+  size_t	length_;
+
+  mmaped_reader_deleter(void* addr, size_t length)
+    : addr_(addr),
+      length_(length)
+  {}
+
+  void
+  operator()(xmlTextReaderPtr reader)
+  {
+    if (reader)
+      xmlFreeTextReader(reader);
+    munmap(addr_, length_);
+  }
+};
+
+/// This is an xmlInputReadCallback, meant to be passed to
+/// xmlReaderForIO.  It reads and decompresses bytes from a file
+/// compressed with gzip.
+///
+/// @param context the gzFile to read from, cast into a void*.
+///
+/// @param buffer the buffer where to copy the decompressed bytes.
+///
+/// @param len the size of @p buffer.
+///
+/// @return the number of bytes copied into @p buffer, or -1 in case
+/// of error.
+static int
+xml_gz_file_input_read(void*	context,
+		       char*	buffer,
+		       int	len)
+{return gzread(static_cast<gzFile>(context), buffer, len);}
+
+/// This is an xmlInputCloseCallback, meant to be passed to
+/// xmlReaderForIO.  It closes a file compressed with gzip.
+///
+/// @param context the gzFile to close, cast into a void*.
+///
+/// @return 0 upon successful completion, -1 otherwise.
+static int
+xml_gz_file_input_close(void* context)
+{return gzclose(static_cast<gzFile>(context)) == Z_OK ? 0 : -1;}
+
 /// Instantiate an xmlTextReader that parses the content of an on-disk
 /// file, wrap it into a smart pointer and return it.
 ///
+/// The file is memory mapped and parsed in place, so its content is
+/// never copied into an intermediate buffer.  The mapping lives as
+/// long as the returned reader.  If the file is compressed with gzip,
+/// it's decompressed on the fly as the reader consumes it.  If the
+/// file cannot be mapped (e.g, it is empty, not a regular file or too
+/// big) then the file is read through the I/O layer of libxml2
+/// instead.
+///
 /// @param path the path to the file to be parsed by the returned
 /// instance of xmlTextReader.
 reader_sptr
 new_reader_from_file(const std::string& path)
 {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd >= 0)
+    {
+      struct stat s;
+      void* addr = MAP_FAILED;
+      size_t length = 0;
+      if (fstat(fd, &s) == 0
+	  && S_ISREG(s.st_mode)
+	  && s.st_size > 0
+	  && s.st_size <= INT_MAX)
+	{
+	  length = s.st_size;
+	  addr = mmap(0, length, PROT_READ, MAP_PRIVATE, fd, 0);
+	}
+      close(fd);
+
+      if (addr != MAP_FAILED)
+	{
+	  const unsigned char* bytes = static_cast<unsigned char*>(addr);
+	  if (length >= 2 && bytes[0] == 0x1f && bytes[1] == 0x8b)
+	    {
+	      munmap(addr, length);
+	      if (gzFile f = gzopen(path.c_str(), "rb"))
+		{
+		  gzbuffer(f, 128 * 1024);
+		  return build_sptr(xmlReaderForIO(xml_gz_file_input_read,
+						   xml_gz_file_input_close,
+						   f, path.c_str(), 0, 0));
+		}
+	    }
+	  else
+	    {
+	      madvise(addr, length, MADV_SEQUENTIAL);
+	      xmlTextReaderPtr r =
+		xmlReaderForMemory(static_cast<const char*>(addr),
+				   length, path.c_str(), 0, 0);
+	      return reader_sptr(r, mmaped_reader_deleter(addr, length));
+	    }
+	}
+    }
+
   reader_sptr p =
     build_sptr(xmlNewTextReaderFilename (path.c_str()));
 
@@ -38,6 +38,7 @@
 
 #ifdef WITH_ZIP_ARCHIVE
 #include "abg-libzip-utils.h"
+#include "abg-workers.h"
 #endif
 
 namespace abigail
@@ -97,6 +98,7 @@ private:
   unordered_map<string, shared_ptr<class_tdecl> > m_class_tmpl_map;
   unordered_map<string, bool>	m_wip_classes_map;
   vector<type_base_sptr>	m_types_to_canonicalize;
+  bool				m_defer_type_canonicalization;
   string_xml_node_map		m_id_xml_node_map;
   xml_node_decl_base_sptr_map	m_xml_node_decl_map;
   xml::reader_sptr		m_reader;
@@ -106,7 +108,8 @@ private:
 
 public:
   read_context(xml::reader_sptr reader)
-    : m_reader(reader),
+    : m_defer_type_canonicalization(false),
+      m_reader(reader),
       m_exported_decls_builder_()
   {}
 
@@ -402,6 +405,36 @@ public:
   clear_type_map()
   {m_types_map.clear();}
 
+  /// Getter of the vector of types that are scheduled for being
+  /// canonicalized after the current translation unit is read.
+  ///
+  /// @return the vector of types to canonicalize.
+  vector<type_base_sptr>&
+  get_types_to_canonicalize()
+  {return m_types_to_canonicalize;}
+
+  /// Setter of the flag that says if all type canonicalization is to
+  /// be deferred to the caller of the reader.
+  ///
+  /// When this is set, types are never canonicalized while they are
+  /// read; they are all scheduled in the vector returned by
+  /// get_types_to_canonicalize().  This is used to read translation
+  /// units concurrently, as canonicalization touches process-wide
+  /// data.
+  ///
+  /// @param f the new value of the flag.
+  void
+  defer_type_canonicalization(bool f)
+  {m_defer_type_canonicalization = f;}
+
+  /// Getter of the flag that says if all type canonicalization is to
+  /// be deferred to the caller of the reader.
+  ///
+  /// @return the value of the flag.
+  bool
+  type_canonicalization_is_deferred() const
+  {return m_defer_type_canonicalization;}
+
   /// Clean the vector of types to canonicalize after the translation
   /// unit has been read.
   void
@@ -694,7 +727,8 @@ public:
     // Also, if this is a declaration-only class, wait for the end of
     // the translation unit reading so that we have its definition and
     // then we'll use that for canonicalizing it.
-    if (!type_has_non_canonicalized_subtype(t)
+    if (!type_canonicalization_is_deferred()
+	&& !type_has_non_canonicalized_subtype(t)
 	&& !is_class_decl_only)
       canonicalize(t);
     else
@@ -1283,13 +1317,15 @@ read_corpus_from_input(read_context& ctxt)
   do
     {
       translation_unit_sptr tu(new translation_unit(""));
+      tu->get_loc_mgr().set_path_table(corp.get_location_path_table());
       is_ok = read_translation_unit_from_input(ctxt, *tu);
       if (is_ok)
 	corp.add(tu);
     }
   while (is_ok);
 
-  ctxt.perform_late_type_canonicalizing();
+  if (!ctxt.type_canonicalization_is_deferred())
+    ctxt.perform_late_type_canonicalizing();
   corp.set_origin(corpus::NATIVE_XML_ORIGIN);
 
   return ctxt.get_corpus();;
@@ -2305,7 +2341,7 @@ build_type_decl(read_context&		ctxt,
   if (ctxt.push_and_key_type_decl(decl, id, add_to_current_scope))
     {
       ctxt.map_xml_node_to_decl(node, decl);
-      canonicalize(decl);
+      ctxt.maybe_canonicalize_type(decl);
       return decl;
     }
 
@@ -3091,8 +3127,9 @@ build_class_decl(read_context&		ctxt,
 		      assert(!id.empty());
 		      ctxt.key_type_decl(m, id, /*force=*/true);
 		      ctxt.map_xml_node_to_decl(p, get_type_declaration(m));
-		      if ((!is_class_type(t)
-			   || (!ctxt.is_wip_class(is_class_type(t))))
+		      if (!ctxt.type_canonicalization_is_deferred()
+			  && (!is_class_type(t)
+			      || (!ctxt.is_wip_class(is_class_type(t))))
 			  && !type_has_non_canonicalized_subtype(t))
 			canonicalize(t);
 		      else
@@ -3909,21 +3946,50 @@ read_translation_unit_from_buffer(const std::string& buffer)
   return result;
 }
 
-template<typename T>
-struct array_deleter
+#ifdef WITH_ZIP_ARCHIVE
+/// This is an xmlInputReadCallback, meant to be passed to
+/// xmlReaderForIO.  It reads a number of bytes from a file of a zip
+/// archive, directly into the input buffer of the xmlTextReader.
+///
+/// @param context a zip_file* cast into a void*.  This is the
+/// archive member that the xmlTextReader is to read data from.
+///
+/// @param buffer the buffer where to copy the data read from the
+/// archive member.
+///
+/// @param len the number of bytes to read from the archive member.
+///
+/// @return the number of bytes read or -1 in case of error.
+static int
+xml_zip_file_input_read(void*	context,
+			char*	buffer,
+			int	len)
 {
-  void
-  operator()(T* a)
-  {
-    delete [] a;
-  }
-};//end array_deleter
+  zip_file* f = reinterpret_cast<zip_file*>(context);
+  return zip_fread(f, buffer, len);
+}
+
+/// This is an xmlInputCloseCallback, meant to be passed to
+/// xmlReaderForIO.  The archive member is owned by a zip_file_sptr
+/// so this does nothing.
+///
+/// @return 0.
+static int
+xml_zip_file_input_close(void*)
+{return 0;}
 
-#ifdef WITH_ZIP_ARCHIVE
 /// Deserialize an ABI Instrumentation XML file at a given index in a
 /// zip archive, and populate a given @ref translation_unit object
 /// with the result of that de-serialization.
 ///
+/// The content of the archive member is decompressed straight into
+/// the input buffer of the XML reader; it is never copied into an
+/// intermediate buffer.
+///
+/// The types of the translation unit are not canonicalized; they
+/// are handed to the caller instead, so that this function can be
+/// invoked concurrently on several archive members.
+///
 /// @param the @ref translation_unit to populate with the result of
 /// the de-serialization.
 ///
@@ -3932,11 +3998,15 @@ struct array_deleter
 /// @param file_index the index of the ABI Instrumentation XML file to
 /// read from the zip archive.
 ///
+/// @param types_to_canonicalize output parameter.  This is set to the
+/// types of @p tu that are to be canonicalized.
+///
 /// @return true upon successful completion, false otherwise.
 static bool
-read_to_translation_unit(translation_unit& tu,
-			 zip_sptr ar,
-			 int file_index)
+read_to_translation_unit(translation_unit&		tu,
+			 zip_sptr			ar,
+			 int				file_index,
+			 vector<type_base_sptr>&	types_to_canonicalize)
 {
   if (!ar)
     return false;
@@ -3945,40 +4015,124 @@ read_to_translation_unit(translation_unit& tu,
   if (!f)
     return false;
 
-  string input;
+  // The archive member must outlive the reader, so the reader is
+  // declared after it.
+  xml::reader_sptr reader =
+    xml::build_sptr(xmlReaderForIO(&xml_zip_file_input_read,
+				   &xml_zip_file_input_close,
+				   f.get(), "", 0, 0));
+  read_context read_ctxt(reader);
+  read_ctxt.defer_type_canonicalization(true);
+  bool is_ok = read_translation_unit_from_input(read_ctxt, tu);
+  types_to_canonicalize.swap(read_ctxt.get_types_to_canonicalize());
+  return is_ok;
+}
+
+/// The result of de-serializing a member of an archive.
+struct archive_member_read_result
+{
+  translation_unit_sptr		tu;
+  vector<type_base_sptr>	types_to_canonicalize;
+  bool				is_ok;
+
+  archive_member_read_result()
+    : is_ok(false)
+  {}
+};// end struct archive_member_read_result
+
+/// A task that de-serializes some members of an archive into
+/// translation units.
+///
+/// The task de-serializes the members which indexes are @c first,
+/// @c first + @c stride, @c first + 2 * @c stride, etc.  Each task
+/// uses its own handle on the archive, as the handles of libzip
+/// cannot be used by several threads at once.
+class archive_read_task : public workers::task
+{
+  string				path_;
+  zip_sptr				archive_;
+  size_t				first_;
+  size_t				stride_;
+  vector<archive_member_read_result>&	results_;
+
+public:
+
+  /// Constructor of @ref archive_read_task.
+  ///
+  /// @param path the path to the archive.
+  ///
+  /// @param ar a handle on the archive which is only going to be used
+  /// by this task.  If it's nil, the task opens the archive at @p
+  /// path itself.
+  ///
+  /// @param first the index of the first archive member to read.
+  ///
+  /// @param stride the distance between the indexes of two archive
+  /// members read by this task.
+  ///
+  /// @param results the vector of results of all the tasks reading
+  /// the archive.  The result for the member i goes to results[i].
+  archive_read_task(const string&				path,
+		    zip_sptr					ar,
+		    size_t					first,
+		    size_t					stride,
+		    vector<archive_member_read_result>&	results)
+    : path_(path),
+      archive_(ar),
+      first_(first),
+      stride_(stride),
+      results_(results)
+  {}
+
+  virtual void
+  perform()
   {
-    // Allocate a 64K byte buffer to read the archive.
-    int buf_size = 64 * 1024;
-    shared_ptr<char> buf(new char[buf_size + 1], array_deleter<char>());
-    memset(buf.get(), 0, buf_size + 1);
-    input.reserve(buf_size);
+    zip_sptr ar = archive_;
+    if (!ar)
+      {
+	// The archive was already checked for consistency by the
+	// caller.
+	int error_code = 0;
+	ar = open_archive(path_, 0, &error_code);
+	if (error_code || !ar)
+	  return;
+      }
 
-    while (zip_fread(f.get(), buf.get(), buf_size))
+    for (size_t i = first_; i < results_.size(); i += stride_)
       {
-	input.append(buf.get());
-	memset(buf.get(), 0, buf_size + 1);
+	archive_member_read_result& r = results_[i];
+	r.tu.reset(new translation_unit(zip_get_name(ar.get(), i, 0)));
+	r.is_ok = read_to_translation_unit(*r.tu, ar, i,
+					   r.types_to_canonicalize);
       }
   }
-
-  if (!read_translation_unit_from_buffer(input, tu))
-    return false;
-
-  return true;
-}
+};// end class archive_read_task
 
 /// Read an ABI corpus from an archive file which is a ZIP archive of
 /// several ABI Instrumentation XML files.
 ///
+/// The members of the archive are de-serialized concurrently, then
+/// the resulting translation units are canonicalized and added to
+/// the corpus in the order of the archive, so that the result doesn't
+/// depend on the number of threads used.
+///
+/// @param path the path to the archive file.
+///
 /// @param ar an object representing the archive file.
 ///
 /// @param corp the ABI Corpus object to populate with the content of
 /// the archive @ref ar.
 ///
+/// @param num_threads the number of threads to use to read the
+/// archive members.
+///
 /// @return the number of ABI Instrumentation file read from the
 /// archive.
 static int
-read_corpus_from_archive(zip_sptr ar,
-			 corpus_sptr& corp)
+read_corpus_from_archive(const string&	path,
+			 zip_sptr	ar,
+			 corpus_sptr&	corp,
+			 unsigned	num_threads)
 {
   if (!ar)
     return -1;
@@ -3990,17 +4144,44 @@ read_corpus_from_archive(zip_sptr ar,
 
   // TODO: ensure abi-info descriptor is present in the archive.  Read
   // it and ensure that version numbers match.
-  for (int i = 0; i < nb_entries; ++i)
+  vector<archive_member_read_result> results(nb_entries);
+  if (num_threads > static_cast<unsigned>(nb_entries))
+    num_threads = nb_entries;
+
+  if (num_threads <= 1)
+    archive_read_task(path, ar, 0, 1, results).perform();
+  else
     {
-      shared_ptr<translation_unit>
-	tu(new translation_unit(zip_get_name(ar.get(), i, 0)));
-      if (read_to_translation_unit(*tu, ar, i))
-	{
-	  if (!corp)
-	    corp.reset(new corpus(""));
-	  corp->add(tu);
-	  ++nb_of_tu_read;
-	}
+      // libxml2 must be initialized by the main thread before it's
+      // used by the workers.
+      xmlInitParser();
+      workers::queue q(num_threads);
+      for (unsigned i = 0; i < num_threads; ++i)
+	q.schedule_task(workers::task_sptr
+			(new archive_read_task(path,
+					       i == 0 ? ar : zip_sptr(),
+					       i, num_threads, results)));
+      q.wait_for_workers_to_complete();
+    }
+
+  for (vector<archive_member_read_result>::iterator i = results.begin();
+       i != results.end();
+       ++i)
+    {
+      if (!i->is_ok)
+	continue;
+
+      for (vector<type_base_sptr>::iterator t =
+	     i->types_to_canonicalize.begin();
+	   t != i->types_to_canonicalize.end();
+	   ++t)
+	canonicalize(*t);
+      i->types_to_canonicalize.clear();
+
+      if (!corp)
+	corp.reset(new corpus(""));
+      corp->add(i->tu);
+      ++nb_of_tu_read;
     }
   if (nb_of_tu_read)
     corp->set_origin(corpus::NATIVE_XML_ORIGIN);
@@ -4015,11 +4196,15 @@ read_corpus_from_archive(zip_sptr ar,
 ///
 /// @param path the path to the archive file.
 ///
+/// @param num_threads the number of threads to use to read the
+/// members of the archive.
+///
 /// @return the number of ABI Instrument XML file read from the
 /// archive, or -1 if the file could not read.
 int
-read_corpus_from_file(corpus_sptr& corp,
-		      const string& path)
+read_corpus_from_file(corpus_sptr&	corp,
+		      const string&	path,
+		      unsigned		num_threads)
 {
   if (path.empty())
     return -1;
@@ -4030,9 +4215,24 @@ read_corpus_from_file(corpus_sptr& corp,
     return -1;
 
   assert(archive);
-  return read_corpus_from_archive(archive, corp);
+  return read_corpus_from_archive(path, archive, corp, num_threads);
 }
 
+/// Read an ABI corpus from an archive file which is a ZIP archive of
+/// several ABI Instrumentation XML files.
+///
+/// @param corp the corpus to populate with the result of reading the
+/// archive.
+///
+/// @param path the path to the archive file.
+///
+/// @return the number of ABI Instrument XML file read from the
+/// archive, or -1 if the file could not read.
+int
+read_corpus_from_file(corpus_sptr& corp,
+		      const string& path)
+{return read_corpus_from_file(corp, path, /*num_threads=*/1);}
+
 /// Read an ABI corpus from an archive file which is a ZIP archive of
 /// several ABI Instrumentation XML files.
 ///
@@ -4050,21 +4250,35 @@ read_corpus_from_file(corpus_sptr& corp)
 ///
 /// @param path the path to the archive file.
 ///
+/// @param num_threads the number of threads to use to read the
+/// members of the archive.
+///
 /// @return the resulting corpus object, or NULL if the file could not
 /// be read.
 corpus_sptr
-read_corpus_from_file(const string& path)
+read_corpus_from_file(const string& path, unsigned num_threads)
 {
   if (path.empty())
     return corpus_sptr();
 
   corpus_sptr corp(new corpus(path));
-  if (read_corpus_from_file(corp, path) < 0)
+  if (read_corpus_from_file(corp, path, num_threads) < 0)
     return corpus_sptr();
 
   return corp;
 }
 
+/// Read an ABI corpus from an archive file which is a ZIP archive of
+/// several ABI Instrumentation XML files.
+///
+/// @param path the path to the archive file.
+///
+/// @return the resulting corpus object, or NULL if the file could not
+/// be read.
+corpus_sptr
+read_corpus_from_file(const string& path)
+{return read_corpus_from_file(path, /*num_threads=*/1);}
+
 #endif //WITH_ZIP_ARCHIVE
 
 /// De-serialize an ABI corpus from an input XML document which root
@@ -4110,6 +4324,38 @@ read_corpus_from_native_xml_file(const string& path)
   return corp;
 }
 
+/// De-serialize an ABI corpus from an XML document file which root
+/// node is 'abi-corpus', without canonicalizing its types.
+///
+/// The types of the corpus are handed back to the caller instead,
+/// which has to canonicalize them, in order, before the corpus is
+/// compared to anything.  This allows measuring the canonicalization
+/// of types separately from the reading.
+///
+/// @param path the path to the input file to read the XML document
+/// from.
+///
+/// @param types_to_canonicalize output parameter.  This is set to the
+/// types of the corpus, which are to be canonicalized.
+///
+/// @return the resulting corpus de-serialized from the parsing.  This
+/// is non-null if the parsing successfully resulted in a corpus.
+corpus_sptr
+read_corpus_from_native_xml_file(const string&			path,
+				 vector<type_base_sptr>&	types_to_canonicalize)
+{
+  read_context read_ctxt(xml::new_reader_from_file(path));
+  read_ctxt.defer_type_canonicalization(true);
+  corpus_sptr corp = read_corpus_from_input(read_ctxt);
+  if (corp)
+    {
+      if (corp->get_path().empty())
+	corp->set_path(path);
+    }
+  types_to_canonicalize.swap(read_ctxt.get_types_to_canonicalize());
+  return corp;
+}
+
 }//end namespace xml_reader
 
 }//end namespace abigail
@@ -23,11 +23,17 @@
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/resource.h>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <algorithm>
+#include <vector>
 #include <libgen.h>
 #include <fstream>
 #include <iostream>
+#include <sstream>
+#include <zlib.h>
 #include <abg-ir.h>
 #include "abg-tools-utils.h"
 
@@ -385,6 +391,9 @@ guess_file_type(istream& in)
 
 /// Guess the type of the content of an file.
 ///
+/// If the file is compressed with gzip, then the type of its
+/// decompressed content is guessed.
+///
 /// @param file_path the path to the file to consider.
 ///
 /// @return the type of content guessed.
@@ -392,6 +401,26 @@ file_type
 guess_file_type(const string& file_path)
 {
   ifstream in(file_path.c_str(), ifstream::binary);
+  char magic[2] = {0, 0};
+  in.read(magic, sizeof(magic));
+  in.seekg(0);
+  if (in.gcount() == 2
+      && static_cast<unsigned char>(magic[0]) == 0x1f
+      && static_cast<unsigned char>(magic[1]) == 0x8b)
+    {
+      in.close();
+      gzFile f = gzopen(file_path.c_str(), "rb");
+      if (!f)
+	return FILE_TYPE_UNKNOWN;
+      char buf[12];
+      int len = gzread(f, buf, sizeof(buf));
+      gzclose(f);
+      if (len <= 0)
+	return FILE_TYPE_UNKNOWN;
+      std::istringstream content(string(buf, len));
+      return guess_file_type(content);
+    }
+
   file_type r = guess_file_type(in);
   in.close();
   return r;
@@ -435,6 +464,318 @@ make_path_absolute(const char*p)
   return result;
 }
 
+/// Emit a string as a JSON string literal.
+///
+/// The string is emitted between double quotes, with the double
+/// quotes, the back slashes and the control characters it contains
+/// escaped as mandated by RFC 7159.  The runs of characters that
+/// need no escaping are written to the output stream in one go.
+///
+/// @param s the string to emit.
+///
+/// @param out the output stream to emit the string literal to.
+void
+emit_json_string(const string& s, ostream& out)
+{
+  out << '"';
+  const char* run = s.data();
+  const char* end = s.data() + s.size();
+  for (const char* c = run; c != end; ++c)
+    {
+      unsigned char u = *c;
+      if (u >= 0x20 && u != '"' && u != '\\')
+	continue;
+      out.write(run, c - run);
+      run = c + 1;
+      switch (u)
+	{
+	case '"':
+	  out << "\\\"";
+	  break;
+	case '\\':
+	  out << "\\\\";
+	  break;
+	case '\n':
+	  out << "\\n";
+	  break;
+	case '\t':
+	  out << "\\t";
+	  break;
+	default:
+	  {
+	    char buf[8];
+	    snprintf(buf, sizeof(buf), "\\u%04x", u);
+	    out << buf;
+	  }
+	}
+    }
+  out.write(run, end - run);
+  out << '"';
+}
+
+/// Get the peak resident set size of the current process, that is,
+/// the maximum amount of physical memory it has used so far.
+///
+/// @return the peak resident set size, in kilobytes, or zero if it
+/// could not be determined.
+size_t
+get_peak_resident_set_size()
+{
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage))
+    return 0;
+  // On Linux, ru_maxrss is expressed in kilobytes.
+  return usage.ru_maxrss;
+}
+
+/// Get the directory in which to create temporary files.
+///
+/// @return the value of the TMPDIR environment variable if it's set
+/// and not empty, or /tmp otherwise.
+string
+get_temporary_directory()
+{
+  const char* dir = getenv("TMPDIR");
+  return dir && *dir ? dir : "/tmp";
+}
+
+/// The private data of @ref file_comparing_streambuf.
+struct file_comparing_streambuf::priv
+{
+  gzFile		file;
+  std::vector<char>	buffer;
+  // The unread part of the buffer is [pos, end).
+  size_t		pos;
+  size_t		end;
+  // The number of the current line, starting at 1.
+  size_t		line;
+  // The characters of the current line seen so far, which are the
+  // same in the file and in the written characters.
+  string		line_prefix;
+  bool			differs;
+  // True if the whole actual line that differs has been written.
+  bool			actual_line_is_complete;
+  string		expected_line;
+  string		actual_line;
+
+  priv(const string& path)
+    : file(gzopen(path.c_str(), "rb")),
+      buffer(128 * 1024),
+      pos(0),
+      end(0),
+      line(1),
+      differs(false),
+      actual_line_is_complete(false)
+  {}
+
+  /// Make sure there are unread characters in the buffer, reading
+  /// them from the file if necessary.
+  ///
+  /// @return false iff the end of the file is reached.
+  bool
+  fill_buffer()
+  {
+    if (pos < end)
+      return true;
+    if (!file)
+      return false;
+    int n = gzread(file, &buffer[0], buffer.size());
+    if (n <= 0)
+      return false;
+    pos = 0;
+    end = n;
+    return true;
+  }
+
+  /// Update the line number and the current line prefix with
+  /// characters that are the same in the file and in the written
+  /// characters.
+  ///
+  /// @param s the characters to consider.
+  ///
+  /// @param n the number of characters pointed to by @p s.
+  void
+  track_lines(const char* s, size_t n)
+  {
+    const char* last_newline = 0;
+    for (const char* c = std::find(s, s + n, '\n');
+	 c != s + n;
+	 c = std::find(c + 1, s + n, '\n'))
+      {
+	++line;
+	last_newline = c;
+      }
+    if (last_newline)
+      line_prefix.assign(last_newline + 1, s + n);
+    else
+      line_prefix.append(s, n);
+  }
+
+  /// Record the end of the line that differs, from the written
+  /// characters.
+  ///
+  /// @param s the characters to consider.
+  ///
+  /// @param n the number of characters pointed to by @p s.
+  void
+  append_to_actual_line(const char* s, size_t n)
+  {
+    if (actual_line_is_complete)
+      return;
+    const char* newline = std::find(s, s + n, '\n');
+    actual_line.append(s, newline);
+    actual_line_is_complete = newline != s + n;
+  }
+
+  /// Record the first difference between the file and the written
+  /// characters.
+  ///
+  /// @param s the written characters, starting at the first one that
+  /// differs.
+  ///
+  /// @param n the number of characters pointed to by @p s.
+  void
+  record_difference(const char* s, size_t n)
+  {
+    differs = true;
+
+    expected_line = line_prefix;
+    while (fill_buffer())
+      {
+	const char* b = &buffer[pos];
+	const char* e = &buffer[0] + end;
+	const char* newline = std::find(b, e, '\n');
+	expected_line.append(b, newline);
+	pos = newline - &buffer[0];
+	if (pos < end)
+	  break;
+      }
+
+    actual_line = line_prefix;
+    append_to_actual_line(s, n);
+  }
+
+  /// Compare written characters against the content of the file.
+  ///
+  /// @param s the written characters.
+  ///
+  /// @param n the number of characters pointed to by @p s.
+  void
+  compare(const char* s, size_t n)
+  {
+    if (differs)
+      {
+	append_to_actual_line(s, n);
+	return;
+      }
+
+    while (n)
+      {
+	if (!fill_buffer())
+	  {
+	    record_difference(s, n);
+	    return;
+	  }
+	size_t len = std::min(n, end - pos);
+	std::pair<const char*, char*> m =
+	  std::mismatch(s, s + len, &buffer[pos]);
+	size_t same = m.first - s;
+	track_lines(s, same);
+	pos += same;
+	s += same;
+	n -= same;
+	if (same < len)
+	  {
+	    record_difference(s, n);
+	    return;
+	  }
+      }
+  }
+
+  ~priv()
+  {
+    if (file)
+      gzclose(file);
+  }
+};// end struct file_comparing_streambuf::priv
+
+/// Constructor of @ref file_comparing_streambuf.
+///
+/// @param path the path to the file to compare the written
+/// characters against.
+file_comparing_streambuf::file_comparing_streambuf(const string& path)
+  : priv_(new priv(path))
+{}
+
+/// @return true iff the file to compare against could be opened.
+bool
+file_comparing_streambuf::is_open() const
+{return priv_->file != 0;}
+
+/// Compare a written character against the content of the file.
+///
+/// @param c the written character.
+///
+/// @return @p c, or EOF if @p c is EOF.
+file_comparing_streambuf::int_type
+file_comparing_streambuf::overflow(int_type c)
+{
+  if (traits_type::eq_int_type(c, traits_type::eof()))
+    return traits_type::eof();
+  char ch = traits_type::to_char_type(c);
+  priv_->compare(&ch, 1);
+  return c;
+}
+
+/// Compare written characters against the content of the file.
+///
+/// @param s the written characters.
+///
+/// @param n the number of characters pointed to by @p s.
+///
+/// @return @p n.
+std::streamsize
+file_comparing_streambuf::xsputn(const char* s, std::streamsize n)
+{
+  priv_->compare(s, n);
+  return n;
+}
+
+/// Compare the end of the file, once all the characters have been
+/// written.
+///
+/// @return true iff the written characters are the same as the
+/// content of the file.
+bool
+file_comparing_streambuf::finish()
+{
+  if (!priv_->differs && priv_->fill_buffer())
+    // The file is longer than what was written.
+    priv_->record_difference(0, 0);
+  return !priv_->differs;
+}
+
+/// @return the number of the first line that differs, starting at
+/// 1.  This is meaningful only if file_comparing_streambuf::finish()
+/// returned false.
+size_t
+file_comparing_streambuf::get_line_of_first_difference() const
+{return priv_->line;}
+
+/// @return the first line that differs, as found in the file.
+const string&
+file_comparing_streambuf::get_expected_line() const
+{return priv_->expected_line;}
+
+/// @return the first line that differs, as found in the written
+/// characters.
+const string&
+file_comparing_streambuf::get_actual_line() const
+{return priv_->actual_line;}
+
+file_comparing_streambuf::~file_comparing_streambuf()
+{}
+
 }//end namespace tools_utils
 
 using abigail::ir::function_decl;
@@ -0,0 +1,253 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (C) 2013-2015 Red Hat, Inc.
+//
+// This file is part of the GNU Application Binary Interface Generic
+// Analysis and Instrumentation Library (libabigail).  This library is
+// free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option) any
+// later version.
+
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this program; see the file COPYING-LGPLV3.  If
+// not, see <http://www.gnu.org/licenses/>.
+
+/// @file
+///
+/// This file implements the queue of tasks performed by a pool of
+/// worker threads, on top of POSIX threads.
+
+#include <unistd.h>
+#include <pthread.h>
+#include <deque>
+#include "abg-workers.h"
+
+namespace abigail
+{
+
+namespace workers
+{
+
+using std::deque;
+
+/// @return the number of processors that are currently online.  This
+/// is a sensible default for the number of worker threads of a @ref
+/// queue.
+size_t
+get_number_of_threads()
+{
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  if (n < 1)
+    return 1;
+  return n;
+}
+
+task::~task()
+{}
+
+/// The private data of @ref queue.
+///
+/// All the data members below the mutex are protected by it.
+struct queue::priv
+{
+  vector<pthread_t>	workers;
+  pthread_mutex_t	lock;
+  // Signaled when a task is scheduled or when the workers are to be
+  // brought down.
+  pthread_cond_t	tasks_todo_cond;
+  // Signaled when the last pending task is done.
+  pthread_cond_t	tasks_done_cond;
+  deque<task_sptr>	tasks_todo;
+  size_t		num_pending_tasks;
+  bool			bring_workers_down;
+
+  priv()
+    : num_pending_tasks(0),
+      bring_workers_down(false)
+  {
+    pthread_mutex_init(&lock, 0);
+    pthread_cond_init(&tasks_todo_cond, 0);
+    pthread_cond_init(&tasks_done_cond, 0);
+  }
+
+  /// Create the worker threads.
+  ///
+  /// @param n the number of workers to create.  If no thread can be
+  /// created, then the tasks are going to be performed by the thread
+  /// which schedules them.
+  void
+  create_workers(unsigned n)
+  {
+    for (unsigned i = 0; i < n; ++i)
+      {
+	pthread_t t;
+	if (pthread_create(&t, 0, &priv::wait_to_execute_a_task, this))
+	  break;
+	workers.push_back(t);
+      }
+  }
+
+  /// The entry point of the worker threads.
+  ///
+  /// Pick tasks from the queue and perform them, until the workers
+  /// are brought down.
+  ///
+  /// @param p a pointer to the instance of @ref queue::priv the
+  /// worker belongs to.
+  ///
+  /// @return NULL.
+  static void*
+  wait_to_execute_a_task(void* p)
+  {
+    priv* q = static_cast<priv*>(p);
+    for (;;)
+      {
+	pthread_mutex_lock(&q->lock);
+	while (q->tasks_todo.empty() && !q->bring_workers_down)
+	  pthread_cond_wait(&q->tasks_todo_cond, &q->lock);
+	if (q->tasks_todo.empty())
+	  {
+	    pthread_mutex_unlock(&q->lock);
+	    break;
+	  }
+	task_sptr t = q->tasks_todo.front();
+	q->tasks_todo.pop_front();
+	pthread_mutex_unlock(&q->lock);
+
+	t->perform();
+
+	pthread_mutex_lock(&q->lock);
+	if (--q->num_pending_tasks == 0)
+	  pthread_cond_broadcast(&q->tasks_done_cond);
+	pthread_mutex_unlock(&q->lock);
+      }
+    return 0;
+  }
+
+  /// Add a task to the queue and wake up a worker to perform it.
+  ///
+  /// @param t the task to schedule.
+  void
+  schedule_task(const task_sptr& t)
+  {
+    if (workers.empty())
+      {
+	t->perform();
+	return;
+      }
+
+    pthread_mutex_lock(&lock);
+    tasks_todo.push_back(t);
+    ++num_pending_tasks;
+    pthread_cond_signal(&tasks_todo_cond);
+    pthread_mutex_unlock(&lock);
+  }
+
+  /// Wait until all the scheduled tasks are performed.
+  void
+  wait_for_workers_to_complete()
+  {
+    pthread_mutex_lock(&lock);
+    while (num_pending_tasks)
+      pthread_cond_wait(&tasks_done_cond, &lock);
+    pthread_mutex_unlock(&lock);
+  }
+
+  /// Perform the pending tasks, then bring the workers down and wait
+  /// for them to terminate.
+  void
+  bring_down_workers()
+  {
+    pthread_mutex_lock(&lock);
+    bring_workers_down = true;
+    pthread_cond_broadcast(&tasks_todo_cond);
+    pthread_mutex_unlock(&lock);
+
+    for (vector<pthread_t>::iterator i = workers.begin();
+	 i != workers.end();
+	 ++i)
+      pthread_join(*i, 0);
+    workers.clear();
+  }
+
+  ~priv()
+  {
+    bring_down_workers();
+    pthread_cond_destroy(&tasks_done_cond);
+    pthread_cond_destroy(&tasks_todo_cond);
+    pthread_mutex_destroy(&lock);
+  }
+};// end struct queue::priv
+
+/// Default constructor of @ref queue.
+///
+/// It creates as many workers as there are processors online.
+queue::queue()
+  : priv_(new priv)
+{priv_->create_workers(get_number_of_threads());}
+
+/// Constructor of @ref queue.
+///
+/// @param number_of_workers the number of worker threads to create.
+/// If this is zero, then the tasks are performed by the thread that
+/// schedules them, in the order they are scheduled.
+queue::queue(unsigned number_of_workers)
+  : priv_(new priv)
+{priv_->create_workers(number_of_workers);}
+
+/// @return the number of worker threads of the queue.
+size_t
+queue::get_size() const
+{return priv_->workers.size();}
+
+/// Schedule a task to be performed by a worker thread.
+///
+/// @param t the task to schedule.
+///
+/// @return true upon successful completion.
+bool
+queue::schedule_task(const task_sptr& t)
+{
+  if (!t)
+    return false;
+  priv_->schedule_task(t);
+  return true;
+}
+
+/// Schedule a set of tasks to be performed by the worker threads.
+///
+/// @param tasks the tasks to schedule.
+///
+/// @return true upon successful completion.
+bool
+queue::schedule_tasks(const vector<task_sptr>& tasks)
+{
+  bool is_ok = true;
+  for (vector<task_sptr>::const_iterator i = tasks.begin();
+       i != tasks.end();
+       ++i)
+    if (!schedule_task(*i))
+      is_ok = false;
+  return is_ok;
+}
+
+/// Wait until all the tasks scheduled so far are performed.
+void
+queue::wait_for_workers_to_complete()
+{priv_->wait_for_workers_to_complete();}
+
+/// Destructor of @ref queue.
+///
+/// It waits for the scheduled tasks to be performed and then brings
+/// the worker threads down.
+queue::~queue()
+{}
+
+}// end namespace workers
+}// end namespace abigail
@@ -31,15 +31,19 @@
 #include <sstream>
 #include <vector>
 #include <tr1/unordered_map>
+#include <tr1/unordered_set>
+#include <zlib.h>
 #include "abg-config.h"
 #include "abg-corpus.h"
 
 #if WITH_ZIP_ARCHIVE
 #include "abg-libzip-utils.h"
+#include "abg-workers.h"
 #endif
 
 #include "abg-writer.h"
 #include "abg-libxml-utils.h"
+#include "abg-sptr-utils.h"
 
 namespace abigail
 {
@@ -53,6 +57,8 @@ using std::ostringstream;
 using std::list;
 using std::vector;
 using std::tr1::unordered_map;
+using std::tr1::unordered_set;
+using abigail::sptr_utils::noop_deleter;
 
 #if WITH_ZIP_ARCHIVE
 using zip_utils::zip_sptr;
@@ -68,6 +74,101 @@ using zip_utils::open_file_in_archive;
 namespace xml_writer
 {
 
+/// A stream buffer that compresses the characters written to it into
+/// a file, in the gzip format.
+///
+/// The characters are accumulated into a buffer that is handed over
+/// to zlib each time it's full, so the whole document is never held
+/// in memory.
+class gzip_file_streambuf : public std::streambuf
+{
+  gzFile	file_;
+  vector<char>	buffer_;
+
+  // Forbid copy.
+  gzip_file_streambuf(const gzip_file_streambuf&);
+  gzip_file_streambuf& operator=(const gzip_file_streambuf&);
+
+  /// Compress the content of the buffer into the file, and empty the
+  /// buffer.
+  ///
+  /// @return true upon successful completion.
+  bool
+  flush_buffer()
+  {
+    int len = pptr() - pbase();
+    if (len && gzwrite(file_, pbase(), len) != len)
+      return false;
+    setp(&buffer_[0], &buffer_[0] + buffer_.size());
+    return true;
+  }
+
+protected:
+  virtual int_type
+  overflow(int_type c)
+  {
+    if (!file_ || !flush_buffer())
+      return traits_type::eof();
+    if (!traits_type::eq_int_type(c, traits_type::eof()))
+      {
+	*pptr() = traits_type::to_char_type(c);
+	pbump(1);
+      }
+    return traits_type::not_eof(c);
+  }
+
+  virtual int
+  sync()
+  {return file_ && flush_buffer() ? 0 : -1;}
+
+public:
+  /// Constructor of @ref gzip_file_streambuf.
+  ///
+  /// @param path the path to the file to write to.  It's truncated
+  /// if it exists.
+  gzip_file_streambuf(const string& path)
+    : file_(gzopen(path.c_str(), "wb")),
+      buffer_(128 * 1024)
+  {setp(&buffer_[0], &buffer_[0] + buffer_.size());}
+
+  /// @return true iff the file could be opened.
+  bool
+  is_open() const
+  {return file_ != 0;}
+
+  /// Flush the buffer and close the file.
+  ///
+  /// @return true iff all the characters written to the stream buffer
+  /// could be compressed into the file.
+  bool
+  close()
+  {
+    if (!file_)
+      return false;
+    bool is_ok = flush_buffer();
+    if (gzclose(file_) != Z_OK)
+      is_ok = false;
+    file_ = 0;
+    return is_ok;
+  }
+
+  ~gzip_file_streambuf()
+  {close();}
+};// end class gzip_file_streambuf
+
+/// Test if the content of a file is to be compressed with gzip,
+/// depending on its path.
+///
+/// @param path the path to consider.
+///
+/// @return true iff @p path ends with ".gz".
+static bool
+path_has_gzip_suffix(const string& path)
+{
+  return (path.size() > 3
+	  && path.compare(path.size() - 3, 3, ".gz") == 0);
+}
+
 class id_manager
 {
   unsigned long long m_cur_id;
@@ -165,6 +266,8 @@ public:
       {
 	string id = get_id_manager().get_id_with_prefix("type-id-");
 	m_type_id_map[t] = id;
+	if (!m_corpus_tus.empty())
+	  m_types_given_an_id.push_back(t);
 	return id;
       }
     return it->second;
@@ -200,6 +303,46 @@ public:
   clear_type_id_map()
   {m_type_id_map.clear();}
 
+  /// Setter of the translation units of the corpus being serialized.
+  ///
+  /// Once they are set, the context records the types it gives an
+  /// id to, so that the types that belong to no translation unit of
+  /// the corpus can be serialized too.  See
+  /// write_types_of_other_translation_units().
+  ///
+  /// @param tus the translation units of the corpus.
+  void
+  set_corpus_translation_units(const translation_units& tus)
+  {
+    for (translation_units::const_iterator i = tus.begin();
+	 i != tus.end();
+	 ++i)
+      m_corpus_tus.insert(i->get());
+  }
+
+  /// Test if a translation unit belongs to the corpus being
+  /// serialized.
+  ///
+  /// @param tu the translation unit to consider.
+  ///
+  /// @return true iff @p tu was passed to
+  /// set_corpus_translation_units().
+  bool
+  is_corpus_translation_unit(const translation_unit* tu) const
+  {return m_corpus_tus.find(tu) != m_corpus_tus.end();}
+
+  /// Get the types given an id since the last invocation of this
+  /// function.
+  ///
+  /// @param types output parameter.  It's set to the types given an
+  /// id, in the order in which they were given one.
+  void
+  take_types_given_an_id(vector<type_base*>& types)
+  {
+    types.clear();
+    types.swap(m_types_given_an_id);
+  }
+
   const string_elf_symbol_sptr_map_type&
   get_fun_symbol_map() const
   {return m_fun_symbol_map;}
@@ -217,10 +360,15 @@ private:
   class_tmpl_shared_ptr_map m_class_tmpl_id_map;
   string_elf_symbol_sptr_map_type m_fun_symbol_map;
   string_elf_symbol_sptr_map_type m_var_symbol_map;
+  unordered_set<const translation_unit*> m_corpus_tus;
+  vector<type_base*> m_types_given_an_id;
 }; //end write_context
 
 static bool write_translation_unit(const translation_unit&,
 				   write_context&, unsigned);
+static void write_types_of_other_translation_units(const translation_unit&,
+						   write_context&,
+						   unsigned);
 static void write_location(location, translation_unit&, ostream&);
 static void write_location(const shared_ptr<decl_base>&, ostream&);
 static bool write_visibility(const shared_ptr<decl_base>&, ostream&);
@@ -890,6 +1038,9 @@ write_translation_unit(const translation_unit&	tu,
       write_decl(*i, ctxt, indent + c.get_xml_element_indent());
     }
 
+  write_types_of_other_translation_units(tu, ctxt,
+					 indent + c.get_xml_element_indent());
+
   o << "\n";
   do_indent(o, indent);
   o << "</abi-instr>\n";
@@ -897,6 +1048,113 @@ write_translation_unit(const translation_unit&	tu,
   return true;
 }
 
+/// Collect the ids of the types declared in a scope and in the
+/// namespaces it contains.
+///
+/// @param scope the scope to consider.
+///
+/// @param ctxt the context of the serialization.
+///
+/// @param ids the set to add the ids to.
+static void
+collect_ids_of_member_types(const scope_decl&		scope,
+			    write_context&		ctxt,
+			    unordered_set<string>&	ids)
+{
+  typedef scope_decl::declarations		declarations;
+  typedef declarations::const_iterator const_iterator;
+  const declarations& d = scope.get_member_decls();
+
+  for (const_iterator i = d.begin(); i != d.end(); ++i)
+    if (namespace_decl* n = dynamic_cast<namespace_decl*>(i->get()))
+      collect_ids_of_member_types(*n, ctxt, ids);
+    else if (type_base* t = is_type(i->get()))
+      ids.insert(ctxt.get_id_for_type(t));
+}
+
+/// Serialize the types referred to by a translation unit that belong
+/// to no translation unit of the corpus being serialized.
+///
+/// This happens when the corpus shares types with other corpora,
+/// like the types built from an alternate debug info file that is
+/// shared by several binaries.  These types are serialized at the
+/// end of the first translation unit that refers to them, in the
+/// namespaces they are declared in.  The types they refer to are
+/// serialized as well.
+///
+/// Nothing is done unless the translation units of the corpus were
+/// set with write_context::set_corpus_translation_units().
+///
+/// @param tu the translation unit which members were just
+/// serialized.
+///
+/// @param ctxt the context of the serialization.
+///
+/// @param indent how many indentation spaces to use for the types.
+static void
+write_types_of_other_translation_units(const translation_unit&	tu,
+				       write_context&		ctxt,
+				       unsigned			indent)
+{
+  vector<type_base*> types;
+  ctxt.take_types_given_an_id(types);
+  if (types.empty())
+    return;
+
+  ostream& o = ctxt.get_ostream();
+  const config& c = ctxt.get_config();
+  unordered_set<string> ids;
+  collect_ids_of_member_types(*tu.get_global_scope(), ctxt, ids);
+
+  for (; !types.empty(); ctxt.take_types_given_an_id(types))
+    for (vector<type_base*>::const_iterator t = types.begin();
+	 t != types.end();
+	 ++t)
+      {
+	decl_base* decl = get_type_declaration(*t);
+	if (!decl)
+	  continue;
+
+	const translation_unit* decl_tu = get_translation_unit(decl);
+	if (!decl_tu || ctxt.is_corpus_translation_unit(decl_tu))
+	  continue;
+
+	vector<namespace_decl*> namespaces;
+	scope_decl* scope = decl->get_scope();
+	for (; scope && !is_global_scope(scope); scope = scope->get_scope())
+	  if (namespace_decl* n = dynamic_cast<namespace_decl*>(scope))
+	    namespaces.push_back(n);
+	  else
+	    break;
+	if (!scope
+	    || !is_global_scope(scope)
+	    || !ids.insert(ctxt.get_id_for_type(*t)).second)
+	  continue;
+
+	unsigned i = indent;
+	for (vector<namespace_decl*>::const_reverse_iterator n =
+	       namespaces.rbegin();
+	     n != namespaces.rend();
+	     ++n, i += c.get_xml_element_indent())
+	  {
+	    o << "\n";
+	    do_indent(o, i);
+	    o << "<namespace-decl name='" << (*n)->get_name() << "'>";
+	  }
+
+	o << "\n";
+	write_decl(decl_base_sptr(decl, noop_deleter()), ctxt, i);
+
+	for (size_t n = 0; n < namespaces.size(); ++n)
+	  {
+	    i -= c.get_xml_element_indent();
+	    o << "\n";
+	    do_indent(o, i);
+	    o << "</namespace-decl>";
+	  }
+      }
+}
+
 /// Serialize a translation unit to an output stream.
 ///
 /// @param tu the translation unit to serialize.
@@ -918,6 +1176,9 @@ write_translation_unit(const translation_unit&	tu,
 
 /// Serialize a translation unit to a file.
 ///
+/// If the path of the file ends with ".gz", the file is compressed
+/// with gzip as it's written.
+///
 /// @param tu the translation unit to serialize.
 ///
 /// @param indent how many indentation spaces to use during the
@@ -933,6 +1194,23 @@ write_translation_unit(const translation_unit&	tu,
 {
   bool result = true;
 
+  if (path_has_gzip_suffix(path))
+    {
+      gzip_file_streambuf buf(path);
+      ostream of(&buf);
+      if (!buf.is_open())
+	{
+	  cerr << "failed to access " << path << "\n";
+	  return false;
+	}
+      if (!write_translation_unit(tu, indent, of) || !buf.close())
+	{
+	  cerr << "failed to write to " << path << "\n";
+	  result = false;
+	}
+      return result;
+    }
+
   try
     {
       ofstream of(path.c_str(), std::ios_base::trunc);
@@ -2350,10 +2628,15 @@ create_archive_write_context(const string& archive_path)
   return r;
 }
 
-/// Write a translation unit to an on-disk archive.  The archive is a
-/// zip archive of ABI Instrumentation files in XML format.
+/// Add a serialized translation unit to an on-disk archive.  The
+/// archive is a zip archive of ABI Instrumentation files in XML
+/// format.
 ///
-/// @param tu the translation unit to serialize.
+/// @param tu the translation unit that was serialized.
+///
+/// @param serialized_tu the result of the serialization of @p tu.
+/// The content of this string is moved into @p ctxt, and the string
+/// is left empty.
 ///
 /// @param ctxt the context of the serialization.  Contains
 /// information about where the archive is on disk, the zip archive,
@@ -2362,16 +2645,15 @@ create_archive_write_context(const string& archive_path)
 /// @return true upon succesful serialization occured, false
 /// otherwise.
 static bool
-write_translation_unit_to_archive(const translation_unit& tu,
-				  archive_write_ctxt& ctxt)
+add_serialized_translation_unit_to_archive(const translation_unit& tu,
+					   string& serialized_tu,
+					   archive_write_ctxt& ctxt)
 {
   if (!ctxt.archive)
     return false;
 
-  ostringstream os;
-  if (!write_translation_unit(tu, /*indent=*/0, os))
-    return false;
-  ctxt.serialized_tus.push_back(os.str());
+  ctxt.serialized_tus.push_back(string());
+  ctxt.serialized_tus.back().swap(serialized_tu);
 
   zip_source *source;
   if ((source = zip_source_buffer(ctxt.archive.get(),
@@ -2390,29 +2672,191 @@ write_translation_unit_to_archive(const translation_unit& tu,
   return true;
 }
 
- /// Serialize a given corpus to disk in a file at a given path.
- ///
- /// @param tu the translation unit to serialize.
- ///
- /// @param ctxt the context of the serialization.  Contains
- /// information about where the archive is on disk, the zip archive
- /// object, and the buffers holding the temporary data to be flushed
- /// into the archive.
- ///
- /// @return true upon successful completion, false otherwise.
+/// The result of serializing a translation unit to be added to an
+/// archive.
+struct archive_member_write_result
+{
+  string	serialized_tu;
+  bool		is_ok;
+
+  archive_member_write_result()
+    : is_ok(false)
+  {}
+};// end struct archive_member_write_result
+
+/// A visitor that computes the properties of IR nodes that are
+/// computed lazily, and cached in the nodes, when they are first
+/// requested.
+///
+/// The serialization of a translation unit requests the hash values
+/// of its types, the qualified names of its decls, the virtual
+/// member functions of its classes sorted by vtable offset and the ID
+/// strings of the ELF symbols of its decls.  Nodes can be shared by
+/// several translation units, e.g, the void type or the classes that
+/// the DWARF reader deduplicates.  So these properties must be
+/// computed before the translation units are serialized concurrently.
+class lazy_properties_visitor : public ir_node_visitor
+{
+  unordered_set<const type_base*>	visited_types_;
+  unordered_set<const decl_base*>	visited_decls_;
+
+  /// Compute the lazy properties of a decl.
+  ///
+  /// @param d the decl to consider.
+  void
+  compute_decl_properties(const decl_base* d)
+  {
+    d->get_qualified_name();
+    if (const var_decl* v = dynamic_cast<const var_decl*>(d))
+      {
+	if (elf_symbol_sptr s = v->get_symbol())
+	  s->get_id_string();
+      }
+    else if (const function_decl* f = dynamic_cast<const function_decl*>(d))
+      if (elf_symbol_sptr s = f->get_symbol())
+	s->get_id_string();
+  }
+
+public:
+
+  bool
+  visit_begin(decl_base* d)
+  {
+    if (!visited_decls_.insert(d).second)
+      return false;
+    compute_decl_properties(d);
+    return true;
+  }
+
+  bool
+  visit_begin(type_base* t)
+  {
+    if (!visited_types_.insert(t).second)
+      return false;
+    if (decl_base* d = get_type_declaration(t))
+      {
+	compute_decl_properties(d);
+	d->get_hash();
+      }
+    return true;
+  }
+
+  bool
+  visit_begin(class_decl* c)
+  {
+    if (!visit_begin(static_cast<type_base*>(c)))
+      return false;
+    c->get_virtual_mem_fns();
+    return true;
+  }
+};// end class lazy_properties_visitor
+
+/// A task that serializes some translation units of a corpus, to be
+/// added to an archive.
+///
+/// The task serializes the translation units which indexes are @c
+/// first, @c first + @c stride, @c first + 2 * @c stride, etc.
+class archive_write_task : public workers::task
+{
+  const vector<translation_unit_sptr>&	tus_;
+  size_t				first_;
+  size_t				stride_;
+  vector<archive_member_write_result>&	results_;
+
+public:
+
+  /// Constructor of @ref archive_write_task.
+  ///
+  /// @param tus the translation units of the corpus.
+  ///
+  /// @param first the index of the first translation unit to
+  /// serialize.
+  ///
+  /// @param stride the distance between the indexes of two
+  /// translation units serialized by this task.
+  ///
+  /// @param results the results of the serializations of all the
+  /// tasks.  The result for the translation unit i goes to
+  /// results[i].
+  archive_write_task(const vector<translation_unit_sptr>&	tus,
+		     size_t					first,
+		     size_t					stride,
+		     vector<archive_member_write_result>&	results)
+    : tus_(tus),
+      first_(first),
+      stride_(stride),
+      results_(results)
+  {}
+
+  virtual void
+  perform()
+  {
+    for (size_t i = first_; i < tus_.size(); i += stride_)
+      {
+	ostringstream os;
+	results_[i].is_ok = write_translation_unit(*tus_[i], /*indent=*/0, os);
+	if (results_[i].is_ok)
+	  results_[i].serialized_tu = os.str();
+      }
+  }
+};// end class archive_write_task
+
+/// Serialize a given corpus to disk in a file at a given path.
+///
+/// The translation units are serialized concurrently, then added to
+/// the archive in the order of the corpus.
+///
+/// @param corp the corpus to serialize.
+///
+/// @param ctxt the context of the serialization.  Contains
+/// information about where the archive is on disk, the zip archive
+/// object, and the buffers holding the temporary data to be flushed
+/// into the archive.
+///
+/// @param num_threads the number of threads to use to serialize the
+/// translation units.
+///
+/// @return true upon successful completion, false otherwise.
 static bool
 write_corpus_to_archive(const corpus& corp,
-			archive_write_ctxt& ctxt)
-{
-  for (translation_units::const_iterator i =
-	 corp.get_translation_units().begin();
-       i != corp.get_translation_units().end();
+			archive_write_ctxt& ctxt,
+			unsigned num_threads)
+{
+  vector<translation_unit_sptr> tus(corp.get_translation_units().begin(),
+				    corp.get_translation_units().end());
+  vector<archive_member_write_result> results(tus.size());
+
+  if (num_threads > tus.size())
+    num_threads = tus.size();
+
+  // This is done whatever the number of threads, so that the cached
+  // hash values, which depend on the order in which they are first
+  // computed, are the same for all numbers of threads.
+  lazy_properties_visitor v;
+  for (vector<translation_unit_sptr>::const_iterator i = tus.begin();
+       i != tus.end();
        ++i)
+    (*i)->traverse(v);
+
+  if (num_threads <= 1)
+    archive_write_task(tus, 0, 1, results).perform();
+  else
     {
-      if (! write_translation_unit_to_archive(**i, ctxt))
-	return false;
+      workers::queue q(num_threads);
+      for (unsigned i = 0; i < num_threads; ++i)
+	q.schedule_task(workers::task_sptr
+			(new archive_write_task(tus, i, num_threads,
+						results)));
+      q.wait_for_workers_to_complete();
     }
 
+  for (size_t i = 0; i < tus.size(); ++i)
+    if (!results[i].is_ok
+	|| !add_serialized_translation_unit_to_archive(*tus[i],
+						       results[i].serialized_tu,
+						       ctxt))
+      return false;
+
   // TODO: ensure abi-info descriptor is added to the archive.
   return true;
 }
@@ -2422,16 +2866,22 @@ write_corpus_to_archive(const corpus& corp,
 ///
 /// @param corp the ABI corpus to serialize.
 ///
- /// @param ctxt the context of the serialization.  Contains
- /// information about where the archive is on disk, the zip archive
- /// object, and the buffers holding the temporary data to be flushed
- /// into the archive.
- ///
- /// @return upon successful completion, false otherwise.
-static bool
+/// @param path the path of the archive file to serialize the corpus
+/// to.
+///
+/// @param num_threads the number of threads to use to serialize the
+/// translation units of the corpus.
+///
+/// @return true upon successful completion, false otherwise.
+bool
 write_corpus_to_archive(const corpus& corp,
-			archive_write_ctxt_sptr ctxt)
-{return write_corpus_to_archive(corp, *ctxt);}
+			const string& path,
+			unsigned num_threads)
+{
+  archive_write_ctxt_sptr ctxt = create_archive_write_context(path);
+  assert(ctxt);
+  return write_corpus_to_archive(corp, *ctxt, num_threads);
+}
 
  /// Serialize the current corpus to disk in a file at a given path.
  ///
@@ -2444,11 +2894,7 @@ write_corpus_to_archive(const corpus& corp,
 bool
 write_corpus_to_archive(const corpus& corp,
 			const string& path)
-{
-  archive_write_ctxt_sptr ctxt = create_archive_write_context(path);
-  assert(ctxt);
-  return write_corpus_to_archive(corp, ctxt);
-}
+{return write_corpus_to_archive(corp, path, /*num_threads=*/1);}
 
  /// Serialize the current corpus to disk in a file.  The file path is
  /// given by translation_unit::get_path().
@@ -2489,6 +2935,7 @@ write_corpus_to_native_xml(const corpus_sptr	corpus,
     return false;
 
   write_context ctxt(out);
+  ctxt.set_corpus_translation_units(corpus->get_translation_units());
 
   do_indent_to_level(ctxt, indent, 0);
   out << "<abi-corpus";
@@ -2562,6 +3009,9 @@ write_corpus_to_native_xml(const corpus_sptr	corpus,
 /// Serialize an ABI corpus to a single native xml document.  The root
 /// note of the resulting XML document is 'abi-corpus'.
 ///
+/// If the path of the output file ends with ".gz", the document is
+/// compressed with gzip as it's written.
+///
 /// @param corpus the corpus to serialize.
 ///
 /// @param indent the number of white space indentation to use.
@@ -2574,6 +3024,23 @@ write_corpus_to_native_xml_file(const corpus_sptr	corpus,
 {
     bool result = true;
 
+  if (path_has_gzip_suffix(path))
+    {
+      gzip_file_streambuf buf(path);
+      ostream of(&buf);
+      if (!buf.is_open())
+	{
+	  cerr << "failed to access " << path << "\n";
+	  return false;
+	}
+      if (!write_corpus_to_native_xml(corpus, indent, of) || !buf.close())
+	{
+	  cerr << "failed to write to " << path << "\n";
+	  result = false;
+	}
+      return result;
+    }
+
   try
     {
       ofstream of(path.c_str(), std::ios_base::trunc);
@@ -0,0 +1,650 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (C) 2013-2015 Red Hat, Inc.
+//
+// This file is part of the GNU Application Binary Interface Generic
+// Analysis and Instrumentation Library (libabigail).  This library is
+// free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option) any
+// later version.
+
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this program; see the file COPYING-LGPLV3.  If
+// not, see <http://www.gnu.org/licenses/>.
+
+/// @file
+///
+/// This program is the driver of the benchmark suite run by "make
+/// bench".
+///
+/// It takes two versions of an ELF binary carrying DWARF debug info
+/// and measures the main pipelines of libabigail on them: reading the
+/// DWARF, writing and reading back the native XML format,
+/// canonicalizing the types read back and computing and reporting the
+/// difference between the two corpora.  The types read back are
+/// canonicalized against those of the first corpus, which they are
+/// equal to.  Like abidiff does by default, harmless
+/// changes are filtered out of that difference.
+///
+/// With the --abixml option, the two inputs are corpora in the
+/// native XML format instead, e.g as generated by the abigencorpus
+/// program.  This allows benchmarking at sizes for which compiling a
+/// binary would take too long.
+///
+/// With the --suppressions option, the suppression specifications
+/// read from the given file are applied when computing the difference
+/// between the two corpora.  This allows measuring the cost of a
+/// comparison in which most changes are suppressed.
+///
+/// For each phase, the wall clock time, the CPU time, the resident
+/// set size, the memory high-water mark of the process and the amount
+/// of heap memory in use are recorded, as well as the number of
+/// dynamic memory allocations performed by the phase.  They are
+/// emitted as a JSON document, so that the results can be tracked
+/// across releases.  Note that the resident set size after the
+/// reading phases includes the source locations of the declarations,
+/// which are a sizeable part of the in-memory IR.
+
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <malloc.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <new>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include "abg-version.h"
+#include "abg-tools-utils.h"
+#include "abg-corpus.h"
+#include "abg-dwarf-reader.h"
+#include "abg-reader.h"
+#include "abg-writer.h"
+#include "abg-comparison.h"
+
+using std::string;
+using std::vector;
+using std::ostream;
+using std::ofstream;
+using std::ostringstream;
+using std::cout;
+using std::cerr;
+using abigail::corpus;
+using abigail::corpus_sptr;
+using abigail::ir::type_base_sptr;
+using abigail::ir::canonicalize;
+using abigail::comparison::diff_context;
+using abigail::comparison::diff_context_sptr;
+using abigail::comparison::corpus_diff;
+using abigail::comparison::corpus_diff_sptr;
+using abigail::comparison::compute_diff;
+using abigail::comparison::suppressions_type;
+using abigail::comparison::read_suppressions;
+
+struct options
+{
+  string	file1;
+  string	file2;
+  string	out_file_path;
+  string	tmp_dir;
+  vector<string> suppression_paths;
+  bool		abixml_input;
+  bool		display_usage;
+
+  options()
+    : tmp_dir("."),
+      abixml_input(),
+      display_usage()
+  {}
+};
+
+static void
+display_usage(const string& prog_name, ostream& out)
+{
+  out << "usage: " << prog_name << " [options] <elf-file1> <elf-file2>\n"
+      << " where options can be:\n"
+      << "  --help display this message\n"
+      << "  --abixml the input files are abixml corpora, not ELF files\n"
+      << "  --out-file <path> write the JSON results to 'path'\n"
+      << "  --tmp-dir <dir> write the temporary XML files under 'dir'\n"
+      << "  --suppressions <path> apply the suppressions of the file "
+    "'path' to the corpus diff\n";
+}
+
+static bool
+parse_command_line(int argc, char* argv[], options& opts)
+{
+  for (int i = 1; i < argc; ++i)
+    {
+      if (!strcmp(argv[i], "--help"))
+	{
+	  opts.display_usage = true;
+	  return true;
+	}
+      else if (argv[i][0] != '-')
+	{
+	  if (opts.file1.empty())
+	    opts.file1 = argv[i];
+	  else if (opts.file2.empty())
+	    opts.file2 = argv[i];
+	  else
+	    return false;
+	}
+      else if (!strcmp(argv[i], "--out-file"))
+	{
+	  if (argc <= i + 1)
+	    return false;
+	  opts.out_file_path = argv[++i];
+	}
+      else if (!strcmp(argv[i], "--abixml"))
+	opts.abixml_input = true;
+      else if (!strcmp(argv[i], "--tmp-dir"))
+	{
+	  if (argc <= i + 1)
+	    return false;
+	  opts.tmp_dir = argv[++i];
+	}
+      else if (!strcmp(argv[i], "--suppressions"))
+	{
+	  if (argc <= i + 1)
+	    return false;
+	  opts.suppression_paths.push_back(argv[++i]);
+	}
+      else
+	return false;
+    }
+
+  return !opts.file1.empty() && !opts.file2.empty();
+}
+
+/// The measures taken for a phase of the benchmark.
+struct phase_result
+{
+  string		name;
+  double		wall_seconds;
+  double		cpu_seconds;
+  long			rss_kb;
+  long			max_rss_kb;
+  long			heap_kb;
+  unsigned long	allocations;
+  unsigned long	items;
+  string		items_kind;
+
+  phase_result()
+    : wall_seconds(),
+      cpu_seconds(),
+      rss_kb(),
+      max_rss_kb(),
+      heap_kb(),
+      allocations(),
+      items()
+  {}
+};
+
+/// @return the current wall clock time, in seconds.
+static double
+get_wall_time()
+{
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+/// @return the CPU time (user + system) consumed by the process so
+/// far, in seconds.
+static double
+get_cpu_time()
+{
+  struct rusage u;
+  getrusage(RUSAGE_SELF, &u);
+  return (u.ru_utime.tv_sec + u.ru_utime.tv_usec / 1e6
+	  + u.ru_stime.tv_sec + u.ru_stime.tv_usec / 1e6);
+}
+
+/// @return the memory high-water mark of the process, in KiB.
+static long
+get_max_rss_kb()
+{
+  struct rusage u;
+  getrusage(RUSAGE_SELF, &u);
+  return u.ru_maxrss;
+}
+
+/// @return the current resident set size of the process, in KiB, or
+/// -1 if it could not be determined.
+static long
+get_rss_kb()
+{
+  long pages = -1;
+  FILE* f = fopen("/proc/self/statm", "r");
+  if (!f)
+    return -1;
+  long size = 0;
+  if (fscanf(f, "%ld %ld", &size, &pages) != 2)
+    pages = -1;
+  fclose(f);
+  if (pages < 0)
+    return -1;
+  return pages * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+/// @return the amount of memory allocated with malloc that is in use,
+/// in KiB.  Unlike the resident set size, this goes down when memory
+/// is freed, so it tells how much memory the data built by a phase
+/// takes.
+static long
+get_heap_kb()
+{
+#if defined(__GLIBC_PREREQ) && __GLIBC_PREREQ(2, 33)
+  // mallinfo is deprecated in favour of mallinfo2, whose fields are
+  // not truncated to an int.
+  struct mallinfo2 m = mallinfo2();
+#else
+  struct mallinfo m = mallinfo();
+#endif
+  return ((unsigned long) m.uordblks + (unsigned long) m.hblkhd) / 1024;
+}
+
+/// The number of calls to operator new performed by the process so
+/// far.
+static unsigned long num_allocations;
+
+/// A replacement of the global operator new that counts the dynamic
+/// memory allocations, be they performed by the program or by the
+/// library.
+///
+/// Dynamic exception specifications are deprecated in C++11 and
+/// invalid from C++17 on, so they are only spelled out for C++98.
+void*
+#if __cplusplus >= 201103L
+operator new(size_t size)
+#else
+operator new(size_t size) throw (std::bad_alloc)
+#endif
+{
+  __sync_fetch_and_add(&num_allocations, 1);
+  void* p = malloc(size ? size : 1);
+  if (!p)
+    throw std::bad_alloc();
+  return p;
+}
+
+/// The replacement of the global operator delete that goes with the
+/// replacement of the global operator new above.
+///
+/// It's not inlined: GCC would then see free() applied to the memory
+/// returned by operator new, and emit -Wmismatched-new-delete.
+__attribute__((noinline)) void
+#if __cplusplus >= 201103L
+operator delete(void* p) noexcept
+#else
+operator delete(void* p) throw ()
+#endif
+{free(p);}
+
+#ifdef __cpp_sized_deallocation
+/// The sized variant of the replacement of the global operator
+/// delete, used from C++14 on.
+__attribute__((noinline)) void
+operator delete(void* p, size_t) noexcept
+{free(p);}
+#endif
+
+/// A chronometer for a phase of the benchmark.
+///
+/// It starts measuring at construction time and records the result
+/// of the phase when phase_timer::stop() is invoked.
+class phase_timer
+{
+  phase_result	result_;
+  double	wall_start_;
+  double	cpu_start_;
+  unsigned long	allocations_start_;
+
+public:
+
+  phase_timer(const string& name)
+    : wall_start_(get_wall_time()),
+      cpu_start_(get_cpu_time()),
+      allocations_start_(num_allocations)
+  {result_.name = name;}
+
+  /// Stop the chronometer.
+  ///
+  /// @param items the number of items processed during the phase.
+  ///
+  /// @param items_kind the kind of items processed during the
+  /// phase.
+  ///
+  /// @return the measures of the phase.
+  const phase_result&
+  stop(unsigned long items, const string& items_kind)
+  {
+    result_.wall_seconds = get_wall_time() - wall_start_;
+    result_.cpu_seconds = get_cpu_time() - cpu_start_;
+    result_.rss_kb = get_rss_kb();
+    result_.max_rss_kb = get_max_rss_kb();
+    result_.heap_kb = get_heap_kb();
+    result_.allocations = num_allocations - allocations_start_;
+    result_.items = items;
+    result_.items_kind = items_kind;
+    return result_;
+  }
+};
+
+/// Escape a string so that it can be emitted as a JSON string.
+static string
+json_escape(const string& s)
+{
+  string result;
+  for (string::const_iterator i = s.begin(); i != s.end(); ++i)
+    switch (*i)
+      {
+      case '"':
+	result += "\\\"";
+	break;
+      case '\\':
+	result += "\\\\";
+	break;
+      case '\n':
+	result += "\\n";
+	break;
+      default:
+	result += *i;
+      }
+  return result;
+}
+
+/// Emit the results of the benchmark as a JSON document.
+static void
+emit_results(const options& opts,
+	     const vector<phase_result>& results,
+	     ostream& out)
+{
+  out << "{\n"
+      << "  \"libabigail-version\": \""
+      << ABIGAIL_VERSION_MAJOR << "."
+      << ABIGAIL_VERSION_MINOR << "."
+      << ABIGAIL_VERSION_REVISION << "\",\n"
+      << "  \"timestamp\": " << time(0) << ",\n"
+      << "  \"inputs\": [\"" << json_escape(opts.file1) << "\", \""
+      << json_escape(opts.file2) << "\"],\n"
+      << "  \"phases\": [\n";
+
+  for (vector<phase_result>::const_iterator i = results.begin();
+       i != results.end();
+       ++i)
+    {
+      out << "    {\"name\": \"" << json_escape(i->name) << "\", "
+	  << "\"wall-seconds\": " << i->wall_seconds << ", "
+	  << "\"cpu-seconds\": " << i->cpu_seconds << ", "
+	  << "\"rss-kb\": " << i->rss_kb << ", "
+	  << "\"max-rss-kb\": " << i->max_rss_kb << ", "
+	  << "\"heap-kb\": " << i->heap_kb << ", "
+	  << "\"allocations\": " << i->allocations << ", "
+	  << "\"items\": " << i->items << ", "
+	  << "\"items-kind\": \"" << json_escape(i->items_kind) << "\", "
+	  << "\"items-per-second\": "
+	  << (i->wall_seconds > 0 ? i->items / i->wall_seconds : 0)
+	  << "}"
+	  << (i + 1 != results.end() ? "," : "")
+	  << "\n";
+    }
+
+  out << "  ]\n"
+      << "}\n";
+}
+
+/// Expand the source locations of the functions and variables of a
+/// corpus.
+///
+/// @param corp the corpus to consider.
+///
+/// @return the number of locations expanded.
+static unsigned long
+expand_locations(const corpus_sptr& corp)
+{
+  unsigned long n = 0;
+  string path;
+  unsigned line = 0, column = 0;
+
+  for (corpus::functions::const_iterator i = corp->get_functions().begin();
+       i != corp->get_functions().end();
+       ++i)
+    if (abigail::ir::location l = (*i)->get_location())
+      {
+	get_translation_unit(*i)->get_loc_mgr().expand_location(l, path,
+								 line, column);
+	++n;
+      }
+
+  for (corpus::variables::const_iterator i = corp->get_variables().begin();
+       i != corp->get_variables().end();
+       ++i)
+    if (abigail::ir::location l = (*i)->get_location())
+      {
+	get_translation_unit(*i)->get_loc_mgr().expand_location(l, path,
+								 line, column);
+	++n;
+      }
+
+  return n;
+}
+
+/// Read a corpus from an ELF file and record the measures of the
+/// reading in a vector of results.
+///
+/// The loading of the ELF symbol tables is measured as a phase of its
+/// own, which name is @p symbols_phase_name.
+static corpus_sptr
+read_elf_corpus(const string& path,
+		const string& symbols_phase_name,
+		const string& phase_name,
+		vector<phase_result>& results)
+{
+  corpus_sptr corp;
+  abigail::dwarf_reader::read_context_sptr ctxt =
+    abigail::dwarf_reader::create_read_context(path, /*di_root=*/0);
+
+  phase_timer s(symbols_phase_name);
+  abigail::dwarf_reader::load_elf_symbols(*ctxt);
+  phase_result symbols_result = s.stop(0, "symbols");
+
+  phase_timer t(phase_name);
+  abigail::dwarf_reader::read_corpus_from_elf(*ctxt, corp);
+  if (!corp)
+    return corp;
+  phase_result corpus_result = t.stop(corp->get_functions().size()
+				      + corp->get_variables().size(),
+				      "decls");
+
+  symbols_result.items = (corp->get_fun_symbol_map().size()
+			  + corp->get_var_symbol_map().size()
+			  + corp->get_undefined_fun_symbol_map().size()
+			  + corp->get_undefined_var_symbol_map().size());
+  results.push_back(symbols_result);
+  results.push_back(corpus_result);
+  return corp;
+}
+
+/// Read a corpus from a file in the native XML format and record the
+/// measures of the reading in a vector of results.
+static corpus_sptr
+read_xml_corpus(const string& path,
+		const string& phase_name,
+		vector<phase_result>& results)
+{
+  phase_timer t(phase_name);
+  corpus_sptr corp =
+    abigail::xml_reader::read_corpus_from_native_xml_file(path);
+  if (!corp)
+    return corp;
+  results.push_back(t.stop(corp->get_functions().size()
+			   + corp->get_variables().size(),
+			   "decls"));
+  return corp;
+}
+
+/// Read a corpus from a file in the native XML format, then
+/// canonicalize its types, and record the measures of the reading
+/// and of the canonicalization as two phases in a vector of results.
+static corpus_sptr
+read_xml_corpus_and_canonicalize_types(const string& path,
+				       const string& phase_name,
+				       const string& canonicalize_phase_name,
+				       vector<phase_result>& results)
+{
+  vector<type_base_sptr> types;
+  phase_timer t(phase_name);
+  corpus_sptr corp =
+    abigail::xml_reader::read_corpus_from_native_xml_file(path, types);
+  if (!corp)
+    return corp;
+  results.push_back(t.stop(corp->get_functions().size()
+			   + corp->get_variables().size(),
+			   "decls"));
+
+  phase_timer c(canonicalize_phase_name);
+  for (vector<type_base_sptr>::const_iterator i = types.begin();
+       i != types.end();
+       ++i)
+    canonicalize(*i);
+  results.push_back(c.stop(types.size(), "types"));
+  return corp;
+}
+
+int
+main(int argc, char* argv[])
+{
+  options opts;
+  if (!parse_command_line(argc, argv, opts))
+    {
+      display_usage(argv[0], cerr);
+      return 1;
+    }
+
+  if (opts.display_usage)
+    {
+      display_usage(argv[0], cout);
+      return 0;
+    }
+
+  if (!abigail::tools_utils::check_file(opts.file1, cerr)
+      || !abigail::tools_utils::check_file(opts.file2, cerr))
+    return 1;
+
+  vector<phase_result> results;
+
+  corpus_sptr c1, c2;
+  if (opts.abixml_input)
+    {
+      c1 = read_xml_corpus(opts.file1, "read-input-xml-1", results);
+      c2 = read_xml_corpus(opts.file2, "read-input-xml-2", results);
+    }
+  else
+    {
+      c1 = read_elf_corpus(opts.file1, "load-elf-symbols-1",
+			   "read-dwarf-1", results);
+      c2 = read_elf_corpus(opts.file2, "load-elf-symbols-2",
+			   "read-dwarf-2", results);
+    }
+  if (!c1 || !c2)
+    {
+      cerr << "could not read the input files\n";
+      return 1;
+    }
+
+  {
+    phase_timer t("expand-locations");
+    unsigned long n = expand_locations(c1) + expand_locations(c2);
+    results.push_back(t.stop(n, "locations"));
+  }
+
+  string xml_path = opts.tmp_dir + "/bench-corpus-1.abi";
+  {
+    phase_timer t("write-xml");
+    if (!abigail::xml_writer::write_corpus_to_native_xml_file(c1,
+							       /*indent=*/0,
+							       xml_path))
+      {
+	cerr << "could not write " << xml_path << "\n";
+	return 1;
+      }
+    std::ifstream in(xml_path.c_str(), std::ios_base::binary);
+    in.seekg(0, std::ios_base::end);
+    results.push_back(t.stop(in.tellg(), "bytes"));
+  }
+
+  corpus_sptr c3 =
+    read_xml_corpus_and_canonicalize_types(xml_path, "read-xml",
+					   "canonicalize", results);
+  if (!c3)
+    {
+      cerr << "could not read " << xml_path << "\n";
+      return 1;
+    }
+  unlink(xml_path.c_str());
+  c3.reset();
+
+  corpus_diff_sptr d;
+  {
+    phase_timer t("corpus-diff");
+    diff_context_sptr ctxt(new diff_context);
+    ctxt->switch_categories_off
+      (abigail::comparison::ACCESS_CHANGE_CATEGORY
+       | abigail::comparison::COMPATIBLE_TYPE_CHANGE_CATEGORY
+       | abigail::comparison::HARMLESS_DECL_NAME_CHANGE_CATEGORY
+       | abigail::comparison::NON_VIRT_MEM_FUN_CHANGE_CATEGORY
+       | abigail::comparison::STATIC_DATA_MEMBER_CHANGE_CATEGORY
+       | abigail::comparison::HARMLESS_ENUM_CHANGE_CATEGORY
+       | abigail::comparison::HARMLESS_SYMBOL_ALIAS_CHANGE_CATEORY);
+    for (vector<string>::const_iterator i = opts.suppression_paths.begin();
+	 i != opts.suppression_paths.end();
+	 ++i)
+      {
+	suppressions_type supprs;
+	read_suppressions(*i, supprs);
+	ctxt->add_suppressions(supprs);
+      }
+    d = compute_diff(c1, c2, ctxt);
+    const corpus_diff::diff_stats& s =
+      d->apply_filters_and_suppressions_before_reporting();
+    results.push_back(t.stop(s.num_func_changed() + s.num_vars_changed()
+			     + s.num_func_removed() + s.num_func_added()
+			     + s.num_vars_removed() + s.num_vars_added(),
+			     "changes"));
+  }
+
+  {
+    phase_timer t("diff-report");
+    ostringstream o;
+    d->report(o);
+    results.push_back(t.stop(o.str().size(), "bytes"));
+  }
+
+  if (opts.out_file_path.empty())
+    emit_results(opts, results, cout);
+  else
+    {
+      ofstream o(opts.out_file_path.c_str(), std::ios_base::trunc);
+      if (!o.is_open())
+	{
+	  cerr << "could not open " << opts.out_file_path << "\n";
+	  return 1;
+	}
+      emit_results(opts, results, o);
+    }
+
+  return 0;
+}
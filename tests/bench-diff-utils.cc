@@ -0,0 +1,324 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (C) 2013-2015 Red Hat, Inc.
+//
+// This file is part of the GNU Application Binary Interface Generic
+// Analysis and Instrumentation Library (libabigail).  This library is
+// free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option) any
+// later version.
+
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this program; see the file COPYING-LGPLV3.  If
+// not, see <http://www.gnu.org/licenses/>.
+
+/// @file
+///
+/// This program is a micro-benchmark of the diff algorithm of
+/// abg-diff-utils.h.  It is run by "make bench".
+///
+/// It compares diff_utils::compute_diff() and
+/// diff_utils::compute_trimmed_diff() on synthetic sequences shaped
+/// like the ones libabigail diffs: the long, sorted lists of the
+/// functions exported by two versions of a library, and the short
+/// lists of the data members of many versions of classes.  The names
+/// of the functions and members are compared as strings.
+///
+/// For each scenario and each algorithm, the best wall clock time out
+/// of several runs is emitted as a JSON document, along with the
+/// length of the edit scripts, which must be the same for both
+/// algorithms.
+
+#include <sys/time.h>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include "abg-diff-utils.h"
+
+using std::string;
+using std::vector;
+using std::ostream;
+using std::ofstream;
+using std::ostringstream;
+using std::cout;
+using std::cerr;
+using abigail::diff_utils::edit_script;
+using abigail::diff_utils::compute_diff;
+using abigail::diff_utils::compute_trimmed_diff;
+
+/// A pair of sequences to diff.
+typedef vector<string> sequence;
+
+/// A scenario of the benchmark: the pairs of sequences to diff.
+struct scenario
+{
+  string		name;
+  vector<sequence>	first_sequences;
+  vector<sequence>	second_sequences;
+};
+
+/// The measures taken for an algorithm on a scenario.
+struct result
+{
+  string	scenario_name;
+  string	algorithm;
+  double	wall_seconds;
+  unsigned long	ses_len;
+};
+
+/// @return the current wall clock time, in seconds.
+static double
+get_wall_time()
+{
+  struct timeval tv;
+  gettimeofday(&tv, 0);
+  return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+/// Build a sorted sequence of names.
+///
+/// @param prefix the prefix of the names.
+///
+/// @param size the number of names.
+///
+/// @param seq the resulting sequence.
+static void
+build_sequence(const string& prefix, unsigned size, sequence& seq)
+{
+  for (unsigned i = 0; i < size; ++i)
+    {
+      ostringstream o;
+      o << prefix << i;
+      seq.push_back(o.str());
+    }
+}
+
+/// Build a new version of a sequence, in which some elements are
+/// removed, added or renamed.
+///
+/// @param seq the sequence to consider.
+///
+/// @param num_changes the number of changes to perform.  They are
+/// evenly spread over @p seq.
+///
+/// @param result the resulting new version of @p seq.
+static void
+mutate_sequence(const sequence& seq, unsigned num_changes, sequence& result)
+{
+  unsigned period = num_changes ? seq.size() / num_changes : 0;
+  for (unsigned i = 0; i < seq.size(); ++i)
+    {
+      if (!period || i % period != period - 1)
+	{
+	  result.push_back(seq[i]);
+	  continue;
+	}
+      switch ((i / period) % 3)
+	{
+	case 0:
+	  // Remove the element.
+	  break;
+	case 1:
+	  // Add an element after this one.
+	  result.push_back(seq[i]);
+	  result.push_back(seq[i] + "_added");
+	  break;
+	case 2:
+	  // Rename the element.
+	  result.push_back(seq[i] + "_renamed");
+	  break;
+	}
+    }
+}
+
+/// Build a scenario made of one pair of long sequences, like the
+/// lists of functions exported by two versions of a library.
+///
+/// @param name the name of the scenario.
+///
+/// @param size the number of elements of the sequences.
+///
+/// @param num_changes the number of changes between the sequences.
+///
+/// @param s the resulting scenario.
+static void
+build_functions_scenario(const string& name,
+			 unsigned size,
+			 unsigned num_changes,
+			 scenario& s)
+{
+  s.name = name;
+  s.first_sequences.resize(1);
+  s.second_sequences.resize(1);
+  build_sequence("_Z9function", size, s.first_sequences[0]);
+  mutate_sequence(s.first_sequences[0], num_changes,
+		  s.second_sequences[0]);
+}
+
+/// Build a scenario made of many pairs of short sequences, like the
+/// lists of data members of classes that changed.
+///
+/// @param name the name of the scenario.
+///
+/// @param num_classes the number of pairs of sequences.
+///
+/// @param num_members the number of elements of the sequences.
+///
+/// @param s the resulting scenario.
+static void
+build_members_scenario(const string& name,
+		       unsigned num_classes,
+		       unsigned num_members,
+		       scenario& s)
+{
+  s.name = name;
+  s.first_sequences.resize(num_classes);
+  s.second_sequences.resize(num_classes);
+  for (unsigned i = 0; i < num_classes; ++i)
+    {
+      build_sequence("m_member", num_members, s.first_sequences[i]);
+      mutate_sequence(s.first_sequences[i], 1, s.second_sequences[i]);
+    }
+}
+
+/// The number of times each scenario is run.  The best time is kept.
+static const unsigned num_runs = 10;
+
+/// Run an algorithm on all the pairs of sequences of a scenario.
+///
+/// @param s the scenario to run.
+///
+/// @param trimmed if true, run compute_trimmed_diff(), otherwise run
+/// compute_diff().
+///
+/// @param r the resulting measures.
+static void
+run_scenario(const scenario& s, bool trimmed, result& r)
+{
+  typedef sequence::const_iterator iterator;
+
+  r.scenario_name = s.name;
+  r.algorithm = trimmed ? "compute_trimmed_diff" : "compute_diff";
+  r.wall_seconds = 0;
+
+  for (unsigned run = 0; run < num_runs; ++run)
+    {
+      r.ses_len = 0;
+      double start = get_wall_time();
+      for (unsigned i = 0; i < s.first_sequences.size(); ++i)
+	{
+	  const sequence &a = s.first_sequences[i],
+	    &b = s.second_sequences[i];
+	  edit_script ses;
+	  if (trimmed)
+	    compute_trimmed_diff<iterator>(a.begin(), a.end(),
+					   b.begin(), b.end(),
+					   ses);
+	  else
+	    compute_diff<iterator>(a.begin(), a.end(),
+				   b.begin(), b.end(),
+				   ses);
+	  r.ses_len += ses.length();
+	}
+      double wall_seconds = get_wall_time() - start;
+      if (run == 0 || wall_seconds < r.wall_seconds)
+	r.wall_seconds = wall_seconds;
+    }
+}
+
+/// Emit the results of the benchmark as a JSON document.
+static void
+emit_results(const vector<result>& results, ostream& out)
+{
+  out << "{\n"
+      << "  \"scenarios\": [\n";
+  for (vector<result>::const_iterator i = results.begin();
+       i != results.end();
+       ++i)
+    out << "    {\"name\": \"" << i->scenario_name << "\", "
+	<< "\"algorithm\": \"" << i->algorithm << "\", "
+	<< "\"wall-seconds\": " << i->wall_seconds << ", "
+	<< "\"ses-length\": " << i->ses_len << "}"
+	<< (i + 1 != results.end() ? "," : "")
+	<< "\n";
+  out << "  ]\n"
+      << "}\n";
+}
+
+static void
+display_usage(const string& prog_name, ostream& out)
+{
+  out << "usage: " << prog_name << " [options]\n"
+      << " where options can be:\n"
+      << "  --help display this message\n"
+      << "  --out-file <path> write the JSON results to 'path'\n";
+}
+
+int
+main(int argc, char* argv[])
+{
+  string out_file_path;
+  for (int i = 1; i < argc; ++i)
+    {
+      if (!strcmp(argv[i], "--out-file") && i + 1 < argc)
+	out_file_path = argv[++i];
+      else
+	{
+	  display_usage(argv[0], cerr);
+	  return !!strcmp(argv[i], "--help");
+	}
+    }
+
+  vector<scenario> scenarios(4);
+  build_functions_scenario("100000-functions-10-changes",
+			   100000, 10, scenarios[0]);
+  build_functions_scenario("100000-functions-1000-changes",
+			   100000, 1000, scenarios[1]);
+  build_members_scenario("20000-classes-of-20-members",
+			 20000, 20, scenarios[2]);
+  build_members_scenario("2000-classes-of-500-members",
+			 2000, 500, scenarios[3]);
+
+  bool is_ok = true;
+  vector<result> results;
+  for (vector<scenario>::const_iterator s = scenarios.begin();
+       s != scenarios.end();
+       ++s)
+    {
+      result r, t;
+      run_scenario(*s, /*trimmed=*/false, r);
+      run_scenario(*s, /*trimmed=*/true, t);
+      if (r.ses_len != t.ses_len)
+	{
+	  cerr << s->name << ": the lengths of the edit scripts differ\n";
+	  is_ok = false;
+	}
+      results.push_back(r);
+      results.push_back(t);
+    }
+
+  if (out_file_path.empty())
+    emit_results(results, cout);
+  else
+    {
+      ofstream of(out_file_path.c_str());
+      if (!of.is_open())
+	{
+	  cerr << "could not open " << out_file_path << "\n";
+	  return 1;
+	}
+      emit_results(results, of);
+    }
+
+  return !is_ok;
+}
@@ -0,0 +1,327 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (C) 2013-2015 Red Hat, Inc.
+//
+// This file is part of the GNU Application Binary Interface Generic
+// Analysis and Instrumentation Library (libabigail).  This library is
+// free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option) any
+// later version.
+
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this program; see the file COPYING-LGPLV3.  If
+// not, see <http://www.gnu.org/licenses/>.
+
+/// @file
+///
+/// This program generates one translation unit of a synthetic C++
+/// library used as input of the benchmark suite run by "make bench".
+///
+/// The library is made of a configurable number of types spread over
+/// a configurable number of translation units.  Each type is reachable
+/// from an exported function, so that the DWARF reader has to build
+/// all of them.  The generated code is deterministic: given the same
+/// command line, the same source code is emitted, which makes the
+/// benchmark results comparable across releases.
+///
+/// The --version option selects between the baseline library (0) and
+/// a mutated one (1).  The mutated version changes some data members,
+/// removes some functions and adds some others, so that comparing the
+/// two versions exercises the comparison engine.
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using std::string;
+using std::ostream;
+using std::ofstream;
+using std::cout;
+using std::cerr;
+
+struct options
+{
+  bool		display_usage;
+  unsigned	num_types;
+  unsigned	num_tus;
+  unsigned	tu;
+  unsigned	version;
+  unsigned	mutation_period;
+  string	out_file_path;
+
+  options()
+    : display_usage(false),
+      num_types(20000),
+      num_tus(40),
+      tu(0),
+      version(0),
+      mutation_period(50)
+  {}
+};
+
+static void
+display_usage(const string& prog_name, ostream& out)
+{
+  out << "usage: " << prog_name << " [options]\n"
+      << " where options can be:\n"
+      << "  --help display this message\n"
+      << "  --types <N> total number of types of the library (default 20000)\n"
+      << "  --tus <N> number of translation units of the library "
+    "(default 40)\n"
+      << "  --tu <N> index of the translation unit to emit (default 0)\n"
+      << "  --version <0|1> emit the baseline or the mutated library "
+    "(default 0)\n"
+      << "  --mutation-period <N> mutate one type out of N in version 1 "
+    "(default 50)\n"
+      << "  --out-file <path> write the source code to 'path'\n";
+}
+
+/// Parse an unsigned integer command line argument.
+///
+/// @param str the string to parse.
+///
+/// @param result the resulting integer.
+///
+/// @return true upon successful completion.
+static bool
+parse_unsigned(const char* str, unsigned& result)
+{
+  char* end = 0;
+  unsigned long v = strtoul(str, &end, 10);
+  if (!end || *end)
+    return false;
+  result = v;
+  return true;
+}
+
+static bool
+parse_command_line(int argc, char* argv[], options& opts)
+{
+  for (int i = 1; i < argc; ++i)
+    {
+      unsigned* dest = 0;
+      if (!strcmp(argv[i], "--help"))
+	{
+	  opts.display_usage = true;
+	  return true;
+	}
+      else if (!strcmp(argv[i], "--types"))
+	dest = &opts.num_types;
+      else if (!strcmp(argv[i], "--tus"))
+	dest = &opts.num_tus;
+      else if (!strcmp(argv[i], "--tu"))
+	dest = &opts.tu;
+      else if (!strcmp(argv[i], "--version"))
+	dest = &opts.version;
+      else if (!strcmp(argv[i], "--mutation-period"))
+	dest = &opts.mutation_period;
+      else if (!strcmp(argv[i], "--out-file"))
+	{
+	  if (argc <= i + 1)
+	    return false;
+	  opts.out_file_path = argv[++i];
+	  continue;
+	}
+      else
+	return false;
+
+      if (argc <= i + 1 || !parse_unsigned(argv[i + 1], *dest))
+	return false;
+      ++i;
+    }
+
+  return (opts.num_tus != 0
+	  && opts.tu < opts.num_tus
+	  && opts.version < 2
+	  && opts.mutation_period != 0);
+}
+
+/// Tests if the type which index is @p i is mutated in the current
+/// version of the library.
+///
+/// @param opts the options of the generator.
+///
+/// @param i the index of the type to consider.
+///
+/// @param salt a small integer used to select different subsets of
+/// types for different kinds of mutations.
+///
+/// @return true iff the type @p i is to be mutated.
+static bool
+is_mutated(const options& opts, unsigned i, unsigned salt)
+{return opts.version == 1 && (i % opts.mutation_period) == salt;}
+
+/// Emit the namespace that contains the type which index is @p i.
+static void
+open_namespace(unsigned i, ostream& o)
+{o << "namespace bench_ns" << (i % 16) << "\n{\n";}
+
+/// Emit the types which index is @p i, as well as the exported
+/// functions that use them.
+///
+/// @param opts the options of the generator.
+///
+/// @param i the index of the type.
+///
+/// @param first the index of the first type of the current
+/// translation unit.  A type can only derive from types that are
+/// defined in the same translation unit.
+///
+/// @param o the output stream to emit the code to.
+static void
+emit_type(const options& opts, unsigned i, unsigned first, ostream& o)
+{
+  bool has_vtable = (i % 4) == 0;
+  bool has_enum = (i % 5) == 0;
+  bool has_base = (i % 3) == 0 && i > first;
+
+  if (i > 0)
+    {
+      open_namespace(i - 1, o);
+      o << "struct s" << i - 1 << ";\n}\n";
+    }
+
+  open_namespace(i, o);
+
+  if (has_enum)
+    {
+      o << "enum e" << i << "\n{\n";
+      unsigned n = 3 + i % 7 + (is_mutated(opts, i, 0) ? 1 : 0);
+      for (unsigned j = 0; j < n; ++j)
+	o << "  e" << i << "_" << j << (j + 1 < n ? ",\n" : "\n");
+      o << "};\n\n";
+    }
+
+  if (has_vtable)
+    {
+      o << "class b" << i << "\n{\n"
+	<< "public:\n"
+	<< "  virtual ~b" << i << "();\n";
+      unsigned n = 2 + i % 6 + (is_mutated(opts, i, 4) ? 1 : 0);
+      for (unsigned j = 0; j < n; ++j)
+	o << "  virtual int vf" << j << "(int);\n";
+      o << "  int bm;\n};\n\n";
+      o << "b" << i << "::~b" << i << "()\n{}\n\n";
+      for (unsigned j = 0; j < n; ++j)
+	o << "int\nb" << i << "::vf" << j << "(int a)\n"
+	  << "{return a + bm + " << j << ";}\n\n";
+    }
+
+  o << "struct s" << i;
+  if (has_vtable)
+    o << " : public b" << i;
+  else if (has_base)
+    o << " : public ::bench_ns" << (i - 1) % 16 << "::s" << i - 1;
+  o << "\n{\n";
+
+  o << "  int m0;\n"
+    << "  " << (is_mutated(opts, i, 1) ? "int" : "long") << " m1;\n"
+    << "  char m2[" << 1 + i % 8 << "];\n";
+  if (is_mutated(opts, i, 2))
+    o << "  unsigned added_member;\n";
+  if (i > 0)
+    o << "  ::bench_ns" << (i - 1) % 16 << "::s" << i - 1 << "* prev;\n";
+  if (has_enum)
+    o << "  e" << i << " kind;\n";
+  o << "  holder<int, " << 1 + i % 3 << "> h;\n";
+  o << "};\n\n";
+
+  o << "typedef s" << i << "* s" << i << "_ptr;\n"
+    << "typedef const s" << i << "& s" << i << "_cref;\n\n";
+
+  o << "}// end namespace bench_ns" << (i % 16) << "\n\n";
+
+  string qname;
+  {
+    std::ostringstream s;
+    s << "bench_ns" << (i % 16) << "::s" << i;
+    qname = s.str();
+  }
+
+  // Remove some functions in the mutated version.
+  if (!is_mutated(opts, i, 3))
+    o << "int\nbench_fn" << i << "(" << qname << "_ptr p, "
+      << qname << "_cref r)\n"
+      << "{return p->m0 + r.m0;}\n\n";
+
+  o << "const " << qname << "*\n"
+    << "bench_get" << i << "(const holder<" << qname << ", "
+    << 1 + i % 3 << ">* h)\n"
+    << "{return h ? h->p : 0;}\n\n";
+
+  // Add some functions in the mutated version.
+  if (is_mutated(opts, i, 5))
+    o << "long\nbench_added_fn" << i << "(" << qname << "* p)\n"
+      << "{return p->m1;}\n\n";
+
+  o << qname << " bench_var" << i << ";\n\n";
+}
+
+/// Emit the translation unit selected by the options.
+///
+/// @param opts the options of the generator.
+///
+/// @param o the output stream to emit the code to.
+static void
+emit_translation_unit(const options& opts, ostream& o)
+{
+  o << "// Generated by benchgensource.  Do not edit.\n\n"
+    << "template<typename T, int N>\n"
+    << "struct holder\n{\n"
+    << "  T v[N];\n"
+    << "  const T* p;\n"
+    << "};\n\n";
+
+  unsigned types_per_tu = opts.num_types / opts.num_tus;
+  unsigned begin = opts.tu * types_per_tu;
+  unsigned end = (opts.tu + 1 == opts.num_tus)
+    ? opts.num_types
+    : begin + types_per_tu;
+
+  for (unsigned i = begin; i < end; ++i)
+    emit_type(opts, i, begin, o);
+}
+
+int
+main(int argc, char* argv[])
+{
+  options opts;
+  if (!parse_command_line(argc, argv, opts))
+    {
+      display_usage(argv[0], cerr);
+      return 1;
+    }
+
+  if (opts.display_usage)
+    {
+      display_usage(argv[0], cout);
+      return 0;
+    }
+
+  if (opts.out_file_path.empty())
+    emit_translation_unit(opts, cout);
+  else
+    {
+      ofstream o(opts.out_file_path.c_str(), std::ios_base::trunc);
+      if (!o.is_open())
+	{
+	  cerr << "could not open " << opts.out_file_path << "\n";
+	  return 1;
+	}
+      emit_translation_unit(opts, o);
+      o.close();
+      if (!o.good())
+	return 1;
+    }
+
+  return 0;
+}
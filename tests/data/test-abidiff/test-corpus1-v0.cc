@@ -0,0 +1,42 @@
+// Compile with:
+//   g++ -g -gdwarf-4 -shared -fPIC -fno-eliminate-unused-debug-types \
+//     -Wl,-soname=libtest-corpus1.so.0 -o test-corpus1-v0.so \
+//     test-corpus1-v0.cc
+// and then generate test-corpus1-v0.so.abi with:
+//   abidw --load-all-types test-corpus1-v0.so
+
+struct S
+{
+  int m0;
+  char m1;
+};
+
+// A type that no exported declaration can reach.
+struct unreachable
+{
+  long m0;
+  unreachable* next;
+};
+
+typedef unreachable unreachable_typedef;
+
+static int
+helper(unreachable& u)
+{return u.m0;}
+
+int
+changed_fn(S& s)
+{return s.m0;}
+
+void
+removed_fn(S*)
+{}
+
+S changed_var;
+
+int
+use_helper()
+{
+  unreachable u = {0, 0};
+  return helper(u);
+}
@@ -0,0 +1,43 @@
+// Compile with:
+//   g++ -g -gdwarf-4 -shared -fPIC -fno-eliminate-unused-debug-types \
+//     -Wl,-soname=libtest-corpus1.so.1 -o test-corpus1-v1.so \
+//     test-corpus1-v1.cc
+// and then generate test-corpus1-v1.so.abi with:
+//   abidw --load-all-types test-corpus1-v1.so
+
+struct S
+{
+  int m0;
+  unsigned m1;
+  int m2;
+};
+
+// A type that no exported declaration can reach.
+struct unreachable
+{
+  long m0;
+  unreachable* next;
+};
+
+typedef unreachable unreachable_typedef;
+
+static int
+helper(unreachable& u)
+{return u.m0;}
+
+int
+changed_fn(S& s)
+{return s.m0;}
+
+int
+added_fn(int a)
+{return a;}
+
+S changed_var;
+
+int
+use_helper()
+{
+  unreachable u = {0, 0};
+  return helper(u);
+}
@@ -0,0 +1,24 @@
+// To compile this, type:
+//   g++ -shared -fPIC -g -gdwarf-4 -Wall -Wl,--build-id -o libtest1.so test1.cc
+//
+// Then, move its debug info into a separate file by doing:
+//   objcopy --only-keep-debug libtest1.so test1-renamed.debug
+//   strip --strip-debug libtest1.so
+//   objcopy --add-gnu-debuglink=test1-renamed.debug libtest1.so
+//   mv test1-renamed.debug test1-debug-dir/test1-moved.debug
+//
+// The .gnu_debuglink section of libtest1.so then names a file that
+// doesn't exist, so only an index of the debug info directory can
+// lead to test1-debug-dir/test1-moved.debug.
+
+struct S
+{
+  int m0;
+  char m1;
+};
+
+int
+foo(S& s)
+{return s.m0 + s.m1;}
+
+S global_s;
@@ -0,0 +1,20 @@
+// This compilation unit is part of libtest27-recursive-decl-only-v0.so
+// and libtest27-recursive-decl-only-v1.so.  Here, struct node is
+// only declared, so struct list is reached through a declaration-only
+// class.
+
+struct node;
+
+struct list
+{
+  node* first;
+  node* last;
+};
+
+bool
+list_is_empty(list* l)
+{return l->first == 0;}
+
+node*
+list_last(list* l)
+{return l->last;}
@@ -0,0 +1,31 @@
+// Compile with:
+//   g++ -g -gdwarf-4 -shared -fPIC -o libtest27-recursive-decl-only-v1.so \
+//     test27-recursive-decl-only-v1.cc test27-recursive-decl-only-fwd.cc
+//
+// In this compilation unit, struct node is defined and struct list,
+// which it refers to, is recursive through it.  In
+// test27-recursive-decl-only-fwd.cc, struct node is only declared.
+
+struct node;
+
+struct list
+{
+  node* first;
+  node* last;
+};
+
+struct node
+{
+  list* owner;
+  node* next;
+  node* prev;
+  int value;
+};
+
+int
+node_value(node* n)
+{return n->value;}
+
+node*
+list_first(list* l)
+{return l->first;}
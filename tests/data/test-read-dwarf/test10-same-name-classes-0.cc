@@ -0,0 +1,13 @@
+///
+/// build with:
+/// g++ -g -gdwarf-4 -shared -fPIC -o test10-same-name-classes.so test10-same-name-classes-0.cc test10-same-name-classes-1.cc
+///
+#define TYPE0 int
+#define TYPE1 int
+#define TYPE2 int
+#define TYPE3 int
+#include "test10-same-name-classes.h"
+
+int
+f0(S0*, S1*, S2*, S3*, same*)
+{return 0;}
@@ -0,0 +1,33 @@
+/// The classes below have the same name, size, source location and
+/// member names in the two compile units of
+/// test10-same-name-classes.so.  The types of the members of S0,
+/// S1, S2 and S3 differ, though, as they depend on macros that each
+/// compile unit defines differently.  Only the classes named "same"
+/// are identical.
+
+struct S0
+{
+  TYPE0* m;
+};
+
+struct S1
+{
+  TYPE1 m[2];
+};
+
+struct S2
+{
+  int (*m)(TYPE2);
+};
+
+struct S3
+{
+  const TYPE3* volatile m;
+};
+
+struct same
+{
+  const char* name;
+  int (*fn)(int);
+  int a[4];
+};
@@ -0,0 +1,9 @@
+///
+/// build with:
+/// g++ -g -gdwarf-4 -shared -fPIC -o test11-nested-class-members.so test11-nested-class-members-0.cc test11-nested-class-members-1.cc
+///
+#include "test11-nested-class-members.h"
+
+int
+f1(outer<int>* o)
+{return o->i.second();}
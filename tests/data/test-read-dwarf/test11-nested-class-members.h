@@ -0,0 +1,26 @@
+/// The two compile units of test11-nested-class-members.so use
+/// different member functions of outer<int>::inner, so each unit
+/// defines only the member function it uses.  The definitions refer
+/// to the declarations of the member functions in the inner class.
+/// When outer<int> is deduplicated, these declarations must be
+/// mapped to the member functions of the inner class built from the
+/// first unit, rather than be added to it once again.
+
+template<typename T>
+struct outer
+{
+  struct inner
+  {
+    T v;
+
+    T
+    first() const
+    {return v;}
+
+    T
+    second() const
+    {return v + 1;}
+  };
+
+  inner i;
+};
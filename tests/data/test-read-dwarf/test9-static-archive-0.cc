@@ -0,0 +1,17 @@
+///
+/// build with:
+/// g++ -g -gdwarf-4 -c test9-static-archive-0.cc test9-static-archive-1.cc
+/// ar rcs test9-static-archive.a test9-static-archive-0.o test9-static-archive-1.o
+///
+#include "test9-static-archive.h"
+
+int
+sum(const node* n)
+{
+  int result = 0;
+  for (; n; n = n->next)
+    result += n->value;
+  return result;
+}
+
+int global_count;
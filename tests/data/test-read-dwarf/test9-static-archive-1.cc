@@ -0,0 +1,27 @@
+#include "test9-static-archive.h"
+
+extern int global_count;
+
+node*
+make_list(int length)
+{
+  node* result = 0;
+  for (int i = 0; i < length; ++i)
+    {
+      node* n = new node;
+      n->value = i;
+      n->next = result;
+      result = n;
+      ++global_count;
+    }
+  return result;
+}
+
+struct counter
+{
+  long count;
+};
+
+long
+count(const counter* c)
+{return sum(make_list(c->count));}
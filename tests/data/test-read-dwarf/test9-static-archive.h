@@ -0,0 +1,11 @@
+struct node
+{
+  int value;
+  node* next;
+};
+
+int
+sum(const node*);
+
+node*
+make_list(int length);
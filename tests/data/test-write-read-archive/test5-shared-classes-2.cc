@@ -0,0 +1,405 @@
+///
+/// build with:
+/// g++ -g -gdwarf-4 -shared -fPIC -o test5-shared-classes.so test5-shared-classes-0.cc test5-shared-classes-1.cc test5-shared-classes-2.cc test5-shared-classes-3.cc
+///
+#include "test5-shared-classes.h"
+
+int
+use2_0(s0& x)
+{return x.f0(x.next);}
+
+int
+use2_1(s1& x)
+{return x.f1(x.next);}
+
+int
+use2_2(s2& x)
+{return x.f2(x.next);}
+
+int
+use2_3(s3& x)
+{return x.f3(x.next);}
+
+int
+use2_4(s4& x)
+{return x.f4(x.next);}
+
+int
+use2_5(s5& x)
+{return x.f5(x.next);}
+
+int
+use2_6(s6& x)
+{return x.f6(x.next);}
+
+int
+use2_7(s7& x)
+{return x.f7(x.next);}
+
+int
+use2_8(s8& x)
+{return x.f8(x.next);}
+
+int
+use2_9(s9& x)
+{return x.f9(x.next);}
+
+int
+use2_10(s10& x)
+{return x.f10(x.next);}
+
+int
+use2_11(s11& x)
+{return x.f11(x.next);}
+
+int
+use2_12(s12& x)
+{return x.f12(x.next);}
+
+int
+use2_13(s13& x)
+{return x.f13(x.next);}
+
+int
+use2_14(s14& x)
+{return x.f14(x.next);}
+
+int
+use2_15(s15& x)
+{return x.f15(x.next);}
+
+int
+use2_16(s16& x)
+{return x.f16(x.next);}
+
+int
+use2_17(s17& x)
+{return x.f17(x.next);}
+
+int
+use2_18(s18& x)
+{return x.f18(x.next);}
+
+int
+use2_19(s19& x)
+{return x.f19(x.next);}
+
+int
+use2_20(s20& x)
+{return x.f20(x.next);}
+
+int
+use2_21(s21& x)
+{return x.f21(x.next);}
+
+int
+use2_22(s22& x)
+{return x.f22(x.next);}
+
+int
+use2_23(s23& x)
+{return x.f23(x.next);}
+
+int
+use2_24(s24& x)
+{return x.f24(x.next);}
+
+int
+use2_25(s25& x)
+{return x.f25(x.next);}
+
+int
+use2_26(s26& x)
+{return x.f26(x.next);}
+
+int
+use2_27(s27& x)
+{return x.f27(x.next);}
+
+int
+use2_28(s28& x)
+{return x.f28(x.next);}
+
+int
+use2_29(s29& x)
+{return x.f29(x.next);}
+
+int
+use2_30(s30& x)
+{return x.f30(x.next);}
+
+int
+use2_31(s31& x)
+{return x.f31(x.next);}
+
+int
+use2_32(s32& x)
+{return x.f32(x.next);}
+
+int
+use2_33(s33& x)
+{return x.f33(x.next);}
+
+int
+use2_34(s34& x)
+{return x.f34(x.next);}
+
+int
+use2_35(s35& x)
+{return x.f35(x.next);}
+
+int
+use2_36(s36& x)
+{return x.f36(x.next);}
+
+int
+use2_37(s37& x)
+{return x.f37(x.next);}
+
+int
+use2_38(s38& x)
+{return x.f38(x.next);}
+
+int
+use2_39(s39& x)
+{return x.f39(x.next);}
+
+int
+use2_40(s40& x)
+{return x.f40(x.next);}
+
+int
+use2_41(s41& x)
+{return x.f41(x.next);}
+
+int
+use2_42(s42& x)
+{return x.f42(x.next);}
+
+int
+use2_43(s43& x)
+{return x.f43(x.next);}
+
+int
+use2_44(s44& x)
+{return x.f44(x.next);}
+
+int
+use2_45(s45& x)
+{return x.f45(x.next);}
+
+int
+use2_46(s46& x)
+{return x.f46(x.next);}
+
+int
+use2_47(s47& x)
+{return x.f47(x.next);}
+
+int
+use2_48(s48& x)
+{return x.f48(x.next);}
+
+int
+use2_49(s49& x)
+{return x.f49(x.next);}
+
+int
+use2_50(s50& x)
+{return x.f50(x.next);}
+
+int
+use2_51(s51& x)
+{return x.f51(x.next);}
+
+int
+use2_52(s52& x)
+{return x.f52(x.next);}
+
+int
+use2_53(s53& x)
+{return x.f53(x.next);}
+
+int
+use2_54(s54& x)
+{return x.f54(x.next);}
+
+int
+use2_55(s55& x)
+{return x.f55(x.next);}
+
+int
+use2_56(s56& x)
+{return x.f56(x.next);}
+
+int
+use2_57(s57& x)
+{return x.f57(x.next);}
+
+int
+use2_58(s58& x)
+{return x.f58(x.next);}
+
+int
+use2_59(s59& x)
+{return x.f59(x.next);}
+
+int
+use2_60(s60& x)
+{return x.f60(x.next);}
+
+int
+use2_61(s61& x)
+{return x.f61(x.next);}
+
+int
+use2_62(s62& x)
+{return x.f62(x.next);}
+
+int
+use2_63(s63& x)
+{return x.f63(x.next);}
+
+int
+use2_64(s64& x)
+{return x.f64(x.next);}
+
+int
+use2_65(s65& x)
+{return x.f65(x.next);}
+
+int
+use2_66(s66& x)
+{return x.f66(x.next);}
+
+int
+use2_67(s67& x)
+{return x.f67(x.next);}
+
+int
+use2_68(s68& x)
+{return x.f68(x.next);}
+
+int
+use2_69(s69& x)
+{return x.f69(x.next);}
+
+int
+use2_70(s70& x)
+{return x.f70(x.next);}
+
+int
+use2_71(s71& x)
+{return x.f71(x.next);}
+
+int
+use2_72(s72& x)
+{return x.f72(x.next);}
+
+int
+use2_73(s73& x)
+{return x.f73(x.next);}
+
+int
+use2_74(s74& x)
+{return x.f74(x.next);}
+
+int
+use2_75(s75& x)
+{return x.f75(x.next);}
+
+int
+use2_76(s76& x)
+{return x.f76(x.next);}
+
+int
+use2_77(s77& x)
+{return x.f77(x.next);}
+
+int
+use2_78(s78& x)
+{return x.f78(x.next);}
+
+int
+use2_79(s79& x)
+{return x.f79(x.next);}
+
+int
+use2_80(s80& x)
+{return x.f80(x.next);}
+
+int
+use2_81(s81& x)
+{return x.f81(x.next);}
+
+int
+use2_82(s82& x)
+{return x.f82(x.next);}
+
+int
+use2_83(s83& x)
+{return x.f83(x.next);}
+
+int
+use2_84(s84& x)
+{return x.f84(x.next);}
+
+int
+use2_85(s85& x)
+{return x.f85(x.next);}
+
+int
+use2_86(s86& x)
+{return x.f86(x.next);}
+
+int
+use2_87(s87& x)
+{return x.f87(x.next);}
+
+int
+use2_88(s88& x)
+{return x.f88(x.next);}
+
+int
+use2_89(s89& x)
+{return x.f89(x.next);}
+
+int
+use2_90(s90& x)
+{return x.f90(x.next);}
+
+int
+use2_91(s91& x)
+{return x.f91(x.next);}
+
+int
+use2_92(s92& x)
+{return x.f92(x.next);}
+
+int
+use2_93(s93& x)
+{return x.f93(x.next);}
+
+int
+use2_94(s94& x)
+{return x.f94(x.next);}
+
+int
+use2_95(s95& x)
+{return x.f95(x.next);}
+
+int
+use2_96(s96& x)
+{return x.f96(x.next);}
+
+int
+use2_97(s97& x)
+{return x.f97(x.next);}
+
+int
+use2_98(s98& x)
+{return x.f98(x.next);}
+
+int
+use2_99(s99& x)
+{return x.f99(x.next);}
@@ -0,0 +1,1105 @@
+/// The four compile units of test5-shared-classes.so use all the
+/// classes below, so the DWARF reader builds each of them only once
+/// when it deduplicates the types.  The translation units of the
+/// corpus then share these classes.
+
+struct s0;
+struct s1;
+struct s2;
+struct s3;
+struct s4;
+struct s5;
+struct s6;
+struct s7;
+struct s8;
+struct s9;
+struct s10;
+struct s11;
+struct s12;
+struct s13;
+struct s14;
+struct s15;
+struct s16;
+struct s17;
+struct s18;
+struct s19;
+struct s20;
+struct s21;
+struct s22;
+struct s23;
+struct s24;
+struct s25;
+struct s26;
+struct s27;
+struct s28;
+struct s29;
+struct s30;
+struct s31;
+struct s32;
+struct s33;
+struct s34;
+struct s35;
+struct s36;
+struct s37;
+struct s38;
+struct s39;
+struct s40;
+struct s41;
+struct s42;
+struct s43;
+struct s44;
+struct s45;
+struct s46;
+struct s47;
+struct s48;
+struct s49;
+struct s50;
+struct s51;
+struct s52;
+struct s53;
+struct s54;
+struct s55;
+struct s56;
+struct s57;
+struct s58;
+struct s59;
+struct s60;
+struct s61;
+struct s62;
+struct s63;
+struct s64;
+struct s65;
+struct s66;
+struct s67;
+struct s68;
+struct s69;
+struct s70;
+struct s71;
+struct s72;
+struct s73;
+struct s74;
+struct s75;
+struct s76;
+struct s77;
+struct s78;
+struct s79;
+struct s80;
+struct s81;
+struct s82;
+struct s83;
+struct s84;
+struct s85;
+struct s86;
+struct s87;
+struct s88;
+struct s89;
+struct s90;
+struct s91;
+struct s92;
+struct s93;
+struct s94;
+struct s95;
+struct s96;
+struct s97;
+struct s98;
+struct s99;
+
+struct s0
+{
+  int m0;
+  s1* next;
+
+  int
+  f0(s1* p)
+  {return p ? m0 : 0;}
+};
+
+struct s1 : s0
+{
+  int m1;
+  s2* next;
+
+  int
+  f1(s2* p)
+  {return p ? m1 : 0;}
+};
+
+struct s2 : s1
+{
+  int m2;
+  s3* next;
+
+  int
+  f2(s3* p)
+  {return p ? m2 : 0;}
+};
+
+struct s3 : s2
+{
+  int m3;
+  s4* next;
+
+  int
+  f3(s4* p)
+  {return p ? m3 : 0;}
+};
+
+struct s4 : s3
+{
+  int m4;
+  s5* next;
+
+  int
+  f4(s5* p)
+  {return p ? m4 : 0;}
+};
+
+struct s5
+{
+  int m5;
+  s6* next;
+
+  int
+  f5(s6* p)
+  {return p ? m5 : 0;}
+};
+
+struct s6 : s5
+{
+  int m6;
+  s7* next;
+
+  int
+  f6(s7* p)
+  {return p ? m6 : 0;}
+};
+
+struct s7 : s6
+{
+  int m7;
+  s8* next;
+
+  int
+  f7(s8* p)
+  {return p ? m7 : 0;}
+};
+
+struct s8 : s7
+{
+  int m8;
+  s9* next;
+
+  int
+  f8(s9* p)
+  {return p ? m8 : 0;}
+};
+
+struct s9 : s8
+{
+  int m9;
+  s10* next;
+
+  int
+  f9(s10* p)
+  {return p ? m9 : 0;}
+};
+
+struct s10
+{
+  int m10;
+  s11* next;
+
+  int
+  f10(s11* p)
+  {return p ? m10 : 0;}
+};
+
+struct s11 : s10
+{
+  int m11;
+  s12* next;
+
+  int
+  f11(s12* p)
+  {return p ? m11 : 0;}
+};
+
+struct s12 : s11
+{
+  int m12;
+  s13* next;
+
+  int
+  f12(s13* p)
+  {return p ? m12 : 0;}
+};
+
+struct s13 : s12
+{
+  int m13;
+  s14* next;
+
+  int
+  f13(s14* p)
+  {return p ? m13 : 0;}
+};
+
+struct s14 : s13
+{
+  int m14;
+  s15* next;
+
+  int
+  f14(s15* p)
+  {return p ? m14 : 0;}
+};
+
+struct s15
+{
+  int m15;
+  s16* next;
+
+  int
+  f15(s16* p)
+  {return p ? m15 : 0;}
+};
+
+struct s16 : s15
+{
+  int m16;
+  s17* next;
+
+  int
+  f16(s17* p)
+  {return p ? m16 : 0;}
+};
+
+struct s17 : s16
+{
+  int m17;
+  s18* next;
+
+  int
+  f17(s18* p)
+  {return p ? m17 : 0;}
+};
+
+struct s18 : s17
+{
+  int m18;
+  s19* next;
+
+  int
+  f18(s19* p)
+  {return p ? m18 : 0;}
+};
+
+struct s19 : s18
+{
+  int m19;
+  s20* next;
+
+  int
+  f19(s20* p)
+  {return p ? m19 : 0;}
+};
+
+struct s20
+{
+  int m20;
+  s21* next;
+
+  int
+  f20(s21* p)
+  {return p ? m20 : 0;}
+};
+
+struct s21 : s20
+{
+  int m21;
+  s22* next;
+
+  int
+  f21(s22* p)
+  {return p ? m21 : 0;}
+};
+
+struct s22 : s21
+{
+  int m22;
+  s23* next;
+
+  int
+  f22(s23* p)
+  {return p ? m22 : 0;}
+};
+
+struct s23 : s22
+{
+  int m23;
+  s24* next;
+
+  int
+  f23(s24* p)
+  {return p ? m23 : 0;}
+};
+
+struct s24 : s23
+{
+  int m24;
+  s25* next;
+
+  int
+  f24(s25* p)
+  {return p ? m24 : 0;}
+};
+
+struct s25
+{
+  int m25;
+  s26* next;
+
+  int
+  f25(s26* p)
+  {return p ? m25 : 0;}
+};
+
+struct s26 : s25
+{
+  int m26;
+  s27* next;
+
+  int
+  f26(s27* p)
+  {return p ? m26 : 0;}
+};
+
+struct s27 : s26
+{
+  int m27;
+  s28* next;
+
+  int
+  f27(s28* p)
+  {return p ? m27 : 0;}
+};
+
+struct s28 : s27
+{
+  int m28;
+  s29* next;
+
+  int
+  f28(s29* p)
+  {return p ? m28 : 0;}
+};
+
+struct s29 : s28
+{
+  int m29;
+  s30* next;
+
+  int
+  f29(s30* p)
+  {return p ? m29 : 0;}
+};
+
+struct s30
+{
+  int m30;
+  s31* next;
+
+  int
+  f30(s31* p)
+  {return p ? m30 : 0;}
+};
+
+struct s31 : s30
+{
+  int m31;
+  s32* next;
+
+  int
+  f31(s32* p)
+  {return p ? m31 : 0;}
+};
+
+struct s32 : s31
+{
+  int m32;
+  s33* next;
+
+  int
+  f32(s33* p)
+  {return p ? m32 : 0;}
+};
+
+struct s33 : s32
+{
+  int m33;
+  s34* next;
+
+  int
+  f33(s34* p)
+  {return p ? m33 : 0;}
+};
+
+struct s34 : s33
+{
+  int m34;
+  s35* next;
+
+  int
+  f34(s35* p)
+  {return p ? m34 : 0;}
+};
+
+struct s35
+{
+  int m35;
+  s36* next;
+
+  int
+  f35(s36* p)
+  {return p ? m35 : 0;}
+};
+
+struct s36 : s35
+{
+  int m36;
+  s37* next;
+
+  int
+  f36(s37* p)
+  {return p ? m36 : 0;}
+};
+
+struct s37 : s36
+{
+  int m37;
+  s38* next;
+
+  int
+  f37(s38* p)
+  {return p ? m37 : 0;}
+};
+
+struct s38 : s37
+{
+  int m38;
+  s39* next;
+
+  int
+  f38(s39* p)
+  {return p ? m38 : 0;}
+};
+
+struct s39 : s38
+{
+  int m39;
+  s40* next;
+
+  int
+  f39(s40* p)
+  {return p ? m39 : 0;}
+};
+
+struct s40
+{
+  int m40;
+  s41* next;
+
+  int
+  f40(s41* p)
+  {return p ? m40 : 0;}
+};
+
+struct s41 : s40
+{
+  int m41;
+  s42* next;
+
+  int
+  f41(s42* p)
+  {return p ? m41 : 0;}
+};
+
+struct s42 : s41
+{
+  int m42;
+  s43* next;
+
+  int
+  f42(s43* p)
+  {return p ? m42 : 0;}
+};
+
+struct s43 : s42
+{
+  int m43;
+  s44* next;
+
+  int
+  f43(s44* p)
+  {return p ? m43 : 0;}
+};
+
+struct s44 : s43
+{
+  int m44;
+  s45* next;
+
+  int
+  f44(s45* p)
+  {return p ? m44 : 0;}
+};
+
+struct s45
+{
+  int m45;
+  s46* next;
+
+  int
+  f45(s46* p)
+  {return p ? m45 : 0;}
+};
+
+struct s46 : s45
+{
+  int m46;
+  s47* next;
+
+  int
+  f46(s47* p)
+  {return p ? m46 : 0;}
+};
+
+struct s47 : s46
+{
+  int m47;
+  s48* next;
+
+  int
+  f47(s48* p)
+  {return p ? m47 : 0;}
+};
+
+struct s48 : s47
+{
+  int m48;
+  s49* next;
+
+  int
+  f48(s49* p)
+  {return p ? m48 : 0;}
+};
+
+struct s49 : s48
+{
+  int m49;
+  s50* next;
+
+  int
+  f49(s50* p)
+  {return p ? m49 : 0;}
+};
+
+struct s50
+{
+  int m50;
+  s51* next;
+
+  int
+  f50(s51* p)
+  {return p ? m50 : 0;}
+};
+
+struct s51 : s50
+{
+  int m51;
+  s52* next;
+
+  int
+  f51(s52* p)
+  {return p ? m51 : 0;}
+};
+
+struct s52 : s51
+{
+  int m52;
+  s53* next;
+
+  int
+  f52(s53* p)
+  {return p ? m52 : 0;}
+};
+
+struct s53 : s52
+{
+  int m53;
+  s54* next;
+
+  int
+  f53(s54* p)
+  {return p ? m53 : 0;}
+};
+
+struct s54 : s53
+{
+  int m54;
+  s55* next;
+
+  int
+  f54(s55* p)
+  {return p ? m54 : 0;}
+};
+
+struct s55
+{
+  int m55;
+  s56* next;
+
+  int
+  f55(s56* p)
+  {return p ? m55 : 0;}
+};
+
+struct s56 : s55
+{
+  int m56;
+  s57* next;
+
+  int
+  f56(s57* p)
+  {return p ? m56 : 0;}
+};
+
+struct s57 : s56
+{
+  int m57;
+  s58* next;
+
+  int
+  f57(s58* p)
+  {return p ? m57 : 0;}
+};
+
+struct s58 : s57
+{
+  int m58;
+  s59* next;
+
+  int
+  f58(s59* p)
+  {return p ? m58 : 0;}
+};
+
+struct s59 : s58
+{
+  int m59;
+  s60* next;
+
+  int
+  f59(s60* p)
+  {return p ? m59 : 0;}
+};
+
+struct s60
+{
+  int m60;
+  s61* next;
+
+  int
+  f60(s61* p)
+  {return p ? m60 : 0;}
+};
+
+struct s61 : s60
+{
+  int m61;
+  s62* next;
+
+  int
+  f61(s62* p)
+  {return p ? m61 : 0;}
+};
+
+struct s62 : s61
+{
+  int m62;
+  s63* next;
+
+  int
+  f62(s63* p)
+  {return p ? m62 : 0;}
+};
+
+struct s63 : s62
+{
+  int m63;
+  s64* next;
+
+  int
+  f63(s64* p)
+  {return p ? m63 : 0;}
+};
+
+struct s64 : s63
+{
+  int m64;
+  s65* next;
+
+  int
+  f64(s65* p)
+  {return p ? m64 : 0;}
+};
+
+struct s65
+{
+  int m65;
+  s66* next;
+
+  int
+  f65(s66* p)
+  {return p ? m65 : 0;}
+};
+
+struct s66 : s65
+{
+  int m66;
+  s67* next;
+
+  int
+  f66(s67* p)
+  {return p ? m66 : 0;}
+};
+
+struct s67 : s66
+{
+  int m67;
+  s68* next;
+
+  int
+  f67(s68* p)
+  {return p ? m67 : 0;}
+};
+
+struct s68 : s67
+{
+  int m68;
+  s69* next;
+
+  int
+  f68(s69* p)
+  {return p ? m68 : 0;}
+};
+
+struct s69 : s68
+{
+  int m69;
+  s70* next;
+
+  int
+  f69(s70* p)
+  {return p ? m69 : 0;}
+};
+
+struct s70
+{
+  int m70;
+  s71* next;
+
+  int
+  f70(s71* p)
+  {return p ? m70 : 0;}
+};
+
+struct s71 : s70
+{
+  int m71;
+  s72* next;
+
+  int
+  f71(s72* p)
+  {return p ? m71 : 0;}
+};
+
+struct s72 : s71
+{
+  int m72;
+  s73* next;
+
+  int
+  f72(s73* p)
+  {return p ? m72 : 0;}
+};
+
+struct s73 : s72
+{
+  int m73;
+  s74* next;
+
+  int
+  f73(s74* p)
+  {return p ? m73 : 0;}
+};
+
+struct s74 : s73
+{
+  int m74;
+  s75* next;
+
+  int
+  f74(s75* p)
+  {return p ? m74 : 0;}
+};
+
+struct s75
+{
+  int m75;
+  s76* next;
+
+  int
+  f75(s76* p)
+  {return p ? m75 : 0;}
+};
+
+struct s76 : s75
+{
+  int m76;
+  s77* next;
+
+  int
+  f76(s77* p)
+  {return p ? m76 : 0;}
+};
+
+struct s77 : s76
+{
+  int m77;
+  s78* next;
+
+  int
+  f77(s78* p)
+  {return p ? m77 : 0;}
+};
+
+struct s78 : s77
+{
+  int m78;
+  s79* next;
+
+  int
+  f78(s79* p)
+  {return p ? m78 : 0;}
+};
+
+struct s79 : s78
+{
+  int m79;
+  s80* next;
+
+  int
+  f79(s80* p)
+  {return p ? m79 : 0;}
+};
+
+struct s80
+{
+  int m80;
+  s81* next;
+
+  int
+  f80(s81* p)
+  {return p ? m80 : 0;}
+};
+
+struct s81 : s80
+{
+  int m81;
+  s82* next;
+
+  int
+  f81(s82* p)
+  {return p ? m81 : 0;}
+};
+
+struct s82 : s81
+{
+  int m82;
+  s83* next;
+
+  int
+  f82(s83* p)
+  {return p ? m82 : 0;}
+};
+
+struct s83 : s82
+{
+  int m83;
+  s84* next;
+
+  int
+  f83(s84* p)
+  {return p ? m83 : 0;}
+};
+
+struct s84 : s83
+{
+  int m84;
+  s85* next;
+
+  int
+  f84(s85* p)
+  {return p ? m84 : 0;}
+};
+
+struct s85
+{
+  int m85;
+  s86* next;
+
+  int
+  f85(s86* p)
+  {return p ? m85 : 0;}
+};
+
+struct s86 : s85
+{
+  int m86;
+  s87* next;
+
+  int
+  f86(s87* p)
+  {return p ? m86 : 0;}
+};
+
+struct s87 : s86
+{
+  int m87;
+  s88* next;
+
+  int
+  f87(s88* p)
+  {return p ? m87 : 0;}
+};
+
+struct s88 : s87
+{
+  int m88;
+  s89* next;
+
+  int
+  f88(s89* p)
+  {return p ? m88 : 0;}
+};
+
+struct s89 : s88
+{
+  int m89;
+  s90* next;
+
+  int
+  f89(s90* p)
+  {return p ? m89 : 0;}
+};
+
+struct s90
+{
+  int m90;
+  s91* next;
+
+  int
+  f90(s91* p)
+  {return p ? m90 : 0;}
+};
+
+struct s91 : s90
+{
+  int m91;
+  s92* next;
+
+  int
+  f91(s92* p)
+  {return p ? m91 : 0;}
+};
+
+struct s92 : s91
+{
+  int m92;
+  s93* next;
+
+  int
+  f92(s93* p)
+  {return p ? m92 : 0;}
+};
+
+struct s93 : s92
+{
+  int m93;
+  s94* next;
+
+  int
+  f93(s94* p)
+  {return p ? m93 : 0;}
+};
+
+struct s94 : s93
+{
+  int m94;
+  s95* next;
+
+  int
+  f94(s95* p)
+  {return p ? m94 : 0;}
+};
+
+struct s95
+{
+  int m95;
+  s96* next;
+
+  int
+  f95(s96* p)
+  {return p ? m95 : 0;}
+};
+
+struct s96 : s95
+{
+  int m96;
+  s97* next;
+
+  int
+  f96(s97* p)
+  {return p ? m96 : 0;}
+};
+
+struct s97 : s96
+{
+  int m97;
+  s98* next;
+
+  int
+  f97(s98* p)
+  {return p ? m97 : 0;}
+};
+
+struct s98 : s97
+{
+  int m98;
+  s99* next;
+
+  int
+  f98(s99* p)
+  {return p ? m98 : 0;}
+};
+
+struct s99 : s98
+{
+  int m99;
+  s0* next;
+
+  int
+  f99(s0* p)
+  {return p ? m99 : 0;}
+};
@@ -33,8 +33,10 @@
 #include <fstream>
 #include <iostream>
 #include <cstdlib>
+#include <sstream>
 #include "abg-tools-utils.h"
 #include "abg-reader.h"
+#include "abg-writer.h"
 #include "test-utils.h"
 #include "abg-comparison.h"
 #include "abg-corpus.h"
@@ -49,6 +51,16 @@ struct InOutSpec
   const char* second_in_path;
   const char* ref_diff_path;
   const char* out_path;
+  // The reference JSON report, or null if the JSON report is not to
+  // be checked.
+  const char* ref_json_path;
+  const char* out_json_path;
+  // The number of declarations that pruning the types that are not
+  // reachable from the exported declarations is expected to remove
+  // from the first and second corpora.  This is only checked for
+  // corpora.
+  size_t first_num_pruned;
+  size_t second_num_pruned;
 };// end struct InOutSpec
 
 static InOutSpec specs[] =
@@ -57,46 +69,84 @@ static InOutSpec specs[] =
     "data/test-abidiff/test-enum0-v0.cc.bi",
     "data/test-abidiff/test-enum0-v1.cc.bi",
     "data/test-abidiff/test-enum0-report.txt",
-    "output/test-abidiff/test-enum0-report.txt"
+    "output/test-abidiff/test-enum0-report.txt",
+    0,
+    0,
+    0,
+    0
   },
   {
     "data/test-abidiff/test-enum1-v0.cc.bi",
     "data/test-abidiff/test-enum1-v1.cc.bi",
     "data/test-abidiff/test-enum1-report.txt",
-    "output/test-abidiff/test-enum1-report.txt"
+    "output/test-abidiff/test-enum1-report.txt",
+    0,
+    0,
+    0,
+    0
   },
   {
     "data/test-abidiff/test-qual-type0-v0.cc.bi",
     "data/test-abidiff/test-qual-type0-v1.cc.bi",
     "data/test-abidiff/test-qual-type0-report.txt",
-    "output/test-abidiff/test-qual-type0-report.txt"
+    "output/test-abidiff/test-qual-type0-report.txt",
+    0,
+    0,
+    0,
+    0
   },
   {
     "data/test-abidiff/test-struct0-v0.cc.bi",
     "data/test-abidiff/test-struct0-v1.cc.bi",
     "data/test-abidiff/test-struct0-report.txt",
-    "output/test-abidiff/test-struct0-report.txt"
+    "output/test-abidiff/test-struct0-report.txt",
+    "data/test-abidiff/test-struct0-report.json",
+    "output/test-abidiff/test-struct0-report.json",
+    0,
+    0
   },
   {
     "data/test-abidiff/test-struct1-v0.cc.bi",
     "data/test-abidiff/test-struct1-v1.cc.bi",
     "data/test-abidiff/test-struct1-report.txt",
-    "output/test-abidiff/test-struct1-report.txt"
+    "output/test-abidiff/test-struct1-report.txt",
+    0,
+    0,
+    0,
+    0
   },
   {
     "data/test-abidiff/test-var0-v0.cc.bi",
     "data/test-abidiff/test-var0-v1.cc.bi",
     "data/test-abidiff/test-var0-report.txt",
-    "output/test-abidiff/test-var0-report.txt"
+    "output/test-abidiff/test-var0-report.txt",
+    0,
+    0,
+    0,
+    0
   },
   {
     "data/test-abidiff/test-corpus0-v0.so.abi",
     "data/test-abidiff/test-corpus0-v1.so.abi",
     "data/test-abidiff/test-corpus0-report0.txt",
-    "output/test-abidiff/test-corpus0-report0.txt"
+    "output/test-abidiff/test-corpus0-report0.txt",
+    "data/test-abidiff/test-corpus0-report0.json",
+    "output/test-abidiff/test-corpus0-report0.json",
+    2135,
+    2135
+  },
+  {
+    "data/test-abidiff/test-corpus1-v0.so.abi",
+    "data/test-abidiff/test-corpus1-v1.so.abi",
+    "data/test-abidiff/test-corpus1-report0.txt",
+    "output/test-abidiff/test-corpus1-report0.txt",
+    "data/test-abidiff/test-corpus1-report0.json",
+    "output/test-abidiff/test-corpus1-report0.json",
+    5,
+    5
   },
   // This should be the last entry.
-  {0, 0, 0, 0}
+  {0, 0, 0, 0, 0, 0, 0, 0}
 };
 
 #define  NUM_SPEC_ELEMS \
@@ -113,9 +163,16 @@ using abigail::translation_unit;
 using abigail::translation_unit_sptr;
 using abigail::xml_reader::read_translation_unit_from_file;
 using abigail::xml_reader::read_corpus_from_native_xml_file;
+using abigail::xml_reader::read_corpus_from_native_xml;
+using abigail::xml_writer::write_corpus_to_native_xml;
+using abigail::comparison::corpus_diff;
 using abigail::comparison::corpus_diff_sptr;
+using abigail::comparison::corpus_change_kind;
+using abigail::comparison::compute_corpus_change_kind;
 using abigail::comparison::translation_unit_diff_sptr;
 using abigail::comparison::compute_diff;
+using abigail::comparison::diff_sptr;
+using abigail::comparison::report_as_json;
 
 int
 main(int, char*[])
@@ -201,6 +258,109 @@ main(int, char*[])
       string cmd = "diff -u " + ref_diff_path + " " + out_path;
       if (system(cmd.c_str()))
 	is_ok = false;
+
+      if (s->ref_json_path)
+	{
+	  string ref_json_path =
+	    abigail::tests::get_src_dir() + "/tests/" + s->ref_json_path;
+	  string out_json_path =
+	    abigail::tests::get_build_dir() + "/tests/" + s->out_json_path;
+	  ofstream jof(out_json_path.c_str(), std::ios_base::trunc);
+	  if (!jof.is_open())
+	    {
+	      cerr << "failed to open " << s->out_json_path << "\n";
+	      is_ok = false;
+	      continue;
+	    }
+	  if (d1)
+	    report_as_json(diff_sptr(d1), jof);
+	  else
+	    report_as_json(d2, jof);
+	  jof << "\n";
+	  jof.close();
+
+	  cmd = "diff -u " + ref_json_path + " " + out_json_path;
+	  if (system(cmd.c_str()))
+	    is_ok = false;
+	}
+
+      if (d2)
+	{
+	  // The quick computation of the kind of changes must agree
+	  // with the statistics of the full diff.
+	  const corpus_diff::diff_stats& stats =
+	    d2->apply_filters_and_suppressions_before_reporting();
+	  corpus_change_kind expected =
+	    abigail::comparison::NO_CORPUS_CHANGE_KIND;
+	  if (d2->soname_changed()
+	      || stats.num_func_removed() != 0
+	      || stats.num_vars_removed() != 0
+	      || stats.num_func_syms_removed() != 0
+	      || stats.num_var_syms_removed() != 0)
+	    expected = abigail::comparison::INCOMPATIBLE_CORPUS_CHANGE_KIND;
+	  else if (stats.net_num_func_changed() != 0
+		   || stats.net_num_vars_changed() != 0)
+	    expected = abigail::comparison::COMPATIBLE_CORPUS_CHANGE_KIND;
+
+	  if (compute_corpus_change_kind(corpus1, corpus2) != expected)
+	    {
+	      cerr << "unexpected kind of changes between "
+		   << first_in_path << " and " << second_in_path << "\n";
+	      is_ok = false;
+	    }
+
+	  // Pruning the types that are not reachable from the exported
+	  // declarations must remove the expected number of
+	  // declarations.  It must change neither the report, nor the
+	  // ability to read the corpus back from its serialization.
+	  size_t num_pruned = corpus1->prune_unreachable_types();
+	  if (num_pruned != s->first_num_pruned)
+	    {
+	      cerr << "pruning " << first_in_path << " removed "
+		   << num_pruned << " declarations instead of "
+		   << s->first_num_pruned << "\n";
+	      is_ok = false;
+	    }
+	  num_pruned = corpus2->prune_unreachable_types();
+	  if (num_pruned != s->second_num_pruned)
+	    {
+	      cerr << "pruning " << second_in_path << " removed "
+		   << num_pruned << " declarations instead of "
+		   << s->second_num_pruned << "\n";
+	      is_ok = false;
+	    }
+
+	  std::ostringstream serialized;
+	  write_corpus_to_native_xml(corpus1, /*indent=*/0, serialized);
+	  std::istringstream in(serialized.str());
+	  corpus_sptr pruned = read_corpus_from_native_xml(&in);
+	  if (!pruned)
+	    {
+	      cerr << "failed to read back the pruned " << first_in_path
+		   << "\n";
+	      is_ok = false;
+	      continue;
+	    }
+
+	  string pruned_out_path = out_path + ".pruned";
+	  ofstream pof(pruned_out_path.c_str(), std::ios_base::trunc);
+	  if (!pof.is_open())
+	    {
+	      cerr << "failed to open " << pruned_out_path << "\n";
+	      is_ok = false;
+	      continue;
+	    }
+	  compute_diff(pruned, corpus2)->report(pof);
+	  pof.close();
+
+	  cmd = "diff -u " + ref_diff_path + " " + pruned_out_path;
+	  if (system(cmd.c_str()))
+	    {
+	      cerr << "pruning unreachable types changed the report of "
+		   << first_in_path << " and " << second_in_path << "\n";
+	      is_ok = false;
+	    }
+	}
     }
 
   return !is_ok;
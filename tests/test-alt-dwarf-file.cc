@@ -24,14 +24,26 @@
 ///
 /// This program tests that libabigail can handle alternate debug info
 /// files as specified by http://www.dwarfstd.org/ShowIssue.php?issue=120604.1.
+///
+/// It also tests that separate and alternate debug info files can be
+/// found through the index built by build_debug_info_index().
 
 #include <iostream>
+#include <fstream>
 #include <cstdlib>
+#include <vector>
+#include "abg-corpus.h"
+#include "abg-comparison.h"
+#include "abg-dwarf-reader.h"
+#include "abg-reader.h"
+#include "abg-writer.h"
 #include "abg-tools-utils.h"
 #include "test-utils.h"
 
 using std::cerr;
+using std::ofstream;
 using std::string;
+using std::vector;
 
 struct InOutSpec
 {
@@ -64,6 +76,236 @@ InOutSpec in_out_specs[] =
   {NULL, NULL, NULL, NULL, NULL}
 };
 
+/// Test build_debug_info_index() and the lookup of debug info files
+/// through the index it builds.
+///
+/// The debug info files of libtest1.so and libtest0.so are copied
+/// into a directory of the build tree, at paths where elfutils
+/// cannot find them: the .gnu_debuglink and .gnu_debugaltlink
+/// sections of these binaries name other files, and there is no
+/// .build-id sub-directory.  The index of that directory is then
+/// built and both files are looked up through it.
+///
+/// @return true iff the test passed.
+static bool
+test_debug_info_index()
+{
+  using abigail::tests::get_src_dir;
+  using abigail::tests::get_build_dir;
+  using abigail::corpus_sptr;
+  using abigail::dwarf_reader::status;
+  using abigail::dwarf_reader::build_debug_info_index;
+  using abigail::dwarf_reader::read_corpus_from_elf;
+
+  bool is_ok = true;
+  string data_dir = get_src_dir() + "/tests/data/test-alt-dwarf-file";
+  string out_dir = get_build_dir() + "/tests/output/test-alt-dwarf-file";
+  string debug_info_dir = out_dir + "/index-debug-dir";
+
+  string cmd = "rm -rf " + debug_info_dir
+    + " && mkdir -p " + debug_info_dir + "/separate "
+    + debug_info_dir + "/alternate"
+    + " && cp " + data_dir + "/test1-debug-dir/test1-moved.debug "
+    + debug_info_dir + "/separate/"
+    + " && cp " + data_dir + "/test0-common-dwz.debug "
+    + debug_info_dir + "/alternate/common-moved.debug";
+  if (system(cmd.c_str()))
+    {
+      cerr << "command failed: " << cmd << "\n";
+      return false;
+    }
+
+  size_t num_files = 0;
+  if (!build_debug_info_index(debug_info_dir, num_files))
+    {
+      cerr << "could not build the debug info index of "
+	   << debug_info_dir << "\n";
+      return false;
+    }
+  if (num_files != 2)
+    {
+      cerr << "indexed " << num_files << " files under "
+	   << debug_info_dir << " instead of 2\n";
+      is_ok = false;
+    }
+
+  // The order of the entries of the index is unspecified.
+  string out_index_path = out_dir + "/test1-debug-info-index.txt";
+  cmd = "sort " + debug_info_dir + "/.abigail-debug-info-index > "
+    + out_index_path + " && diff -u " + data_dir
+    + "/test1-debug-info-index.txt " + out_index_path;
+  if (system(cmd.c_str()))
+    is_ok = false;
+
+  // The separate debug info file of libtest1.so is found through the
+  // index.
+  char* root = const_cast<char*>(debug_info_dir.c_str());
+  corpus_sptr corp;
+  status st = read_corpus_from_elf(data_dir + "/libtest1.so", &root,
+				   /*load_all_types=*/false, corp);
+  if (!(st & abigail::dwarf_reader::STATUS_OK)
+      || (st & abigail::dwarf_reader::STATUS_DEBUG_INFO_NOT_FOUND))
+    {
+      cerr << "could not find the debug info of libtest1.so under "
+	   << debug_info_dir << "\n";
+      return false;
+    }
+  corp->set_path("data/test-alt-dwarf-file/libtest1.so");
+  corp->set_architecture_name("");
+  string out_abi_path = out_dir + "/libtest1.so.abi";
+  ofstream of(out_abi_path.c_str(), std::ios_base::trunc);
+  if (!of.is_open())
+    {
+      cerr << "failed to open " << out_abi_path << "\n";
+      return false;
+    }
+  abigail::xml_writer::write_corpus_to_native_xml(corp, /*indent=*/0, of);
+  of.close();
+  cmd = "diff -u " + data_dir + "/libtest1.so.abi " + out_abi_path;
+  if (system(cmd.c_str()))
+    is_ok = false;
+
+  // So is the alternate debug info file of libtest0.so.
+  string out_report_path = out_dir + "/test1-index-alt-report.txt";
+  cmd = get_build_dir() + "/tools/abidw --debug-info-dir "
+    + debug_info_dir + " --check-alternate-debug-info-base-name "
+    + data_dir + "/libtest0.so > " + out_report_path
+    + " && diff -u " + data_dir + "/test1-index-alt-report.txt "
+    + out_report_path;
+  if (system(cmd.c_str()))
+    is_ok = false;
+
+  return is_ok;
+}
+
+/// Test that binaries sharing an alternate debug info file can be
+/// read one after the other by the same process.
+///
+/// Get the type of the data member m0 of the type of the global
+/// variable global_s of a corpus of libtest0.so.
+///
+/// @param corp the corpus to consider.
+///
+/// @return the type, or nil if it wasn't found.
+static abigail::type_base_sptr
+get_type_of_m0(const abigail::corpus_sptr& corp)
+{
+  using abigail::corpus;
+  using abigail::class_decl_sptr;
+
+  const corpus::variables& vars = corp->get_variables();
+  for (corpus::variables::const_iterator v = vars.begin();
+       v != vars.end();
+       ++v)
+    if ((*v)->get_name() == "global_s")
+      if (class_decl_sptr s = abigail::is_class_type((*v)->get_type()))
+	if (!s->get_data_members().empty())
+	  return s->get_data_members().front()->get_type();
+
+  return abigail::type_base_sptr();
+}
+
+/// libtest0.so and libtest0-common.so both refer to
+/// test0-common-dwz.debug.  The first read opens it and adds it to
+/// the alternate debug info files of the process; the next ones get
+/// it, and a handle on it, from there.  The types built from the
+/// alternate debug info file by a read are shared with the reads
+/// that come next, and must still be serialized in the abixml of
+/// each corpus that refers to them.
+///
+/// @return true iff the test passed.
+static bool
+test_shared_alt_debug_info()
+{
+  using abigail::tests::get_src_dir;
+  using abigail::tests::get_build_dir;
+  using abigail::corpus_sptr;
+  using abigail::dwarf_reader::status;
+  using abigail::dwarf_reader::read_corpus_from_elf;
+
+  // The binaries to read, and the abixml expected for each of them.
+  static const char* binaries[][2] =
+    {
+      {"libtest0.so", "libtest0.so.abi"},
+      // The next reads get a handle on the alternate debug info file
+      // that the first read opened, and the types the first read
+      // built from it.  The shared types are serialized after the
+      // types of the corpus.
+      {"libtest0-common.so", "libtest0-common.so.abi"},
+      // Read again, with the handle the first read gave back.
+      {"libtest0.so", "libtest0.so.shared-types.abi"},
+      {0, 0}
+    };
+
+  bool is_ok = true;
+  string data_dir = get_src_dir() + "/tests/data/test-alt-dwarf-file";
+  string out_dir = get_build_dir() + "/tests/output/test-alt-dwarf-file";
+  string debug_info_dir = data_dir + "/test0-debug-dir";
+  char* root = const_cast<char*>(debug_info_dir.c_str());
+  vector<corpus_sptr> corpora;
+
+  for (size_t b = 0; binaries[b][0]; ++b)
+    {
+      string name = binaries[b][0], reference = binaries[b][1];
+      corpus_sptr corp;
+      status st = read_corpus_from_elf(data_dir + "/" + name, &root,
+				       /*load_all_types=*/false, corp);
+      if (!(st & abigail::dwarf_reader::STATUS_OK)
+	  || (st & abigail::dwarf_reader::STATUS_DEBUG_INFO_NOT_FOUND))
+	{
+	  cerr << "could not find the debug info of " << name
+	       << " under " << debug_info_dir << "\n";
+	  is_ok = false;
+	  return is_ok;
+	}
+      corpora.push_back(corp);
+      corp->set_path("data/test-alt-dwarf-file/" + name);
+      corp->set_architecture_name("");
+      string out_abi_path = out_dir + "/" + reference;
+      ofstream of(out_abi_path.c_str(), std::ios_base::trunc);
+      if (!of.is_open())
+	{
+	  cerr << "failed to open " << out_abi_path << "\n";
+	  is_ok = false;
+	  continue;
+	}
+      abigail::xml_writer::write_corpus_to_native_xml(corp, /*indent=*/0, of);
+      of.close();
+      string cmd = "diff -u " + data_dir + "/" + reference + " "
+	+ out_abi_path;
+      if (system(cmd.c_str()))
+	is_ok = false;
+    }
+
+  // The type of S::m0 comes from the alternate debug info file.  The
+  // third read must not have built it again.
+  abigail::type_base_sptr first_m0_type = get_type_of_m0(corpora[0]),
+    third_m0_type = get_type_of_m0(corpora[2]);
+  if (!first_m0_type || first_m0_type != third_m0_type)
+    {
+      cerr << "the type of S::m0 is not shared among the corpora of "
+	   << "libtest0.so\n";
+      is_ok = false;
+    }
+
+  // The abixml of the third read must describe the same ABI as the
+  // corpus of the first read.
+  corpus_sptr read_back =
+    abigail::xml_reader::read_corpus_from_native_xml_file
+    (out_dir + "/" + binaries[2][1]);
+  if (!read_back
+      || abigail::comparison::compute_diff(corpora[0], read_back,
+					   abigail::comparison::
+					   diff_context_sptr())->has_changes())
+    {
+      cerr << "the abixml of the third read of libtest0.so does not "
+	   << "describe its ABI\n";
+      is_ok = false;
+    }
+
+  return is_ok;
+}
+
 int
 main()
 {
@@ -111,5 +353,11 @@ main()
 	}
     }
 
+  if (!test_debug_info_index())
+    is_ok = false;
+
+  if (!test_shared_alt_debug_info())
+    is_ok = false;
+
   return !is_ok;
 }
@@ -21,6 +21,8 @@
 // Author: Dodji Seketeli
 
 #include <string>
+#include <cstring>
+#include <vector>
 #include <fstream>
 #include <iostream>
 #include <cstdlib>
@@ -29,6 +31,7 @@
 #include "test-utils.h"
 
 using std::string;
+using std::vector;
 using std::ofstream;
 using std::cerr;
 
@@ -139,10 +142,135 @@ SESInOutSpec in_out_specs[] =
   {NULL, NULL, NULL, NULL}
 };
 
+/// This structure describes a pair of strings to diff against each
+/// other with both compute_diff() and compute_trimmed_diff().
+struct TrimmedDiffSpec
+{
+  const char* first_string;
+  const char* second_string;
+};// end struct TrimmedDiffSpec
+
+TrimmedDiffSpec trimmed_diff_specs[] =
+{
+  // The strings only have a common prefix.
+  {"abcdef", "abcxyz"},
+  {"abc", "abcdef"},
+  // The strings only have a common suffix.
+  {"xyzdef", "abcdef"},
+  {"def", "abcdef"},
+  // The strings are equal.
+  {"abcdef", "abcdef"},
+  // Some strings are empty.
+  {"", ""},
+  {"", "abc"},
+  {"abc", ""},
+  // The strings have repeated elements.
+  {"aaaa", "aa"},
+  {"abababab", "baba"},
+  {"aabbaabb", "abbaab"},
+  {"xxabxx", "xbx"},
+  {"abcabba", "cbabac"},
+  // This should be the last entry.
+  {NULL, NULL}
+};
+
+using abigail::diff_utils::point;
 using abigail::diff_utils::edit_script;
+using abigail::diff_utils::default_eq_functor;
+using abigail::diff_utils::compute_diff;
+using abigail::diff_utils::compute_trimmed_diff;
 using abigail::diff_utils::compute_ses;
 using abigail::diff_utils::display_edit_script;
 
+/// Build the longest common subsequence designated by a vector of
+/// points, checking that these points do designate a common
+/// subsequence of two strings.
+///
+/// @param lcs the points of the longest common subsequence.
+///
+/// @param str1 the first string.
+///
+/// @param str2 the second string.
+///
+/// @param result output parameter.  The common subsequence.
+///
+/// @return true iff @p lcs designates a common subsequence of @p str1
+/// and @p str2.
+static bool
+build_lcs(const vector<point>& lcs,
+	  const char* str1,
+	  const char* str2,
+	  string& result)
+{
+  for (unsigned i = 0; i < lcs.size(); ++i)
+    {
+      int x = lcs[i].x(), y = lcs[i].y();
+      if (x < 0 || x >= (int) strlen(str1)
+	  || y < 0 || y >= (int) strlen(str2)
+	  || str1[x] != str2[y]
+	  || (i > 0 && (x <= lcs[i - 1].x() || y <= lcs[i - 1].y())))
+	return false;
+      result.push_back(str1[x]);
+    }
+  return true;
+}
+
+/// Diff two strings with compute_diff() and compute_trimmed_diff(),
+/// and check that compute_diff() finds a longest common subsequence,
+/// and that both functions find the same longest common subsequence
+/// and edit scripts of the same length.
+///
+/// @param s the strings to diff.
+///
+/// @return true iff the two functions agree.
+static bool
+check_trimmed_diff(const TrimmedDiffSpec& s)
+{
+  const char *a = s.first_string, *b = s.second_string;
+  const char *a_end = a + strlen(a), *b_end = b + strlen(b);
+
+  vector<point> lcs, trimmed_lcs;
+  edit_script ses, trimmed_ses;
+  int ses_len = 0;
+  compute_diff<const char*, default_eq_functor>(a, a_end, b, b_end,
+						lcs, ses, ses_len);
+  compute_trimmed_diff<const char*, default_eq_functor>(a, a_end,
+							b, b_end,
+							trimmed_lcs,
+							trimmed_ses);
+
+  string lcs_str, trimmed_lcs_str;
+  if (!build_lcs(lcs, a, b, lcs_str)
+      || !build_lcs(trimmed_lcs, a, b, trimmed_lcs_str))
+    {
+      cerr << "invalid longest common subsequence of '" << a
+	   << "' and '" << b << "'\n";
+      return false;
+    }
+
+  // Every element that is not part of the edit script is part of
+  // the longest common subsequence.
+  int a_size = a_end - a, b_size = b_end - b;
+  if (2 * (int) lcs_str.size() != a_size + b_size - ses.length())
+    {
+      cerr << "compute_diff found the common subsequence '" << lcs_str
+	   << "' of '" << a << "' and '" << b
+	   << "', which is not the longest one\n";
+      return false;
+    }
+
+  if (lcs_str != trimmed_lcs_str || ses.length() != trimmed_ses.length())
+    {
+      cerr << "compute_diff and compute_trimmed_diff disagree on '"
+	   << a << "' and '" << b << "': LCS '" << lcs_str
+	   << "' and '" << trimmed_lcs_str << "', SES length "
+	   << ses.length() << " and " << trimmed_ses.length() << "\n";
+      return false;
+    }
+
+  return true;
+}
+
 int
 main()
 {
@@ -187,5 +315,9 @@ main()
 	problem= true;
     }
 
+  for (TrimmedDiffSpec *s = trimmed_diff_specs; s->first_string; ++s)
+    if (!check_trimmed_diff(*s))
+      problem = true;
+
   return problem;
 }
@@ -224,6 +224,12 @@ InOutSpec in_out_specs[] =
     "data/test-diff-dwarf/test26-added-parms-before-variadic-report.txt",
     "output/test-diff-dwarf/test26-added-parms-before-variadic-report.txt"
   },
+  {
+    "data/test-diff-dwarf/libtest27-recursive-decl-only-v0.so",
+    "data/test-diff-dwarf/libtest27-recursive-decl-only-v1.so",
+    "data/test-diff-dwarf/test27-recursive-decl-only-report.txt",
+    "output/test-diff-dwarf/test27-recursive-decl-only-report.txt"
+  },
   // This should be the last entry
   {NULL, NULL, NULL, NULL}
 };
@@ -32,13 +32,17 @@
 
 #include <cstring>
 #include <string>
+#include <vector>
 #include <fstream>
 #include <iostream>
 #include <cstdlib>
 #include "abg-tools-utils.h"
+#include "abg-dwarf-reader.h"
+#include "abg-comparison.h"
 #include "test-utils.h"
 
 using std::string;
+using std::vector;
 using std::cerr;
 
 /// This is an aggregate that specifies where a test shall get its
@@ -363,6 +367,220 @@ InOutSpec in_out_specs[] =
   {NULL, NULL, NULL, NULL, NULL, NULL}
 };
 
+using abigail::corpus_sptr;
+using abigail::comparison::diff;
+using abigail::comparison::class_diff;
+using abigail::comparison::corpus_diff_sptr;
+using abigail::comparison::diff_context;
+using abigail::comparison::diff_context_sptr;
+using abigail::comparison::diff_node_visitor;
+using abigail::comparison::type_suppression;
+using abigail::comparison::type_suppression_sptr;
+using abigail::comparison::DO_NOT_MARK_VISITED_NODES_AS_VISITED;
+
+/// A diff node visitor that collects the diff nodes about a given
+/// class.
+struct class_diff_collector : public diff_node_visitor
+{
+  string class_name;
+  vector<diff*> nodes;
+
+  class_diff_collector(const string& name)
+    : diff_node_visitor(DO_NOT_MARK_VISITED_NODES_AS_VISITED),
+      class_name(name)
+  {}
+
+  virtual void
+  visit_begin(diff* d)
+  {
+    if (class_diff* c = dynamic_cast<class_diff*>(d))
+      if (c->first_class_decl()->get_name() == class_name)
+	nodes.push_back(d);
+  }
+};// end struct class_diff_collector
+
+/// Diff two corpora in a new diff context and collect the diff nodes
+/// about a given class.
+///
+/// @param corp0 the first corpus to consider.
+///
+/// @param corp1 the second corpus to consider.
+///
+/// @param class_name the name of the class to collect the diff nodes
+/// of.
+///
+/// @param ctxt output parameter.  The new diff context.
+///
+/// @param corp_diff output parameter.  The diff of the two corpora.
+/// It owns the collected diff nodes.
+///
+/// @param nodes output parameter.  The collected diff nodes.
+static void
+collect_class_diff_nodes(const corpus_sptr corp0,
+			 const corpus_sptr corp1,
+			 const string& class_name,
+			 diff_context_sptr& ctxt,
+			 corpus_diff_sptr& corp_diff,
+			 vector<diff*>& nodes)
+{
+  using abigail::comparison::compute_diff;
+
+  ctxt.reset(new diff_context);
+  ctxt->forbid_visiting_a_node_twice(false);
+  corp_diff = compute_diff(corp0, corp1, ctxt);
+
+  class_diff_collector collector(class_name);
+  corp_diff->traverse(collector);
+  nodes = collector.nodes;
+}
+
+/// Build a type suppression specification.
+///
+/// @param name_regex the regular expression the name of the types to
+/// suppress must match, or the empty string.
+///
+/// @param name the name of the types to suppress, or the empty
+/// string.
+///
+/// @return the new suppression specification.
+static type_suppression_sptr
+make_type_suppression(const string& name_regex, const string& name)
+{
+  type_suppression_sptr s(new type_suppression("", name_regex, name));
+  return s;
+}
+
+/// Test if a set of diff nodes are all suppressed, or all not
+/// suppressed.
+///
+/// @param nodes the diff nodes to consider.
+///
+/// @param suppressed whether the nodes are expected to be suppressed.
+///
+/// @param what a description of the case being checked, to report
+/// failures.
+///
+/// @return true iff all of @p nodes are suppressed iff @p suppressed
+/// is true.
+static bool
+check_suppressed(const vector<diff*>& nodes,
+		 bool suppressed,
+		 const string& what)
+{
+  for (vector<diff*>::const_iterator i = nodes.begin();
+       i != nodes.end();
+       ++i)
+    if ((*i)->is_suppressed() != suppressed)
+      {
+	cerr << what << ": diff node about '"
+	     << (*i)->first_subject()->get_pretty_representation()
+	     << "' is " << (suppressed ? "not " : "") << "suppressed\n";
+	return false;
+      }
+  return true;
+}
+
+/// Check that the index of the suppressions of a diff context gives
+/// diff::is_suppressed() the same verdicts as evaluating each
+/// suppression specification would.
+///
+/// This uses a library with two functions that take a pointer and a
+/// reference to the same changed struct S, so the diff nodes about S
+/// share the same canonical diff node.
+///
+/// @return true iff the checks pass.
+static bool
+check_suppressions_index()
+{
+  using abigail::tests::get_src_dir;
+  using abigail::dwarf_reader::read_corpus_from_elf;
+
+  string in_elfv0_path = get_src_dir()
+    + "/tests/data/test-diff-suppr/libtest8-redundant-fn-v0.so";
+  string in_elfv1_path = get_src_dir()
+    + "/tests/data/test-diff-suppr/libtest8-redundant-fn-v1.so";
+
+  corpus_sptr corp0, corp1;
+  read_corpus_from_elf(in_elfv0_path,
+		       /*debug_info_root_path=*/0,
+		       /*load_all_types=*/false,
+		       corp0);
+  read_corpus_from_elf(in_elfv1_path,
+		       /*debug_info_root_path=*/0,
+		       /*load_all_types=*/false,
+		       corp1);
+  if (!corp0 || !corp1)
+    {
+      cerr << "failed to read " << in_elfv0_path
+	   << " or " << in_elfv1_path << "\n";
+      return false;
+    }
+
+  bool is_ok = true;
+  diff_context_sptr ctxt;
+  corpus_diff_sptr d;
+  vector<diff*> nodes;
+
+  // Two distinct diff nodes about S sharing the same canonical diff
+  // node must get the same verdict, and that verdict must be
+  // re-computed when suppressions are added to the context after the
+  // first call to diff::is_suppressed().
+  collect_class_diff_nodes(corp0, corp1, "S", ctxt, d, nodes);
+  if (nodes.size() < 2
+      || nodes[0] == nodes[1]
+      || nodes[0]->get_canonical_diff() != nodes[1]->get_canonical_diff())
+    {
+      cerr << "expected two diff nodes about 'S' "
+	   << "sharing the same canonical diff node\n";
+      return false;
+    }
+  if (!check_suppressed(nodes, false, "no suppression"))
+    is_ok = false;
+  ctxt->add_suppression(make_type_suppression("", "T"));
+  if (!check_suppressed(nodes, false, "suppression of 'T'"))
+    is_ok = false;
+  ctxt->add_suppression(make_type_suppression("", "S"));
+  if (!check_suppressed(nodes, true,
+			"suppression of 'S' added after the first query"))
+    is_ok = false;
+  // Query the nodes in the reverse order too, so that the second one
+  // is not only answered from the verdict cached for the first one.
+  vector<diff*> reversed_nodes(nodes.rbegin(), nodes.rend());
+  if (!check_suppressed(reversed_nodes, true,
+			"suppression of 'S', in reverse order"))
+    is_ok = false;
+
+  // A name-indexed and a regex-only suppression specification apply
+  // to the same diff nodes.  Either of them can suppress them.
+  struct
+  {
+    const char* name;
+    const char* name_regex;
+    bool suppressed;
+  } mixed_specs[] =
+  {
+    {"S", "^T$", true},
+    {"T", "^S$", true},
+    {"S", "^S$", true},
+    {"T", "^U$", false},
+    {NULL, NULL, false}
+  };
+  for (int i = 0; mixed_specs[i].name; ++i)
+    {
+      collect_class_diff_nodes(corp0, corp1, "S", ctxt, d, nodes);
+      ctxt->add_suppression(make_type_suppression("", mixed_specs[i].name));
+      ctxt->add_suppression(make_type_suppression(mixed_specs[i].name_regex,
+						  ""));
+      string what = string("suppressions of name '") + mixed_specs[i].name
+	+ "' and of name regex '" + mixed_specs[i].name_regex + "'";
+      if (nodes.empty()
+	  || !check_suppressed(nodes, mixed_specs[i].suppressed, what))
+	is_ok = false;
+    }
+
+  return is_ok;
+}
+
 int
 main()
 {
@@ -423,5 +641,8 @@ main()
 	  is_ok = false;
       }
 
+    if (!check_suppressions_index())
+      is_ok = false;
+
     return !is_ok;
 }
@@ -25,7 +25,9 @@
 /// files.
 
 #include <string>
+#include <vector>
 #include <fstream>
+#include <sstream>
 #include <iostream>
 #include <cstdlib>
 #include "abg-ir.h"
@@ -35,6 +37,7 @@
 #include "test-utils.h"
 
 using std::string;
+using std::vector;
 using std::ofstream;
 using std::cerr;
 
@@ -95,18 +98,143 @@ InOutSpec in_out_specs[] =
     "data/test-read-dwarf/test8-qualified-this-pointer.so.abi",
     "output/test-read-dwarf/test8-qualified-this-pointer.so.abi"
   },
+  {
+    "data/test-read-dwarf/test9-static-archive.a",
+    "data/test-read-dwarf/test9-static-archive.a.abi",
+    "output/test-read-dwarf/test9-static-archive.a.abi"
+  },
   // This should be the last entry.
   {NULL, NULL, NULL}
 };
 
+/// Serialize a corpus read from an ELF file and compare the result
+/// against a reference XML corpus file.
+///
+/// @param corp the corpus to serialize.
+///
+/// @param in_elf_path the path to the ELF file @p corp was read
+/// from, relative to the tests directory.
+///
+/// @param in_abi_path the path to the reference XML corpus file,
+/// relative to the tests directory of the source tree.
+///
+/// @param out_abi_path the path to the XML corpus file to write,
+/// relative to the tests directory of the build tree.
+///
+/// @return true iff the serialized corpus is identical to the
+/// reference.
+static bool
+write_corpus_and_compare(const abigail::corpus_sptr&	corp,
+			 const string&			in_elf_path,
+			 const string&			in_abi_path,
+			 const string&			out_abi_path)
+{
+  corp->set_path(in_elf_path);
+  // Do not take architecture names in comparison so that these
+  // test input binaries can come from whatever arch the
+  // programmer likes.
+  corp->set_architecture_name("");
+
+  string out_path = abigail::tests::get_build_dir() + "/tests/" + out_abi_path;
+  if (!abigail::tools_utils::ensure_parent_dir_created(out_path))
+    {
+      cerr << "Could not create parent director for " << out_path;
+      return false;
+    }
+
+  ofstream of(out_path.c_str(), std::ios_base::trunc);
+  if (!of.is_open())
+    {
+      cerr << "failed to read " << out_path << "\n";
+      return false;
+    }
+
+  bool is_ok =
+    abigail::xml_writer::write_corpus_to_native_xml(corp,
+						    /*indent=*/0,
+						    of);
+  of.close();
+
+  string in_path = abigail::tests::get_src_dir() + "/tests/" + in_abi_path;
+  string cmd = "diff -u " + in_path + " " + out_path;
+  if (system(cmd.c_str()))
+    is_ok = false;
+
+  return is_ok;
+}
+
+/// Read the ELF files of in_out_specs with a read context set up
+/// with some options, and compare the resulting corpora against the
+/// reference XML corpus files.
+///
+/// Static archives are read member by member regardless of these
+/// options, so they are left out.
+///
+/// @param bounded_memory whether to release the data of each compile
+/// unit once it's read.
+///
+/// @param deduplicate_types whether to build the classes defined in
+/// several compile units only once.
+///
+/// @param suffix the suffix to add to the names of the XML corpus
+/// files written, before their extension.
+///
+/// @param corpora the corpora read so far.  The corpora read by this
+/// function are added to it.
+///
+/// @return true iff all the corpora are identical to the references.
+static bool
+read_with_options_and_compare(bool			bounded_memory,
+			      bool			deduplicate_types,
+			      const string&		suffix,
+			      vector<abigail::corpus_sptr>& corpora)
+{
+  bool is_ok = true;
+  for (InOutSpec* s = in_out_specs; s->in_elf_path; ++s)
+    {
+      string in_elf_path = s->in_elf_path;
+      if (in_elf_path.size() > 2
+	  && in_elf_path.compare(in_elf_path.size() - 2, 2, ".a") == 0)
+	continue;
+
+      in_elf_path = abigail::tests::get_src_dir() + "/tests/" + s->in_elf_path;
+      abigail::dwarf_reader::read_context_sptr ctxt =
+	abigail::dwarf_reader::create_read_context
+	(in_elf_path,
+	 /*debug_info_root_path=*/0,
+	 /*read_all_types=*/false);
+      abigail::dwarf_reader::set_bounded_memory(*ctxt, bounded_memory);
+      abigail::dwarf_reader::set_deduplicate_types(*ctxt, deduplicate_types);
+      abigail::corpus_sptr corp;
+      abigail::dwarf_reader::read_corpus_from_elf(*ctxt, corp);
+      if (!corp)
+	{
+	  cerr << "failed to read " << in_elf_path
+	       << " (" << suffix << ")\n";
+	  is_ok = false;
+	  continue;
+	}
+      corpora.push_back(corp);
+      string out_abi_path = s->out_abi_path;
+      out_abi_path.insert(out_abi_path.rfind(".abi"), suffix);
+      if (!write_corpus_and_compare(corp, s->in_elf_path,
+				    s->in_abi_path, out_abi_path))
+	is_ok = false;
+    }
+  return is_ok;
+}
+
 int
 main()
 {
-  unsigned result = 1;
-
   bool is_ok = true;
-  string in_elf_path, in_abi_path, out_abi_path;
+  string in_elf_path;
   abigail::corpus_sptr corp;
+  // The same binaries are read several times.  The types of the
+  // corpora read first stay in the canonical types map, and they
+  // refer to their scopes, so these corpora are kept alive until the
+  // end.
+  vector<abigail::corpus_sptr> corpora;
 
   for (InOutSpec* s = in_out_specs; s->in_elf_path; ++s)
     {
@@ -121,41 +249,98 @@ main()
 	  is_ok = false;
 	  continue;
 	}
-      corp->set_path(s->in_elf_path);
-      // Do not take architecture names in comparison so that these
-      // test input binaries can come from whatever arch the
-      // programmer likes.
-      corp->set_architecture_name("");
-
-      out_abi_path =
-	abigail::tests::get_build_dir() + "/tests/" + s->out_abi_path;
-      if (!abigail::tools_utils::ensure_parent_dir_created(out_abi_path))
-	{
-	  cerr << "Could not create parent director for " << out_abi_path;
-	  is_ok = false;
-	  return result;
-	}
+      corpora.push_back(corp);
+      if (!write_corpus_and_compare(corp, s->in_elf_path,
+				    s->in_abi_path, s->out_abi_path))
+	is_ok = false;
+    }
+
+  // In bounded memory mode, the DWARF reader releases the data of
+  // each compile unit once it's read.  The resulting corpus must be
+  // the same.
+  if (!read_with_options_and_compare(/*bounded_memory=*/true,
+				     /*deduplicate_types=*/false,
+				     "-bounded-memory", corpora))
+    is_ok = false;
+
+  // Deduplicating the classes defined in several compile units must
+  // not merge classes that differ.
+  if (!read_with_options_and_compare(/*bounded_memory=*/false,
+				     /*deduplicate_types=*/true,
+				     "-deduplicate-types", corpora))
+    is_ok = false;
 
-      ofstream of(out_abi_path.c_str(), std::ios_base::trunc);
-      if (!of.is_open())
+  // The members of a static archive are read concurrently, but the
+  // resulting corpus must not depend on the number of threads.
+  const char* archive_path = "data/test-read-dwarf/test9-static-archive.a";
+  unsigned num_threads[] = {1, 4};
+  for (unsigned i = 0; i < sizeof(num_threads) / sizeof(unsigned); ++i)
+    {
+      corp.reset();
+      in_elf_path = abigail::tests::get_src_dir() + "/tests/" + archive_path;
+      abigail::dwarf_reader::read_corpus_from_static_archive
+	(in_elf_path,
+	 /*debug_info_root_path=*/0,
+	 /*load_all_types=*/false,
+	 num_threads[i],
+	 corp);
+      if (!corp)
 	{
-	  cerr << "failed to read " << out_abi_path << "\n";
+	  cerr << "failed to read " << in_elf_path << "\n";
 	  is_ok = false;
 	  continue;
 	}
-
-      bool r =
-	abigail::xml_writer::write_corpus_to_native_xml(corp,
-							/*indent=*/0,
-							of);
-      is_ok = (is_ok && r);
-      of.close();
-
-      in_abi_path = abigail::tests::get_src_dir() + "/tests/" + s->in_abi_path;
-      string cmd = "diff -u " + in_abi_path + " " + out_abi_path;
-      if (system(cmd.c_str()))
+      corpora.push_back(corp);
+      std::ostringstream o;
+      o << "output/test-read-dwarf/test9-static-archive.a-"
+	<< num_threads[i] << "-threads.abi";
+      if (!write_corpus_and_compare(corp, archive_path,
+				    "data/test-read-dwarf/"
+				    "test9-static-archive.a.abi",
+				    o.str()))
 	is_ok = false;
     }
 
+  // The classes of test10-same-name-classes.so have the same name in
+  // its two compile units, but only the classes named "same" are
+  // identical.  These are the only ones deduplication may merge.  In
+  // test11-nested-class-members.so, the second compile unit defines a
+  // member function of a member class of a class that deduplication
+  // merges.
+  const char* deduplication_tests[] =
+    {
+      "test10-same-name-classes.so",
+      "test11-nested-class-members.so",
+      0
+    };
+  for (const char** t = deduplication_tests; *t; ++t)
+    for (int deduplicate_types = 0; deduplicate_types < 2; ++deduplicate_types)
+      {
+	string elf_path = string("data/test-read-dwarf/") + *t;
+	in_elf_path = abigail::tests::get_src_dir() + "/tests/" + elf_path;
+	abigail::dwarf_reader::read_context_sptr ctxt =
+	  abigail::dwarf_reader::create_read_context
+	  (in_elf_path,
+	   /*debug_info_root_path=*/0,
+	   /*read_all_types=*/false);
+	abigail::dwarf_reader::set_deduplicate_types(*ctxt,
+						     deduplicate_types);
+	corp.reset();
+	abigail::dwarf_reader::read_corpus_from_elf(*ctxt, corp);
+	if (!corp)
+	  {
+	    cerr << "failed to read " << in_elf_path << "\n";
+	    is_ok = false;
+	    continue;
+	  }
+	corpora.push_back(corp);
+	string abi_name =
+	  string(*t) + (deduplicate_types ? "-deduplicate-types" : "") + ".abi";
+	if (!write_corpus_and_compare(corp, elf_path,
+				      "data/test-read-dwarf/" + abi_name,
+				      "output/test-read-dwarf/" + abi_name))
+	  is_ok = false;
+      }
+
   return !is_ok;
 }
@@ -23,8 +23,10 @@
 /// file.  They should be identical.
 
 #include <string>
+#include <vector>
 #include <fstream>
 #include <iostream>
+#include <sstream>
 #include <cstdlib>
 #include "abg-ir.h"
 #include "abg-reader.h"
@@ -33,18 +35,23 @@
 #include "test-utils.h"
 
 using std::string;
+using std::vector;
+using std::ifstream;
 using std::ofstream;
+using std::ostream;
 using std::cerr;
 
 using abigail::tools_utils::file_type;
 using abigail::tools_utils::check_file;
 using abigail::tools_utils::guess_file_type;
+using abigail::tools_utils::file_comparing_streambuf;
 using abigail::translation_unit;
 using abigail::corpus_sptr;
 using abigail::xml_reader::read_translation_unit_from_file;
 using abigail::xml_reader::read_corpus_from_native_xml_file;
 using abigail::xml_writer::write_translation_unit;
 using abigail::xml_writer::write_corpus_to_native_xml;
+using abigail::xml_writer::write_corpus_to_native_xml_file;
 
 /// This is an aggregate that specifies where a test shall get its
 /// input from, and where it shall write its ouput to.
@@ -169,6 +176,189 @@ InOutSpec in_out_specs[] =
   {NULL, NULL}
 };
 
+/// Serialize a translation unit or a corpus into a stream that
+/// compares it against the content of a file.
+///
+/// @param t the type of the file the translation unit or the corpus
+/// was read from.
+///
+/// @param tu the translation unit to serialize, if @p t is
+/// FILE_TYPE_NATIVE_BI.
+///
+/// @param corpus the corpus to serialize, if @p t is
+/// FILE_TYPE_XML_CORPUS.
+///
+/// @param path the path to the file to compare against.
+///
+/// @param comparator the stream buffer that performs the comparison.
+/// Its file_comparing_streambuf::finish() method has been invoked
+/// when this function returns.
+///
+/// @return true iff the serialization is the same as the content of
+/// @p path.
+static bool
+serialize_and_compare(file_type t,
+		      translation_unit& tu,
+		      const corpus_sptr& corpus,
+		      file_comparing_streambuf& comparator)
+{
+  if (!comparator.is_open())
+    return false;
+  ostream out(&comparator);
+  if (t == abigail::tools_utils::FILE_TYPE_XML_CORPUS)
+    write_corpus_to_native_xml(corpus, /*indent=*/0, out);
+  else
+    write_translation_unit(tu, /*indent=*/0, out);
+  return comparator.finish();
+}
+
+/// Write lines into a file.
+///
+/// @param lines the lines to write, without their end of line.
+///
+/// @param path the path of the file to write.
+///
+/// @return true upon successful completion.
+static bool
+write_lines(const vector<string>& lines, const string& path)
+{
+  ofstream of(path.c_str(), std::ios_base::trunc);
+  for (vector<string>::const_iterator l = lines.begin();
+       l != lines.end();
+       ++l)
+    of << *l << "\n";
+  of.close();
+  return !of.fail();
+}
+
+/// Check that file_comparing_streambuf and "abilint --diff" report
+/// the first line that differs between an input file and what is
+/// saved back from it.
+///
+/// The input file is altered in a few ways -- a line is modified, a
+/// line is added at the end and the last line is removed -- and the
+/// altered files are compared against the serialization of what was
+/// read from the original file.  As abilint reads the file it
+/// compares against, it is only run on the altered files that are
+/// still well formed.
+///
+/// @return true iff all the differences were reported as expected.
+static bool
+test_differing_output()
+{
+  bool is_ok = true;
+  string in_path =
+    abigail::tests::get_src_dir() + "/tests/data/test-read-write/test10.xml";
+  translation_unit tu(in_path);
+  if (!read_translation_unit_from_file(tu))
+    {
+      cerr << "failed to read " << in_path << "\n";
+      return false;
+    }
+
+  vector<string> lines;
+  {
+    ifstream in(in_path.c_str());
+    string line;
+    while (std::getline(in, line))
+      lines.push_back(line);
+  }
+  if (lines.size() < 3)
+    return false;
+
+  struct alteration
+  {
+    const char* name;
+    size_t line;
+    string expected_line;
+    string actual_line;
+    bool is_well_formed;
+  } alterations[3];
+
+  vector<vector<string> > altered(3, lines);
+
+  // Modify the second line.
+  altered[0][1] += " ";
+  alterations[0].name = "modified-line";
+  alterations[0].line = 2;
+  alterations[0].expected_line = altered[0][1];
+  alterations[0].actual_line = lines[1];
+  alterations[0].is_well_formed = true;
+
+  // Add a line at the end.
+  altered[1].push_back("<!-- extra line -->");
+  alterations[1].name = "extra-line";
+  alterations[1].line = lines.size() + 1;
+  alterations[1].expected_line = altered[1].back();
+  alterations[1].actual_line = "";
+  alterations[1].is_well_formed = true;
+
+  // Remove the last line.
+  altered[2].pop_back();
+  alterations[2].name = "missing-line";
+  alterations[2].line = lines.size();
+  alterations[2].expected_line = "";
+  alterations[2].actual_line = lines.back();
+  alterations[2].is_well_formed = false;
+
+  string abilint = abigail::tests::get_build_dir() + "/tools/abilint";
+  string out_dir = abigail::tests::get_build_dir()
+    + "/tests/output/test-read-write/";
+  for (int i = 0; i < 3; ++i)
+    {
+      string path = out_dir + "test10-" + alterations[i].name + ".xml";
+      if (!abigail::tools_utils::ensure_parent_dir_created(path)
+	  || !write_lines(altered[i], path))
+	{
+	  cerr << "failed to write " << path << "\n";
+	  is_ok = false;
+	  continue;
+	}
+
+      file_comparing_streambuf comparator(path);
+      if (serialize_and_compare(abigail::tools_utils::FILE_TYPE_NATIVE_BI,
+				tu, corpus_sptr(), comparator)
+	  || comparator.get_line_of_first_difference() != alterations[i].line
+	  || comparator.get_expected_line() != alterations[i].expected_line
+	  || comparator.get_actual_line() != alterations[i].actual_line)
+	{
+	  cerr << "file_comparing_streambuf didn't report the right "
+	       << "difference with " << path << ": line "
+	       << comparator.get_line_of_first_difference() << "\n"
+	       << "-" << comparator.get_expected_line() << "\n"
+	       << "+" << comparator.get_actual_line() << "\n";
+	  is_ok = false;
+	}
+
+      if (!alterations[i].is_well_formed)
+	continue;
+
+      std::ostringstream expected_report;
+      expected_report << path << ":" << alterations[i].line
+		      << ": the input differs from what is saved back:\n"
+		      << "-" << alterations[i].expected_line << "\n"
+		      << "+" << alterations[i].actual_line << "\n";
+      string report_path = path + ".report.txt";
+      string expected_report_path = path + ".expected-report.txt";
+      {
+	ofstream of(expected_report_path.c_str(), std::ios_base::trunc);
+	of << expected_report.str();
+      }
+      string cmd = abilint + " --diff " + path + " 2> " + report_path;
+      if (!system(cmd.c_str()))
+	{
+	  cerr << "abilint --diff didn't report that " << path
+	       << " differs\n";
+	  is_ok = false;
+	}
+      cmd = "diff -u " + expected_report_path + " " + report_path;
+      if (system(cmd.c_str()))
+	is_ok = false;
+    }
+
+  return is_ok;
+}
+
 /// Walk the array of InOutSpecs above, read the input files it points
 /// to, write it into the output it points to and diff them.
 int
@@ -235,7 +425,56 @@ main()
       string cmd = "diff -u " + in_path + " " + out_path;
       if (system(cmd.c_str()))
 	is_ok = false;
+
+      // Comparing what is saved back against the input file on the
+      // fly must not find any difference either, be it in-process or
+      // with abilint --diff.
+      file_comparing_streambuf comparator(in_path);
+      if (!serialize_and_compare(t, tu, corpus, comparator))
+	{
+	  cerr << in_path << ":" << comparator.get_line_of_first_difference()
+	       << ": file_comparing_streambuf found a difference\n";
+	  is_ok = false;
+	}
+      string abilint_cmd =
+	abigail::tests::get_build_dir() + "/tools/abilint --diff " + in_path;
+      if (system(abilint_cmd.c_str()))
+	is_ok = false;
+
+      if (t == abigail::tools_utils::FILE_TYPE_XML_CORPUS)
+	{
+	  // Make the corpus go through a gzip compressed file too.
+	  string gz_path = out_path + ".gz";
+	  corpus_sptr c;
+	  if (!write_corpus_to_native_xml_file(corpus, /*indent=*/0, gz_path)
+	      || (guess_file_type(gz_path)
+		  != abigail::tools_utils::FILE_TYPE_XML_CORPUS)
+	      || !(c = read_corpus_from_native_xml_file(gz_path))
+	      || !write_corpus_to_native_xml_file(c, /*indent=*/0, out_path))
+	    {
+	      cerr << "failed to read back " << gz_path << "\n";
+	      is_ok = false;
+	    }
+	  else if (system(cmd.c_str()))
+	    is_ok = false;
+	  else
+	    {
+	      // The content of a compressed file is compared once
+	      // decompressed.
+	      file_comparing_streambuf gz_comparator(gz_path);
+	      if (!serialize_and_compare(t, tu, corpus, gz_comparator))
+		{
+		  cerr << gz_path << ":"
+		       << gz_comparator.get_line_of_first_difference()
+		       << ": file_comparing_streambuf found a difference\n";
+		  is_ok = false;
+		}
+	    }
+	}
     }
 
+  if (!test_differing_output())
+    is_ok = false;
+
   return !is_ok;
 }
@@ -21,12 +21,15 @@
 #include <cstdlib>
 #include <iostream>
 #include <fstream>
+#include <vector>
 #include "test-utils.h"
 #include "abg-ir.h"
 #include "abg-corpus.h"
 #include "abg-tools-utils.h"
 #include "abg-reader.h"
 #include "abg-writer.h"
+#include "abg-dwarf-reader.h"
+#include "abg-libzip-utils.h"
 
 struct InOutSpec
 {
@@ -75,15 +78,89 @@ const InOutSpec archive_spec =
   "output/test-write-read-archive/archive.abi"
 };
 
+/// The binary whose corpus is written to archives using one and
+/// several threads.  The DWARF reader deduplicates the classes of its
+/// translation units, so they share IR nodes.
+const char* multi_threaded_write_binary =
+  "data/test-write-read-archive/test5-shared-classes.so";
+
+/// The number of threads to use to write the corpus of @ref
+/// multi_threaded_write_binary concurrently.
+const unsigned multi_threaded_write_num_threads = 4;
+
 using std::string;
 using std::cerr;
 using std::ofstream;
+using std::vector;
+using std::pair;
+using std::make_pair;
 using std::tr1::shared_ptr;
 using abigail::corpus;
 using abigail::corpus_sptr;
 using abigail::translation_unit;
 using abigail::xml_reader::read_corpus_from_file;
 using abigail::xml_writer::write_corpus_to_archive;
+using abigail::zip_utils::zip_sptr;
+using abigail::zip_utils::zip_file_sptr;
+using abigail::zip_utils::open_archive;
+using abigail::zip_utils::open_file_in_archive;
+
+/// Write a corpus to an archive using a given number of threads,
+/// then read the members of the archive back.
+///
+/// @param corp the corpus to write.
+///
+/// @param path the path of the archive to write.
+///
+/// @param num_threads the number of threads to write the archive
+/// with.
+///
+/// @param members output parameter.  The names and the contents of
+/// the members of the archive, in the order of the archive.
+///
+/// @return true upon successful completion, false otherwise.
+static bool
+write_archive_and_read_members(const corpus&			corp,
+			       const string&			path,
+			       unsigned				num_threads,
+			       vector<pair<string, string> >&	members)
+{
+  if (!write_corpus_to_archive(corp, path, num_threads))
+    {
+      cerr << "failed to write archive file " << path
+	   << " with " << num_threads << " threads\n";
+      return false;
+    }
+
+  int error_code = 0;
+  zip_sptr archive = open_archive(path, 0, &error_code);
+  if (error_code || !archive)
+    {
+      cerr << "failed to open archive file " << path << "\n";
+      return false;
+    }
+
+  int num_members = zip_get_num_entries(archive.get(), 0);
+  for (int i = 0; i < num_members; ++i)
+    {
+      zip_file_sptr f = open_file_in_archive(archive, i);
+      if (!f)
+	{
+	  cerr << "failed to open member " << i << " of " << path << "\n";
+	  return false;
+	}
+
+      string content;
+      char buf[4096];
+      zip_int64_t n;
+      while ((n = zip_fread(f.get(), buf, sizeof(buf))) > 0)
+	content.append(buf, n);
+      members.push_back(make_pair(string(zip_get_name(archive.get(), i, 0)),
+				  content));
+    }
+
+  return true;
+}
 
 int
 main()
@@ -188,5 +265,41 @@ main()
 	is_ok = false;
     }
 
+  // Write the corpus of a binary with one thread and with several
+  // threads, and check that the two archives hold the same
+  // translation units.
+  in_path =
+    abigail::tests::get_src_dir() + "/tests/" + multi_threaded_write_binary;
+  abigail::dwarf_reader::read_context_sptr ctxt =
+    abigail::dwarf_reader::create_read_context(in_path,
+					       /*debug_info_root_path=*/0);
+  abigail::dwarf_reader::set_deduplicate_types(*ctxt, true);
+  corpus_sptr elf_corpus;
+  abigail::dwarf_reader::read_corpus_from_elf(*ctxt, elf_corpus);
+  if (!elf_corpus)
+    {
+      cerr << "failed to read " << in_path << "\n";
+      return 1;
+    }
+
+  vector<pair<string, string> > members, members_mt;
+  string archive_path = abigail::tests::get_build_dir()
+    + "/tests/output/test-write-read-archive/test5-shared-classes.abi";
+  string archive_mt_path = abigail::tests::get_build_dir()
+    + "/tests/output/test-write-read-archive/test5-shared-classes-mt.abi";
+  if (!write_archive_and_read_members(*elf_corpus, archive_path,
+				      /*num_threads=*/1, members)
+      || !write_archive_and_read_members(*elf_corpus, archive_mt_path,
+					 multi_threaded_write_num_threads,
+					 members_mt))
+    is_ok = false;
+  else if (members.size() != elf_corpus->get_translation_units().size()
+	   || members != members_mt)
+    {
+      cerr << archive_path << " and " << archive_mt_path
+	   << " have different members\n";
+      is_ok = false;
+    }
+
   return !is_ok;
 }
@@ -29,6 +29,7 @@
 #include "abg-reader.h"
 #include "abg-writer.h"
 #include "abg-tools-utils.h"
+#include "abg-workers.h"
 
 using std::cerr;
 using std::cout;
@@ -43,9 +44,11 @@ struct options
   string archive;
   list<string> in_files;
   string out_dir;
+  unsigned num_threads;
 
   options()
-    : list_content(false)
+    : list_content(false),
+      num_threads(abigail::workers::get_number_of_threads())
   {
   }
 
@@ -61,6 +64,8 @@ display_usage(const string &prog_name, ostream& out)
        << "--list|l <archive>			list the archive content\n"
        << "--add|-a <files-to-add> <archive>	add files to an archive\n"
        << "--extract|x [dest-dir] <archive>	extract archive content\n"
+       << "--jobs|-j <number>			number of threads used to read "
+    "or write the archive (defaults to the number of processors)\n"
   ;
 }
 
@@ -128,6 +133,16 @@ parse_args(int argc, char* argv[], options& opts)
 	  if (opts.in_files.empty())
 	    return false;
 	}
+      else if (! strcmp(arg, "--jobs")
+	       || ! strcmp(arg, "-j"))
+	{
+	  int arg_index = i + 1;
+	  if (arg_index >= argc
+	      || atoi(argv[arg_index]) < 1)
+	    return false;
+	  opts.num_threads = atoi(argv[arg_index]);
+	  ++i;
+	}
       else if (! strcmp(arg, "--extract")
 			|| ! strcmp(arg, "-x"))
 	{
@@ -165,9 +180,12 @@ using abigail::xml_writer::write_corpus_to_archive;
 /// @param archive_path a path to the file containing the archive file
 /// to list the content of.
 ///
+/// @param num_threads the number of threads to use to read the
+/// archive.
+///
 /// @return true upon successful completion, false otherwise.
 static bool
-list_content(const string& archive_path)
+list_content(const string& archive_path, unsigned num_threads)
 {
   if (archive_path.empty())
     {
@@ -175,7 +193,7 @@ list_content(const string& archive_path)
       return false;
     }
 
-  corpus_sptr archive = read_corpus_from_file(archive_path);
+  corpus_sptr archive = read_corpus_from_file(archive_path, num_threads);
   if (!archive)
     {
       cerr << "Could not read archive at '" << archive_path << "'\n";
@@ -201,10 +219,14 @@ list_content(const string& archive_path)
 /// archive.  Note that this function creates the entire directory
 /// tree needed up to \a archive_path, if needed.
 ///
+/// @param num_threads the number of threads to use to write the
+/// archive.
+///
 /// @return true upon successful completion, false otherwise.
 static bool
 add_tus_to_archive(const list<string>& tu_paths,
-		   const string& archive_path)
+		   const string& archive_path,
+		   unsigned num_threads)
 {
   translation_units tus;
   corpus corp(archive_path);
@@ -229,7 +251,7 @@ add_tus_to_archive(const list<string>& tu_paths,
 
   if (added_some_tus)
     {
-      if (!write_corpus_to_archive(corp))
+      if (!write_corpus_to_archive(corp, corp.get_path(), num_threads))
 	{
 	  cerr << "could not write archive file '"
 	       << corp.get_path()
@@ -249,10 +271,14 @@ add_tus_to_archive(const list<string>& tu_paths,
 /// @param archive_path the path to the archive to extract.  The
 /// archive must exist and be accessible with read privileges.
 ///
+/// @param num_threads the number of threads to use to read the
+/// archive.
+///
 /// @return true upon successful completion, false otherwise.
 static bool
 extract_tus_from_archive(const string& dest_path,
-			 const string& archive_path)
+			 const string& archive_path,
+			 unsigned num_threads)
 {
   if (dest_path.empty())
     {
@@ -262,7 +288,7 @@ extract_tus_from_archive(const string& dest_path,
 
   corpus_sptr archive(new corpus(archive_path));
 
-  if (read_corpus_from_file(archive) < 1)
+  if (read_corpus_from_file(archive, archive_path, num_threads) < 1)
     {
       cerr << "could not read archive at '"
 	   << archive_path
@@ -319,11 +345,13 @@ main(int argc, char* argv[])
     }
 
   if (opts.list_content)
-    return !list_content(opts.archive);
+    return !list_content(opts.archive, opts.num_threads);
   else if (!opts.in_files.empty())
-    return !add_tus_to_archive(opts.in_files, opts.archive);
+    return !add_tus_to_archive(opts.in_files, opts.archive,
+			       opts.num_threads);
   else if (!opts.extract_dest.empty())
-    return !extract_tus_from_archive(opts.extract_dest, opts.archive);
+    return !extract_tus_from_archive(opts.extract_dest, opts.archive,
+				     opts.num_threads);
   else
     {
       display_usage(argv[0], cout);
@@ -77,13 +77,15 @@ struct options
   bool			list_undefined_symbols_only;
   bool			show_base_names;
   bool			show_redundant;
+  bool			json;
 
   options()
     :display_help(),
      weak_mode(),
      list_undefined_symbols_only(),
      show_base_names(),
-     show_redundant(true)
+     show_redundant(true),
+     json()
   {}
 }; // end struct options
 
@@ -109,7 +111,8 @@ display_usage(const string& prog_name, ostream& out)
       << "--no-redundant  do not display redundant changes\n"
       << "--redundant  display redundant changes (this is the default)\n"
       << "--weak-mode  check compatibility between the application and "
-         "just one version of the library."
+         "just one version of the library.\n"
+      << "--json  emit the report in the JSON format\n"
     ;
 }
 
@@ -191,6 +194,8 @@ parse_command_line(int argc, char* argv[], options& opts)
 	}
       else if (!strcmp(argv[i], "--weak-mode"))
 	opts.weak_mode = true;
+      else if (!strcmp(argv[i], "--json"))
+	opts.json = true;
       else
 	{
 	  opts.unknow_option = argv[i];
@@ -233,6 +238,8 @@ using abigail::comparison::compute_diff;
 using abigail::comparison::suppression_sptr;
 using abigail::comparison::suppressions_type;
 using abigail::comparison::read_suppressions;
+using abigail::comparison::report_as_json;
+using abigail::tools_utils::emit_json_string;
 
 /// Perform a compatibility check of an application corpus linked
 /// against a first version of library corpus, with a second version
@@ -326,6 +333,17 @@ perform_compat_check_in_normal_mode(options& opts,
   const corpus_diff::diff_stats& s =
     changes->apply_filters_and_suppressions_before_reporting();
 
+  string app_path = opts.app_path,
+    lib1_path = opts.lib1_path,
+    lib2_path = opts.lib2_path;
+
+  if (opts.show_base_names)
+    {
+      base_name(opts.app_path, app_path);
+      base_name(opts.lib1_path, lib1_path);
+      base_name(opts.lib2_path, lib2_path);
+    }
+
   if (changes->soname_changed()
       || s.num_func_removed() != 0
       || s.num_vars_removed() != 0
@@ -334,17 +352,6 @@ perform_compat_check_in_normal_mode(options& opts,
       || s.net_num_func_changed() != 0
       || s.net_num_vars_changed() != 0)
     {
-      string app_path = opts.app_path,
-	lib1_path = opts.lib1_path,
-	lib2_path = opts.lib2_path;
-
-      if (opts.show_base_names)
-	{
-	  base_name(opts.app_path, app_path);
-	  base_name(opts.lib1_path, lib1_path);
-	  base_name(opts.lib2_path, lib2_path);
-	}
-
       status |= abigail::tools_utils::ABIDIFF_ABI_CHANGE;
 
       bool abi_broke_for_sure = changes->soname_changed()
@@ -353,19 +360,42 @@ perform_compat_check_in_normal_mode(options& opts,
 	|| s.num_var_syms_removed()
 	|| s.num_func_syms_removed();
 
-      cout << "ELF file '" << app_path << "'";
       if (abi_broke_for_sure)
+	status |= abigail::tools_utils::ABIDIFF_ABI_INCOMPATIBLE_CHANGE;
+
+      if (!opts.json)
 	{
-	  cout << " is not ";
-	  status |= abigail::tools_utils::ABIDIFF_ABI_INCOMPATIBLE_CHANGE;
+	  cout << "ELF file '" << app_path << "'";
+	  if (abi_broke_for_sure)
+	    cout << " is not ";
+	  else
+	    cout << " might not be ";
+
+	  cout << "ABI compatible with '" << lib2_path
+	       << "' due to differences with '" << lib1_path
+	       << "' below:\n";
+	  changes->report(cout);
 	}
-      else
-	  cout << " might not be ";
+    }
 
-      cout << "ABI compatible with '" << lib2_path
-	   << "' due to differences with '" << lib1_path
-	   << "' below:\n";
-      changes->report(cout);
+  if (opts.json)
+    {
+      cout << "{\"application\": ";
+      emit_json_string(app_path, cout);
+      cout << ",\n\"first-library\": ";
+      emit_json_string(lib1_path, cout);
+      cout << ",\n\"second-library\": ";
+      emit_json_string(lib2_path, cout);
+      cout << ",\n\"abi-compatible\": ";
+      if (status & abigail::tools_utils::ABIDIFF_ABI_INCOMPATIBLE_CHANGE)
+	cout << "\"no\"";
+      else if (status & abigail::tools_utils::ABIDIFF_ABI_CHANGE)
+	cout << "\"maybe\"";
+      else
+	cout << "\"yes\"";
+      cout << ",\n\"changes\": ";
+      report_as_json(changes, cout);
+      cout << "}\n";
     }
 
   return status;
@@ -409,6 +439,43 @@ struct var_change
   {}
 }; // end struct var_change
 
+/// Emit the named JSON array of the functions or variables which
+/// types are different from what the application expects, in the
+/// weak mode.
+///
+/// @param name the name of the array.
+///
+/// @param changes the changes to emit.  This is a vector of either
+/// @ref fn_change or @ref var_change.
+///
+/// @param out the output stream to emit the array to.
+template<typename change_type>
+static void
+emit_json_changes(const char* name,
+		  const vector<change_type>& changes,
+		  ostream& out)
+{
+  out << ",\n\"" << name << "\": [";
+  for (typename vector<change_type>::const_iterator i = changes.begin();
+       i != changes.end();
+       ++i)
+    {
+      if (i != changes.begin())
+	out << ",";
+      out << "\n  {\"name\": ";
+      emit_json_string(i->decl->get_pretty_representation(), out);
+      out << ", \"symbol\": ";
+      if (i->decl->get_symbol())
+	emit_json_string(i->decl->get_symbol()->get_id_string(), out);
+      else
+	out << "null";
+      out << ", \"type-changes\": ";
+      report_as_json(diff_sptr(i->diff), out);
+      out << "}";
+    }
+  out << "]";
+}
+
 /// Perform a compatibility check of an application corpus and a
 /// library corpus.
 ///
@@ -504,7 +571,15 @@ perform_compat_check_in_weak_mode(options& opts,
 	base_name(opts.app_path, app_path);
       }
 
-    if (!fn_changes.empty())
+    if (opts.json)
+      {
+	cout << "{\"application\": ";
+	emit_json_string(app_path, cout);
+	cout << ",\n\"library\": ";
+	emit_json_string(lib1_path, cout);
+	emit_json_changes("changed-functions", fn_changes, cout);
+      }
+    else if (!fn_changes.empty())
       {
 	cout << "functions defined in library\n    "
 	     << "'" << lib1_path << "'\n"
@@ -541,7 +616,12 @@ perform_compat_check_in_weak_mode(options& opts,
 	if (type_diff && type_diff->to_be_reported())
 	  var_changes.push_back(var_change(*i, type_diff));
       }
-    if (!var_changes.empty())
+    if (opts.json)
+      {
+	emit_json_changes("changed-variables", var_changes, cout);
+	cout << "}\n";
+      }
+    else if (!var_changes.empty())
       {
 	cout << "variables defined in library\n    "
 	     << "'" << lib1_path << "'\n"
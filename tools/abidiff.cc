@@ -43,7 +43,10 @@ using abigail::corpus_sptr;
 using abigail::comparison::translation_unit_diff_sptr;
 using abigail::comparison::corpus_diff;
 using abigail::comparison::corpus_diff_sptr;
+using abigail::comparison::diff_sptr;
+using abigail::comparison::report_as_json;
 using abigail::comparison::compute_diff;
+using abigail::comparison::compute_corpus_change_kind;
 using abigail::comparison::suppression_sptr;
 using abigail::comparison::suppressions_type;
 using abigail::comparison::read_suppressions;
@@ -64,6 +67,8 @@ struct options
   vector<string>	keep_fn_regex_patterns;
   vector<string>	keep_var_regex_patterns;
   bool			show_stats_only;
+  bool			quick;
+  bool			json;
   bool			show_symtabs;
   bool			show_deleted_fns;
   bool			show_changed_fns;
@@ -86,6 +91,8 @@ struct options
     : display_usage(false),
       missing_operand(false),
       show_stats_only(false),
+      quick(false),
+      json(false),
       show_symtabs(false),
       show_deleted_fns(false),
       show_changed_fns(false),
@@ -112,6 +119,9 @@ display_usage(const string& prog_name, ostream& out)
       << " --debug-info-dir1 <path> the root for the debug info of bi-file1\n"
       << " --debug-info-dir2 <path> the root for the debug info of bi-file2\n"
       << " --stat  only display the diff stats\n"
+      << " --quick  display nothing and only set the exit status, "
+         "stopping at the first incompatible change\n"
+      << " --json  emit the report in the JSON format\n"
       << " --symtabs  only display the symbol tables of the corpora\n"
       << " --deleted-fns  display deleted public functions\n"
       << " --changed-fns  display changed public functions\n"
@@ -199,6 +209,10 @@ parse_command_line(int argc, char* argv[], options& opts)
 	}
       else if (!strcmp(argv[i], "--stat"))
 	opts.show_stats_only = true;
+      else if (!strcmp(argv[i], "--quick"))
+	opts.quick = true;
+      else if (!strcmp(argv[i], "--json"))
+	opts.json = true;
       else if (!strcmp(argv[i], "--symtabs"))
 	opts.show_symtabs = true;
       else if (!strcmp(argv[i], "--help"))
@@ -638,9 +652,17 @@ main(int argc, char* argv[])
 
       if (t1)
 	{
-	  translation_unit_diff_sptr diff = compute_diff(t1, t2);
-	  if (diff->has_changes())
-	    diff->report(cout);
+	  if (!opts.quick)
+	    {
+	      translation_unit_diff_sptr diff = compute_diff(t1, t2);
+	      if (opts.json)
+		{
+		  report_as_json(diff_sptr(diff), cout);
+		  cout << "\n";
+		}
+	      else if (diff->has_changes())
+		diff->report(cout);
+	    }
 	}
       else if (c1)
 	{
@@ -655,6 +677,27 @@ main(int argc, char* argv[])
 
 	  diff_context_sptr ctxt(new diff_context);
 	  set_diff_context_from_opts(ctxt, opts);
+
+	  if (opts.quick)
+	    {
+	      // Only the exit status is wanted, so do not build the
+	      // whole diff tree.
+	      switch (compute_corpus_change_kind(c1, c2, ctxt))
+		{
+		case abigail::comparison::NO_CORPUS_CHANGE_KIND:
+		  break;
+		case abigail::comparison::COMPATIBLE_CORPUS_CHANGE_KIND:
+		  status = abigail::tools_utils::ABIDIFF_ABI_CHANGE;
+		  break;
+		case abigail::comparison::INCOMPATIBLE_CORPUS_CHANGE_KIND:
+		  status =
+		    (abigail::tools_utils::ABIDIFF_ABI_INCOMPATIBLE_CHANGE
+		     | abigail::tools_utils::ABIDIFF_ABI_CHANGE);
+		  break;
+		}
+	      return status;
+	    }
+
 	  corpus_diff_sptr diff = compute_diff(c1, c2, ctxt);
 	  const corpus_diff::diff_stats& stats =
 	    diff->apply_filters_and_suppressions_before_reporting();
@@ -669,7 +712,14 @@ main(int argc, char* argv[])
 		   || stats.net_num_vars_changed() != 0)
 	    status = abigail::tools_utils::ABIDIFF_ABI_CHANGE;
 
-	  if (diff->has_changes() > 0)
+	  if (opts.json)
+	    {
+	      // Consumers of the JSON report always get a document,
+	      // even when there is no change.
+	      report_as_json(diff, cout);
+	      cout << "\n";
+	    }
+	  else if (diff->has_changes() > 0)
 	    diff->report(cout);
 	}
       else
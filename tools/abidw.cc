@@ -56,12 +56,22 @@ struct options
   bool			show_base_name_alt_debug_info_path;
   bool			write_architecture;
   bool			load_all_types;
+  bool			prune_unreachable_types;
+  bool			build_debug_info_index;
+  bool			bounded_memory;
+  bool			deduplicate_types;
+  bool			show_stats;
 
   options()
     : check_alt_debug_info_path(),
       show_base_name_alt_debug_info_path(),
       write_architecture(true),
-      load_all_types()
+      load_all_types(),
+      prune_unreachable_types(),
+      build_debug_info_index(),
+      bounded_memory(),
+      deduplicate_types(),
+      show_stats()
   {}
 };
 
@@ -80,6 +90,16 @@ display_usage(const string& prog_name, ostream& out)
     "debug info of <elf-path>, and show its base name\n"
       << "  --load-all-types read all types including those not reachable from"
          "exported declarations\n"
+      << "  --prune-unreachable-types do not emit the types that are not "
+         "reachable from exported declarations\n"
+      << "  --build-debug-info-index index the debug info files found "
+         "under the directory given by --debug-info-dir\n"
+      << "  --bounded-memory release the data of each compilation unit "
+         "once it is read\n"
+      << "  --deduplicate-types build the classes that are defined "
+         "in several compilation units only once\n"
+      << "  --stats show statistics about the reading of the debug info "
+         "on the error output\n"
     ;
 }
 
@@ -137,12 +157,25 @@ parse_command_line(int argc, char* argv[], options& opts)
 	}
       else if (!strcmp(argv[i], "--load-all-types"))
 	opts.load_all_types = true;
+      else if (!strcmp(argv[i], "--prune-unreachable-types"))
+	opts.prune_unreachable_types = true;
+      else if (!strcmp(argv[i], "--build-debug-info-index"))
+	opts.build_debug_info_index = true;
+      else if (!strcmp(argv[i], "--bounded-memory"))
+	opts.bounded_memory = true;
+      else if (!strcmp(argv[i], "--deduplicate-types"))
+	opts.deduplicate_types = true;
+      else if (!strcmp(argv[i], "--stats"))
+	opts.show_stats = true;
       else if (!strcmp(argv[i], "--help"))
 	return false;
       else
 	return false;
     }
 
+  if (opts.build_debug_info_index && !opts.di_root_path)
+    return false;
+
   return true;
 }
 
@@ -157,6 +190,22 @@ main(int argc, char* argv[])
       return 1;
     }
 
+  if (opts.build_debug_info_index)
+    {
+      size_t num_files = 0;
+      if (!abigail::dwarf_reader::build_debug_info_index
+	  (opts.di_root_path.get(), num_files))
+	{
+	  cerr << "could not write the debug info index of '"
+	       << opts.di_root_path.get() << "'\n";
+	  return 1;
+	}
+      cerr << "indexed " << num_files << " ELF files under '"
+	   << opts.di_root_path.get() << "'\n";
+      if (opts.in_file_path.empty())
+	return 0;
+    }
+
   assert(!opts.in_file_path.empty());
   if (!abigail::tools_utils::check_file(opts.in_file_path, cerr))
     return 1;
@@ -184,6 +233,8 @@ main(int argc, char* argv[])
   read_context_sptr c = create_read_context(opts.in_file_path, &p,
 					    opts.load_all_types);
   read_context& ctxt = *c;
+  abigail::dwarf_reader::set_bounded_memory(ctxt, opts.bounded_memory);
+  abigail::dwarf_reader::set_deduplicate_types(ctxt, opts.deduplicate_types);
 
   if (opts.check_alt_debug_info_path)
     {
@@ -214,7 +265,11 @@ main(int argc, char* argv[])
 	}
     }
 
-  dwarf_reader::status s = read_corpus_from_elf(ctxt, corp);
+  dwarf_reader::status s =
+    type == abigail::tools_utils::FILE_TYPE_AR
+    // The object files of a static archive are read concurrently.
+    ? read_corpus_from_elf(opts.in_file_path, &p, opts.load_all_types, corp)
+    : read_corpus_from_elf(ctxt, corp);
   if (!corp)
     {
       if (s == dwarf_reader::STATUS_DEBUG_INFO_NOT_FOUND)
@@ -245,9 +300,22 @@ main(int argc, char* argv[])
     }
   else
     {
+      if (opts.show_stats)
+	cerr << "translation units: "
+	     << corp->get_translation_units().size() << "\n"
+	     << "functions: " << corp->get_functions().size() << "\n"
+	     << "variables: " << corp->get_variables().size() << "\n"
+	     << "peak resident set size: "
+	     << tools_utils::get_peak_resident_set_size() << " KB\n";
       if (!opts.write_architecture)
 	corp->set_architecture_name("");
-      abigail::xml_writer::write_corpus_to_native_xml(corp, 0, cout);
+      if (opts.prune_unreachable_types)
+	corp->prune_unreachable_types();
+      if (opts.out_file_path.empty())
+	abigail::xml_writer::write_corpus_to_native_xml(corp, 0, cout);
+      else if (!abigail::xml_writer::write_corpus_to_native_xml_file
+	       (corp, 0, opts.out_file_path))
+	return 1;
     }
 
   return 0;
@@ -0,0 +1,731 @@
+// -*- Mode: C++ -*-
+//
+// Copyright (C) 2013-2015 Red Hat, Inc.
+//
+// This file is part of the GNU Application Binary Interface Generic
+// Analysis and Instrumentation Library (libabigail).  This library is
+// free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option) any
+// later version.
+
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this program; see the file COPYING-LGPLV3.  If
+// not, see <http://www.gnu.org/licenses/>.
+
+/// @file
+///
+/// This program builds a synthetic ABI corpus of a configurable shape
+/// using the libabigail IR API, and serializes it in the native XML
+/// format.
+///
+/// The shape of the corpus is controlled by the number of translation
+/// units, the number of classes per translation unit, the number of
+/// data members per class, the depth of the inheritance chains, the
+/// depth of the template instantiations and the number of functions
+/// per translation unit.  A set of classes is repeated identically in
+/// every translation unit, the way types of system headers are.
+///
+/// The --version option selects between a baseline corpus (0) and a
+/// mutated one (1).  In the mutated corpus, each class and function
+/// has a chance (given by --mutation-rate) to be changed, added or
+/// removed.  The generated corpora are deterministic for a given
+/// command line, so two invocations that only differ by --version
+/// yield two corpora that can be compared with abidiff.
+///
+/// This lets the reader and the comparison engine be benchmarked and
+/// stress-tested at realistic sizes without shipping huge binaries.
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <sstream>
+#include "abg-ir.h"
+#include "abg-corpus.h"
+#include "abg-writer.h"
+
+using std::string;
+using std::vector;
+using std::ostream;
+using std::ostringstream;
+using std::cout;
+using std::cerr;
+using abigail::ir::corpus;
+using abigail::ir::corpus_sptr;
+using abigail::ir::translation_unit;
+using abigail::ir::translation_unit_sptr;
+using abigail::ir::location;
+using abigail::ir::location_manager;
+using abigail::ir::decl_base;
+using abigail::ir::scope_decl;
+using abigail::ir::namespace_decl;
+using abigail::ir::namespace_decl_sptr;
+using abigail::ir::type_base_sptr;
+using abigail::ir::type_decl;
+using abigail::ir::type_decl_sptr;
+using abigail::ir::pointer_type_def;
+using abigail::ir::pointer_type_def_sptr;
+using abigail::ir::class_decl;
+using abigail::ir::class_decl_sptr;
+using abigail::ir::var_decl;
+using abigail::ir::var_decl_sptr;
+using abigail::ir::function_decl;
+using abigail::ir::function_decl_sptr;
+using abigail::ir::function_type;
+using abigail::ir::function_type_sptr;
+using abigail::ir::method_type;
+using abigail::ir::method_type_sptr;
+using abigail::ir::elf_symbol;
+using abigail::ir::elf_symbol_sptr;
+using abigail::ir::elf_symbols;
+using abigail::ir::string_elf_symbols_map_type;
+using abigail::ir::string_elf_symbols_map_sptr;
+using abigail::ir::add_decl_to_scope;
+using abigail::ir::public_access;
+
+struct options
+{
+  bool		display_usage;
+  string	out_file_path;
+  unsigned	num_tus;
+  unsigned	num_classes;
+  unsigned	num_shared_classes;
+  unsigned	num_members;
+  unsigned	num_methods;
+  unsigned	inheritance_depth;
+  unsigned	template_depth;
+  unsigned	num_functions;
+  unsigned	num_variables;
+  unsigned	version;
+  unsigned	seed;
+  double	mutation_rate;
+
+  options()
+    : display_usage(false),
+      num_tus(100),
+      num_classes(100),
+      num_shared_classes(20),
+      num_members(8),
+      num_methods(2),
+      inheritance_depth(4),
+      template_depth(3),
+      num_functions(100),
+      num_variables(10),
+      version(0),
+      seed(0),
+      mutation_rate(1)
+  {}
+};
+
+static void
+display_usage(const string& prog_name, ostream& out)
+{
+  out << "usage: " << prog_name << " [options]\n"
+      << " where options can be:\n"
+      << "  --help display this message\n"
+      << "  --out-file <path> write the corpus to 'path' instead of "
+    "the standard output\n"
+      << "  --tus <N> number of translation units (default 100)\n"
+      << "  --classes <N> number of classes per translation unit "
+    "(default 100)\n"
+      << "  --shared-classes <N> number of classes repeated in all "
+    "translation units (default 20)\n"
+      << "  --members <N> number of data members per class (default 8)\n"
+      << "  --methods <N> number of member functions per class "
+    "(default 2)\n"
+      << "  --inheritance-depth <N> length of the inheritance chains "
+    "(default 4)\n"
+      << "  --template-depth <N> nesting depth of template "
+    "instantiations (default 3)\n"
+      << "  --functions <N> number of functions per translation unit "
+    "(default 100)\n"
+      << "  --variables <N> number of variables per translation unit "
+    "(default 10)\n"
+      << "  --version <0|1> build the baseline or the mutated corpus "
+    "(default 0)\n"
+      << "  --mutation-rate <P> percentage of artifacts changed in "
+    "the mutated corpus (default 1)\n"
+      << "  --seed <N> seed of the mutations (default 0)\n";
+}
+
+/// Parse an unsigned integer command line argument.
+///
+/// @param str the string to parse.
+///
+/// @param result the resulting integer.
+///
+/// @return true upon successful completion.
+static bool
+parse_unsigned(const char* str, unsigned& result)
+{
+  char* end = 0;
+  unsigned long v = strtoul(str, &end, 10);
+  if (!end || *end)
+    return false;
+  result = v;
+  return true;
+}
+
+static bool
+parse_command_line(int argc, char* argv[], options& opts)
+{
+  for (int i = 1; i < argc; ++i)
+    {
+      unsigned* dest = 0;
+      if (!strcmp(argv[i], "--help"))
+	{
+	  opts.display_usage = true;
+	  return true;
+	}
+      else if (!strcmp(argv[i], "--out-file"))
+	{
+	  if (argc <= i + 1)
+	    return false;
+	  opts.out_file_path = argv[++i];
+	  continue;
+	}
+      else if (!strcmp(argv[i], "--mutation-rate"))
+	{
+	  if (argc <= i + 1)
+	    return false;
+	  char* end = 0;
+	  opts.mutation_rate = strtod(argv[i + 1], &end);
+	  if (!end || *end
+	      || opts.mutation_rate < 0
+	      || opts.mutation_rate > 100)
+	    return false;
+	  ++i;
+	  continue;
+	}
+      else if (!strcmp(argv[i], "--tus"))
+	dest = &opts.num_tus;
+      else if (!strcmp(argv[i], "--classes"))
+	dest = &opts.num_classes;
+      else if (!strcmp(argv[i], "--shared-classes"))
+	dest = &opts.num_shared_classes;
+      else if (!strcmp(argv[i], "--members"))
+	dest = &opts.num_members;
+      else if (!strcmp(argv[i], "--methods"))
+	dest = &opts.num_methods;
+      else if (!strcmp(argv[i], "--inheritance-depth"))
+	dest = &opts.inheritance_depth;
+      else if (!strcmp(argv[i], "--template-depth"))
+	dest = &opts.template_depth;
+      else if (!strcmp(argv[i], "--functions"))
+	dest = &opts.num_functions;
+      else if (!strcmp(argv[i], "--variables"))
+	dest = &opts.num_variables;
+      else if (!strcmp(argv[i], "--version"))
+	dest = &opts.version;
+      else if (!strcmp(argv[i], "--seed"))
+	dest = &opts.seed;
+      else
+	return false;
+
+      if (argc <= i + 1 || !parse_unsigned(argv[i + 1], *dest))
+	return false;
+      ++i;
+    }
+
+  return opts.version < 2;
+}
+
+/// The kinds of mutations that can be applied to the artifacts of
+/// the corpus.
+enum mutation_kind
+{
+  MUTATION_ADD_MEMBER,
+  MUTATION_CHANGE_MEMBER_TYPE,
+  MUTATION_ADD_VIRTUAL,
+  MUTATION_REMOVE_FUNCTION,
+  MUTATION_ADD_FUNCTION,
+  MUTATION_CHANGE_PARM_TYPE,
+  MUTATION_REMOVE_VARIABLE
+};
+
+/// Deterministically mix a few integers into a pseudo-random one.
+///
+/// This doesn't use rand() so that the generated corpora are the
+/// same on all platforms.
+static unsigned
+mix(unsigned seed, unsigned a, unsigned b, unsigned c)
+{
+  unsigned x = seed ^ (a * 0x9E3779B1u) ^ (b * 0x85EBCA77u) ^ (c * 0xC2B2AE3Du);
+  x ^= x >> 15;
+  x *= 0x2C1B3C6Du;
+  x ^= x >> 12;
+  x *= 0x297A2D39u;
+  x ^= x >> 15;
+  return x;
+}
+
+/// The state of the construction of the corpus.
+class corpus_builder
+{
+  const options&		opts_;
+  corpus_sptr			corpus_;
+  string_elf_symbols_map_sptr	fn_syms_;
+  string_elf_symbols_map_sptr	var_syms_;
+  translation_unit_sptr		tu_;
+  unsigned			tu_index_;
+  namespace_decl_sptr		ns_;
+  type_decl_sptr		int_type_;
+  type_decl_sptr		long_type_;
+  type_decl_sptr		char_type_;
+  type_decl_sptr		double_type_;
+  vector<class_decl_sptr>	classes_;
+  vector<type_base_sptr>	class_ptrs_;
+  unsigned			num_classes_;
+  unsigned long			num_types_;
+  unsigned long			num_decls_;
+  unsigned			line_;
+
+public:
+
+  corpus_builder(const options& opts)
+    : opts_(opts),
+      corpus_(new corpus("synthetic-corpus")),
+      fn_syms_(new string_elf_symbols_map_type),
+      var_syms_(new string_elf_symbols_map_type),
+      tu_index_(),
+      num_classes_(),
+      num_types_(),
+      num_decls_(),
+      line_()
+  {}
+
+  /// Tests if a given artifact is mutated in the corpus being built.
+  ///
+  /// @param k the kind of mutation to consider.
+  ///
+  /// @param index the index of the artifact in the current
+  /// translation unit.
+  ///
+  /// @return true iff the artifact undergoes the mutation @p k.
+  bool
+  is_mutated(mutation_kind k, unsigned index) const
+  {
+    if (opts_.version == 0 || opts_.mutation_rate <= 0)
+      return false;
+    unsigned r = mix(opts_.seed, k, tu_index_, index) % 10000;
+    return r < opts_.mutation_rate * 100;
+  }
+
+  /// Create a new location in the current translation unit.
+  ///
+  /// @param shared if true, the location is in a header file that is
+  /// shared by all the translation units.
+  location
+  new_location(bool shared)
+  {
+    ostringstream path;
+    if (shared)
+      path << "/usr/include/synthetic/common.h";
+    else
+      path << "/usr/src/synthetic/include/header" << tu_index_ << ".h";
+    return tu_->get_loc_mgr().create_new_location(path.str(), ++line_, 1);
+  }
+
+  /// Build a basic type and add it to the global scope of the current
+  /// translation unit.
+  type_decl_sptr
+  build_basic_type(const string& name, size_t size)
+  {
+    type_decl_sptr t(new type_decl(name, size, size, location()));
+    add_decl_to_scope(t, tu_->get_global_scope().get());
+    ++num_types_;
+    return t;
+  }
+
+  /// Build a pointer to a given type and add it to the global scope
+  /// of the current translation unit.
+  type_base_sptr
+  build_pointer_type(type_base_sptr pointed_to)
+  {
+    pointer_type_def_sptr t(new pointer_type_def(pointed_to, 64, 64,
+						 location()));
+    add_decl_to_scope(t, tu_->get_global_scope().get());
+    ++num_types_;
+    return t;
+  }
+
+  /// Build a class type.
+  ///
+  /// @param name the name of the class.
+  ///
+  /// @param index the index of the class in the translation unit.
+  /// This is used to select the types of the data members and the
+  /// mutations applied to the class.
+  ///
+  /// @param shared if true, the class is repeated identically in all
+  /// translation units and is thus never mutated.
+  ///
+  /// @param base the base class of the new class, if any.
+  ///
+  /// @param member_type if non-nil, the type of the first data
+  /// member of the class.
+  ///
+  /// @return the new class.
+  class_decl_sptr
+  build_class(const string& name, unsigned index, bool shared,
+	      class_decl_sptr base, type_base_sptr member_type)
+  {
+    unsigned num_members = opts_.num_members;
+    bool add_member =
+      !shared && is_mutated(MUTATION_ADD_MEMBER, index);
+    bool change_member_type =
+      !shared && is_mutated(MUTATION_CHANGE_MEMBER_TYPE, index);
+    bool add_virtual =
+      !shared && is_mutated(MUTATION_ADD_VIRTUAL, index);
+    if (add_member)
+      ++num_members;
+
+    size_t offset = base ? base->get_size_in_bits() : 0;
+    class_decl_sptr klass(new class_decl(name, 0, 64, /*is_struct=*/false,
+					 new_location(shared),
+					 decl_base::VISIBILITY_DEFAULT));
+    add_decl_to_scope(klass, ns_.get());
+    ++num_classes_;
+    ++num_types_;
+
+    if (base)
+      {
+	class_decl::base_spec_sptr b(new class_decl::base_spec(base,
+							       public_access,
+							       0));
+	klass->add_base_specifier(b);
+      }
+
+    for (unsigned i = 0; i < num_members; ++i)
+      {
+	type_base_sptr t;
+	if (i == 0 && member_type)
+	  t = member_type;
+	else
+	  switch ((index + i) % 5)
+	    {
+	    case 0:
+	      t = int_type_;
+	      break;
+	    case 1:
+	      t = long_type_;
+	      break;
+	    case 2:
+	      t = char_type_;
+	      break;
+	    case 3:
+	      t = double_type_;
+	      break;
+	    case 4:
+	      t = class_ptrs_.empty()
+		? type_base_sptr(int_type_)
+		: class_ptrs_[(index + i) % class_ptrs_.size()];
+	      break;
+	    }
+	if (change_member_type && i == 1)
+	  t = char_type_;
+
+	ostringstream n;
+	n << "m" << i;
+	var_decl_sptr dm(new var_decl(n.str(), t, new_location(shared), ""));
+	klass->add_data_member(dm, public_access, /*is_laid_out=*/true,
+			       /*is_static=*/false, offset);
+	offset += t->get_size_in_bits() < 64 ? 64 : t->get_size_in_bits();
+      }
+    klass->set_size_in_bits(offset);
+
+    unsigned num_methods = opts_.num_methods + (add_virtual ? 1 : 0);
+    for (unsigned i = 0; i < num_methods; ++i)
+      {
+	bool is_virtual = (i % 2) || (add_virtual && i + 1 == num_methods);
+	ostringstream n, mangled;
+	n << "method" << i;
+	// The methods of a shared class must have the same mangled
+	// name in all the translation units, for the class to be
+	// identical in all of them.
+	if (shared)
+	  mangled << "_synth_" << name << "_method" << i;
+	else
+	  mangled << "_synth_method" << tu_index_ << "_"
+		  << num_classes_ << "_" << i;
+
+	vector<function_decl::parameter_sptr> parms;
+	method_type_sptr type(new method_type(int_type_, klass, parms,
+					      64, 64));
+	tu_->bind_function_type_life_time(type);
+
+	class_decl::method_decl_sptr m
+	  (new class_decl::method_decl(n.str(), type,
+				       /*declared_inline=*/false,
+				       new_location(shared),
+				       mangled.str()));
+	klass->add_member_function(m, public_access, is_virtual,
+				   /*vtable_offset=*/is_virtual ? i : 0,
+				   /*is_static=*/false, /*is_ctor=*/false,
+				   /*is_dtor=*/false, /*is_const=*/false);
+	if (!shared)
+	  export_function(m.get(), mangled.str());
+	++num_decls_;
+      }
+
+    return klass;
+  }
+
+  /// Build a chain of nested template instantiations, e.g
+  /// synth_tmpl1<synth_tmpl0<C> >.
+  ///
+  /// @param inner the innermost template argument.
+  ///
+  /// @return the outermost instantiation.
+  class_decl_sptr
+  build_template_instantiations(class_decl_sptr inner, unsigned index)
+  {
+    class_decl_sptr result = inner;
+    string arg = inner->get_name();
+    for (unsigned d = 0; d < opts_.template_depth; ++d)
+      {
+	ostringstream n;
+	n << "synth_tmpl" << d << "<" << arg
+	  << (arg[arg.size() - 1] == '>' ? " >" : ">");
+	arg = n.str();
+	result = build_class(arg, index + d, /*shared=*/false,
+			     class_decl_sptr(), result);
+      }
+    return result;
+  }
+
+  /// Give an ELF symbol to a given function and add it to the set of
+  /// exported functions of the corpus.
+  void
+  export_function(function_decl* fn, const string& sym_name)
+  {
+    elf_symbol_sptr sym(new elf_symbol(0, sym_name,
+				       elf_symbol::FUNC_TYPE,
+				       elf_symbol::GLOBAL_BINDING,
+				       /*is_defined=*/true,
+				       elf_symbol::version()));
+    (*fn_syms_)[sym_name].push_back(sym);
+    fn->set_symbol(sym);
+    fn->set_is_in_public_symbol_table(true);
+    corpus_->get_exported_decls_builder()->maybe_add_fn_to_exported_fns(fn);
+  }
+
+  /// Give an ELF symbol to a given variable and add it to the set of
+  /// exported variables of the corpus.
+  void
+  export_variable(var_decl* var, const string& sym_name)
+  {
+    elf_symbol_sptr sym(new elf_symbol(0, sym_name,
+				       elf_symbol::OBJECT_TYPE,
+				       elf_symbol::GLOBAL_BINDING,
+				       /*is_defined=*/true,
+				       elf_symbol::version()));
+    (*var_syms_)[sym_name].push_back(sym);
+    var->set_symbol(sym);
+    var->set_is_in_public_symbol_table(true);
+    corpus_->get_exported_decls_builder()->maybe_add_var_to_exported_vars(var);
+  }
+
+  /// Build an exported function which parameters are pointers to
+  /// classes of the current translation unit.
+  void
+  build_function(const string& name, unsigned index)
+  {
+    size_t nb_classes = class_ptrs_.size();
+    function_decl::parameters parms;
+    for (unsigned i = 0; i < 1 + index % 3; ++i)
+      {
+	type_base_sptr t = nb_classes
+	  ? class_ptrs_[(index * 7 + i) % nb_classes]
+	  : type_base_sptr(int_type_);
+	if (i == 0 && is_mutated(MUTATION_CHANGE_PARM_TYPE, index))
+	  t = long_type_;
+	ostringstream n;
+	n << "p" << i;
+	parms.push_back(function_decl::parameter_sptr
+			(new function_decl::parameter(t, i, n.str(),
+						      new_location(false))));
+      }
+
+    type_base_sptr return_type = nb_classes
+      ? class_ptrs_[index % nb_classes]
+      : type_base_sptr(int_type_);
+    function_type_sptr type(new function_type(return_type, parms, 64, 64));
+    tu_->bind_function_type_life_time(type);
+
+    function_decl_sptr fn(new function_decl(name, type,
+					    /*declared_inline=*/false,
+					    new_location(false), name,
+					    decl_base::VISIBILITY_DEFAULT,
+					    decl_base::BINDING_GLOBAL));
+    add_decl_to_scope(fn, tu_->get_global_scope().get());
+    export_function(fn.get(), name);
+    ++num_decls_;
+  }
+
+  /// Build an exported variable which type is a class of the current
+  /// translation unit.
+  void
+  build_variable(const string& name, unsigned index)
+  {
+    type_base_sptr t = classes_.empty()
+      ? type_base_sptr(int_type_)
+      : type_base_sptr(classes_[index % classes_.size()]);
+    var_decl_sptr var(new var_decl(name, t, new_location(false), name,
+				   decl_base::VISIBILITY_DEFAULT,
+				   decl_base::BINDING_GLOBAL));
+    add_decl_to_scope(var, tu_->get_global_scope().get());
+    export_variable(var.get(), name);
+    ++num_decls_;
+  }
+
+  /// Build the translation unit which index is @p index and add it to
+  /// the corpus.
+  void
+  build_translation_unit(unsigned index)
+  {
+    tu_index_ = index;
+    num_classes_ = 0;
+    line_ = 0;
+    classes_.clear();
+    class_ptrs_.clear();
+
+    ostringstream path;
+    path << "/usr/src/synthetic/tu" << index << ".cc";
+    tu_.reset(new translation_unit(path.str(), 64));
+    corpus_->add(tu_);
+
+    int_type_ = build_basic_type("int", 32);
+    long_type_ = build_basic_type("long int", 64);
+    char_type_ = build_basic_type("char", 8);
+    double_type_ = build_basic_type("double", 64);
+
+    ns_.reset(new namespace_decl("synth", location()));
+    add_decl_to_scope(ns_, tu_->get_global_scope().get());
+
+    // The classes that are repeated in every translation unit.
+    for (unsigned i = 0; i < opts_.num_shared_classes; ++i)
+      {
+	ostringstream n;
+	n << "shared" << i;
+	class_decl_sptr base;
+	if (opts_.inheritance_depth > 1
+	    && i % opts_.inheritance_depth
+	    && !classes_.empty())
+	  base = classes_.back();
+	classes_.push_back(build_class(n.str(), i, /*shared=*/true,
+				       base, type_base_sptr()));
+	class_ptrs_.push_back(build_pointer_type(classes_.back()));
+      }
+
+    // The classes that are specific to this translation unit.
+    for (unsigned i = 0; i < opts_.num_classes; ++i)
+      {
+	ostringstream n;
+	n << "C" << index << "_" << i;
+	class_decl_sptr base;
+	if (opts_.inheritance_depth > 1
+	    && i % opts_.inheritance_depth
+	    && i > 0)
+	  base = classes_.back();
+	class_decl_sptr c = build_class(n.str(), i, /*shared=*/false,
+					base, type_base_sptr());
+	if (opts_.template_depth && i % 10 == 0)
+	  c = build_template_instantiations(c, i);
+	classes_.push_back(c);
+	class_ptrs_.push_back(build_pointer_type(c));
+      }
+
+    for (unsigned i = 0; i < opts_.num_functions; ++i)
+      {
+	if (is_mutated(MUTATION_REMOVE_FUNCTION, i))
+	  continue;
+	ostringstream n;
+	n << "synth_fn" << index << "_" << i;
+	build_function(n.str(), i);
+	if (is_mutated(MUTATION_ADD_FUNCTION, i))
+	  {
+	    n << "_added";
+	    build_function(n.str(), i);
+	  }
+      }
+
+    for (unsigned i = 0; i < opts_.num_variables; ++i)
+      {
+	if (is_mutated(MUTATION_REMOVE_VARIABLE, i))
+	  continue;
+	ostringstream n;
+	n << "synth_var" << index << "_" << i;
+	build_variable(n.str(), i);
+      }
+
+    tu_->set_is_constructed(true);
+  }
+
+  /// Build the whole corpus.
+  ///
+  /// @return the resulting corpus.
+  corpus_sptr
+  build()
+  {
+    corpus_->set_origin(corpus::ARTIFICIAL_ORIGIN);
+    corpus_->set_soname("libsynthetic.so.1");
+    corpus_->set_fun_symbol_map(fn_syms_);
+    corpus_->set_var_symbol_map(var_syms_);
+    for (unsigned i = 0; i < opts_.num_tus; ++i)
+      build_translation_unit(i);
+    return corpus_;
+  }
+
+  /// @return the number of types built.
+  unsigned long
+  num_types() const
+  {return num_types_;}
+
+  /// @return the number of functions and variables built.
+  unsigned long
+  num_decls() const
+  {return num_decls_;}
+};// end class corpus_builder
+
+int
+main(int argc, char* argv[])
+{
+  options opts;
+  if (!parse_command_line(argc, argv, opts))
+    {
+      display_usage(argv[0], cerr);
+      return 1;
+    }
+
+  if (opts.display_usage)
+    {
+      display_usage(argv[0], cout);
+      return 0;
+    }
+
+  corpus_builder builder(opts);
+  corpus_sptr corp = builder.build();
+
+  bool ok = false;
+  if (opts.out_file_path.empty())
+    ok = abigail::xml_writer::write_corpus_to_native_xml(corp, 0, cout);
+  else
+    ok = abigail::xml_writer::write_corpus_to_native_xml_file
+      (corp, 0, opts.out_file_path);
+
+  if (!ok)
+    {
+      cerr << "could not write the corpus\n";
+      return 1;
+    }
+
+  return 0;
+}
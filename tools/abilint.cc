@@ -24,14 +24,15 @@
 ///
 /// This is a program aimed at checking that a binary instrumentation
 /// (bi) file is well formed and valid enough.  It acts by loading an
-/// input bi file and saving it back to a temporary file.  It then
-/// runs a diff on the two files and expects the result of the diff to
-/// be empty.
+/// input bi file and saving it back in memory, while comparing the
+/// result against the input file.  It expects both to be the same.
 
 #include <cstring>
 #include <cstdio>
 #include <cstdlib>
+#include <unistd.h>
 #include <string>
+#include <vector>
 #include <iostream>
 #include <fstream>
 #include "abg-tools-utils.h"
@@ -46,10 +47,14 @@ using std::cerr;
 using std::cin;
 using std::cout;
 using std::ostream;
-using std::ofstream;
+using std::ifstream;
+using std::vector;
+using std::tr1::shared_ptr;
 using abigail::tools_utils::check_file;
+using abigail::tools_utils::file_comparing_streambuf;
 using abigail::tools_utils::file_type;
 using abigail::tools_utils::guess_file_type;
+using abigail::tools_utils::get_temporary_directory;
 using abigail::corpus;
 using abigail::corpus_sptr;
 using abigail::xml_reader::read_translation_unit_from_file;
@@ -70,6 +75,7 @@ struct options
   bool				diff;
   bool				bidiff;
   bool				noout;
+  bool				prune_unreachable_types;
   std::tr1::shared_ptr<char>	di_root_path;
 
   options()
@@ -77,7 +83,8 @@ struct options
       read_tu(false),
       diff(false),
       bidiff(false),
-      noout(false)
+      noout(false),
+      prune_unreachable_types(false)
   {}
 };//end struct options;
 
@@ -89,11 +96,13 @@ display_usage(const string& prog_name, ostream& out)
       << "  --help  display this message\n"
       << "  --debug-info-dir <path> the path under which to look for "
            "debug info for the elf <abi-file>\n"
-      << "  --diff  for xml inputs, perform a text diff between "
-         "the input and the memory model saved back to disk\n"
+      << "  --diff  for xml inputs, compare the input with "
+         "the memory model saved back, and show the first difference\n"
       << "  --bidiff perform an abi diff between the input "
          "and the memory model(not yet implemented)\n"
       << "  --noout  do not display anything on stdout\n"
+      << "  --prune-unreachable-types  drop the types that are not "
+         "reachable from the exported declarations of the corpus\n"
       << "  --stdin|--  read abi-file content from stdin\n"
       << "  --tu  expect a single translation unit file\n";
 }
@@ -139,6 +148,8 @@ parse_command_line(int argc, char* argv[], options& opts)
 	  opts.bidiff = true;
 	else if (!strcmp(argv[i], "--noout"))
 	  opts.noout = true;
+	else if (!strcmp(argv[i], "--prune-unreachable-types"))
+	  opts.prune_unreachable_types = true;
 	else
 	  return false;
       }
@@ -148,8 +159,8 @@ parse_command_line(int argc, char* argv[], options& opts)
     return true;
 }
 
-/// Reads a bi (binary instrumentation) file, saves it back to a
-/// temporary file and run a diff on the two versions.
+/// Reads a bi (binary instrumentation) file, saves it back and
+/// compares the two versions.
 int
 main(int argc, char* argv[])
 {
@@ -183,6 +194,8 @@ main(int argc, char* argv[])
       else
 	{
 	  corpus_sptr corp = read_corpus_from_native_xml(&cin);
+	  if (corp && opts.prune_unreachable_types)
+	    corp->prune_unreachable_types();
 	  if (!opts.noout)
 	    write_corpus_to_native_xml(corp, /*indent=*/0, cout);
 	  return false;
@@ -250,17 +263,23 @@ main(int argc, char* argv[])
 	  return true;
 	}
 
-      char tmpn[L_tmpnam];
-      tmpnam(tmpn);
+      if (corp && opts.prune_unreachable_types)
+	corp->prune_unreachable_types();
 
-      string ofile_name = tmpn;
-
-      ofstream of(ofile_name.c_str(), std::ios_base::trunc);
-      if (!of.is_open())
+      // When --diff is given, the corpus or translation unit that was
+      // read is serialized into this stream, which compares it
+      // against the content of the input file on the fly.
+      shared_ptr<file_comparing_streambuf> comparator;
+      if (opts.diff)
 	{
-	  cerr << "open temporary output file " << ofile_name << "\n";
-	  return true;
+	  comparator.reset(new file_comparing_streambuf(opts.file_path));
+	  if (!comparator->is_open())
+	    {
+	      cerr << "could not open " << opts.file_path << "\n";
+	      return true;
+	    }
 	}
+      ostream of(comparator.get());
 
       bool r = true;
 
@@ -285,10 +304,30 @@ main(int argc, char* argv[])
 	  else if (type == abigail::tools_utils::FILE_TYPE_ZIP_CORPUS)
 	    {
 #ifdef WITH_ZIP_ARCHIVE
-	      if (!opts.noout)
-		r = write_corpus_to_archive(*corp, ofile_name);
+	      if (opts.diff)
+		{
+		  // An archive can only be written to a file, so
+		  // compare the content of that file.
+		  string tmp_path =
+		    get_temporary_directory() + "/abilint-XXXXXX";
+		  vector<char> tmpn(tmp_path.begin(), tmp_path.end());
+		  tmpn.push_back(0);
+		  int fd = mkstemp(&tmpn[0]);
+		  if (fd < 0)
+		    r = false;
+		  else
+		    {
+		      close(fd);
+		      r = write_corpus_to_archive(*corp, &tmpn[0]);
+		      ifstream in(&tmpn[0], std::ios_base::binary);
+		      if (r && in.is_open())
+			of << in.rdbuf();
+		      else
+			r = false;
+		      remove(&tmpn[0]);
+		    }
+		}
 #endif //WITH_ZIP_ARCHIVE
-	      of.close();
 	    }
 	  else if (type == abigail::tools_utils::FILE_TYPE_ELF)
 	    {
@@ -298,7 +337,6 @@ main(int argc, char* argv[])
 	}
 
       bool is_ok = r;
-      of.close();
 
       if (!is_ok)
 	{
@@ -314,13 +352,18 @@ main(int argc, char* argv[])
 	  && opts.diff
 	  && ((type == abigail::tools_utils::FILE_TYPE_XML_CORPUS)
 	      || type == abigail::tools_utils::FILE_TYPE_NATIVE_BI
-	      || type == abigail::tools_utils::FILE_TYPE_ZIP_CORPUS))
+	      || type == abigail::tools_utils::FILE_TYPE_ZIP_CORPUS)
+	  && !comparator->finish())
 	{
-	  string cmd = "diff -u " + opts.file_path + " " + ofile_name;
-	  if (system(cmd.c_str()))
-	    is_ok = false;
+	  cerr << opts.file_path << ":"
+	       << comparator->get_line_of_first_difference()
+	       << ": the input differs from what is saved back:\n"
+	       << "-" << comparator->get_expected_line() << "\n"
+	       << "+" << comparator->get_actual_line() << "\n";
+	  if (comparator->get_expected_line() == comparator->get_actual_line())
+	    cerr << "(only the end of line differs)\n";
+	  is_ok = false;
 	}
-      remove(ofile_name.c_str());
       return !is_ok;
     }
 